@@ -1,5 +1,6 @@
 import { toString, IllegalConstructor } from '../util.js'
 import process from '../process.js'
+import ipc from '../ipc.js'
 
 /**
  * Used to preallocate a minimum sized array of subscribers for
@@ -613,4 +614,38 @@ Object.assign(Object.getPrototypeOf(registry), {
   constructor: IllegalConstructor
 })
 
+/**
+ * Interval in milliseconds at which core event loop metrics are published to
+ * the `diagnostics.loop` channel. Metrics are only requested from the
+ * runtime while the channel has subscribers.
+ * @ignore
+ */
+export const LOOP_METRICS_INTERVAL = 1000
+
+// held strongly so subscribers survive the registry's `WeakRef`
+const loopChannel = registry.channel('diagnostics.loop')
+let isPublishingLoopMetrics = false
+
+async function publishLoopMetrics () {
+  if (!loopChannel.hasSubscribers || isPublishingLoopMetrics) {
+    return
+  }
+
+  isPublishingLoopMetrics = true
+
+  try {
+    const result = await ipc.send('diagnostics.loop')
+    if (result.data && loopChannel.hasSubscribers) {
+      await loopChannel.publish(result.data)
+    }
+  } finally {
+    isPublishingLoopMetrics = false
+  }
+}
+
+if (typeof globalThis.setInterval === 'function') {
+  const interval = globalThis.setInterval(publishLoopMetrics, LOOP_METRICS_INTERVAL)
+  process.once('exit', () => globalThis.clearInterval(interval))
+}
+
 export default registry
@@ -103,7 +103,9 @@ export class Dir {
   }
 
   /**
-   * Reads and returns directory entry.
+   * Reads and returns directory entry. With `options.withStats`, entries are
+   * read with their stats in the same request and `Dirent` instances have a
+   * `stats` property.
    * @param {object|function} options
    * @param {function=} callback
    * @return {Dirent|string}
@@ -117,7 +119,9 @@ export class Dir {
     let results = []
 
     try {
-      results = await this.handle?.read(options)
+      results = options?.withStats
+        ? await this.handle?.readPlus(options)
+        : await this.handle?.read(options)
     } catch (err) {
       if (typeof callback === 'function') {
         callback(err)
@@ -216,7 +220,7 @@ export class Dirent {
    */
   static from (name, type) {
     if (typeof name === 'object') {
-      return new this(name?.name, name?.type)
+      return new this(name?.name, name?.type, name?.stats)
     }
 
     return new this(name, type ?? Dirent.UNKNOWN)
@@ -226,10 +230,16 @@ export class Dirent {
    * `Dirent` class constructor.
    * @param {string} name
    * @param {string|number} type
+   * @param {import('./stats.js').Stats=} [stats]
    */
-  constructor (name, type) {
+  constructor (name, type, stats) {
     this.name = name ?? null
     this[kType] = parseInt(type ?? Dirent.UNKNOWN)
+
+    // only set for entries read with `withStats`
+    if (stats) {
+      this.stats = stats
+    }
   }
 
   /**
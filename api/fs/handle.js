@@ -19,7 +19,7 @@ import { Stats } from './stats.js'
 import { F_OK } from './constants.js'
 import console from '../console.js'
 import fds from './fds.js'
-import ipc from '../ipc.js'
+import ipc, { primordials } from '../ipc.js'
 import gc from '../gc.js'
 
 import * as exports from './handle.js'
@@ -36,10 +36,23 @@ const dc = diagnostics.channels.group('fs', [
   'handle.close'
 ])
 
+// chunked `fs.stream` responses are only supported by the scheme handlers
+// on Apple platforms, elsewhere `readableWebStream()` reads with `read()`
+const isChunkedStreamSupported = /^(darwin|ios)$/i.test(primordials.platform)
+
 export const kOpening = Symbol.for('fs.FileHandle.opening')
 export const kClosing = Symbol.for('fs.FileHandle.closing')
 export const kClosed = Symbol.for('fs.FileHandle.closed')
 
+// a `Buffer` sharing memory with `buffer`, so reads land in the caller's buffer
+function toBufferView (buffer) {
+  if (buffer instanceof ArrayBuffer) {
+    return Buffer.from(buffer)
+  }
+
+  return Buffer.from(buffer.buffer, buffer.byteOffset, buffer.byteLength)
+}
+
 /**
  * A container for a descriptor tracked in `fds` and opened in the native layer.
  * This class implements the Node.js `FileHandle` interface
@@ -357,10 +370,20 @@ export class FileHandle extends EventEmitter {
   /**
    * @param {object=} [options]
    */
-  async datasync () {
+  async datasync (options) {
     if (this.closing || this.closed) {
       throw new Error('FileHandle is not opened')
     }
+
+    const result = await ipc.request('fs.fsync', {
+      ...options,
+      id: this.id,
+      datasync: true
+    })
+
+    if (result.err) {
+      throw result.err
+    }
   }
 
   /**
@@ -538,6 +561,99 @@ export class FileHandle extends EventEmitter {
     return { bytesRead, buffer }
   }
 
+  /**
+   * Returns a `ReadableStream` of the bytes of the file from `options.start`
+   * to `options.end` (exclusive). Where chunked responses are supported the
+   * file is streamed natively in a single `fs.stream` request, with up to
+   * `options.window` reads of `options.highWaterMark` bytes in flight ahead
+   * of the consumer. Elsewhere the stream reads with `read()`.
+   * @param {object=} [options]
+   * @param {number=} [options.start = 0]
+   * @param {number=} [options.end = Infinity]
+   * @param {number=} [options.highWaterMark = 65536]
+   * @param {number=} [options.window] - Defaults to `[core] fs_stream_window`
+   * @param {number=} [options.timeout] - For each `read()` where chunked responses are not supported
+   * @param {AbortSignal=} [options.signal]
+   * @return {ReadableStream<Uint8Array>}
+   */
+  readableWebStream (options) {
+    if (this.closing || this.closed) {
+      throw new Error('FileHandle is not opened')
+    }
+
+    const handle = this
+    const signal = options?.signal ?? null
+    const timeout = options?.timeout ?? null
+    const start = Math.max(0, options?.start ?? 0)
+    const end = Number.isFinite(options?.end) ? Math.max(start, options.end) : Infinity
+    const highWaterMark = options?.highWaterMark ?? ReadStream.highWaterMark
+
+    // `null` until the first pull, `false` when reading with `read()`
+    let reader = isChunkedStreamSupported ? null : false
+    let position = start
+    let expected = Infinity
+
+    return new globalThis.ReadableStream({
+      async pull (controller) {
+        if (reader === null) {
+          const result = await ipc.stream('fs.stream', {
+            id: handle.id,
+            offset: start,
+            end: end === Infinity ? -1 : end,
+            highWaterMark,
+            window: options?.window ?? 0
+          }, { signal })
+
+          if (result.err || !result.data?.getReader) {
+            reader = false
+          } else {
+            reader = result.data.getReader()
+            expected = start + Number(result.headers?.get('x-fs-stream-length') ?? Infinity)
+          }
+        }
+
+        if (reader === false) {
+          const length = Math.min(highWaterMark, end - position)
+          const { bytesRead, buffer } = length > 0
+            ? await handle.read(new ArrayBuffer(length), 0, length, position, { signal, timeout })
+            : { bytesRead: 0 }
+
+          if (bytesRead > 0) {
+            position += bytesRead
+            controller.enqueue(new Uint8Array(buffer, 0, bytesRead))
+          } else {
+            controller.close()
+          }
+
+          return
+        }
+
+        const { done, value } = await reader.read()
+
+        if (!done) {
+          position += value.byteLength
+          dc.channel('handle.read').publish({ handle, bytesRead: value.byteLength })
+          return controller.enqueue(value)
+        }
+
+        // the response ends early when a read fails
+        if (Number.isFinite(expected) && position < expected) {
+          controller.error(new Error(
+            `'fs.stream' ended after ${position - start} of ${expected - start} bytes`
+          ))
+        } else {
+          controller.close()
+        }
+      },
+
+      async cancel (reason) {
+        if (reader) {
+          await reader.cancel(reason)
+        }
+      }
+    })
+  }
+
   /**
    * Reads the entire contents of a file and returns it as a buffer or a string
    * specified of a given encoding specified at `options.encoding`.
@@ -583,12 +699,69 @@ export class FileHandle extends EventEmitter {
   }
 
   /**
+   * Reads into each buffer in `buffers`, in order, starting from `position`
+   * with a single vectored read.
+   * @param {Array<Buffer|TypedArray|ArrayBuffer>} buffers
+   * @param {number?} [position] - reads from the current position if `null`
    * @param {object=} [options]
+   * @return {Promise<{ bytesRead: number, buffers: Array<Buffer|TypedArray|ArrayBuffer> }>}
    */
-  async readv (buffers, position) {
+  async readv (buffers, position, options) {
     if (this.closing || this.closed) {
       throw new Error('FileHandle is not opened')
     }
+
+    const signal = options?.signal || null
+    const timeout = options?.timeout || null
+
+    if (signal?.aborted) {
+      throw new AbortError(signal)
+    }
+
+    if (!Array.isArray(buffers) || !buffers.every(isBufferLike)) {
+      throw new TypeError('Expecting buffers to be an array of Buffer or TypedArray.')
+    }
+
+    if (typeof position !== 'number') {
+      position = -1
+    }
+
+    const views = buffers.map(toBufferView)
+    const sizes = views.map((view) => view.byteLength)
+
+    if (sizes.every((size) => size === 0)) {
+      return { bytesRead: 0, buffers }
+    }
+
+    const result = await ipc.request('fs.readv', {
+      id: this.id,
+      sizes: sizes.join(','),
+      offset: position
+    }, { signal, timeout, responseType: 'arraybuffer' })
+
+    if (result.err) {
+      throw result.err
+    }
+
+    let bytesRead = 0
+
+    if (isTypedArray(result.data) || result.data instanceof ArrayBuffer) {
+      const data = Buffer.from(result.data)
+      bytesRead = data.byteLength
+
+      // segments are back to back in the response body
+      for (let i = 0, offset = 0; i < views.length && offset < bytesRead; ++i) {
+        offset += data.copy(views[i], 0, offset, Math.min(offset + sizes[i], bytesRead))
+      }
+
+      dc.channel('handle.read').publish({ handle: this, bytesRead })
+    } else if (!isEmptyObject(result.data)) {
+      throw new TypeError(
+        `Invalid response buffer from 'fs.readv' Received: ${typeof result.data}`
+      )
+    }
+
+    return { bytesRead, buffers }
   }
 
   /**
@@ -614,10 +787,16 @@ export class FileHandle extends EventEmitter {
   /**
    * @param {object=} [options]
    */
-  async sync () {
+  async sync (options) {
     if (this.closing || this.closed) {
       throw new Error('FileHandle is not opened')
     }
+
+    const result = await ipc.request('fs.fsync', { ...options, id: this.id })
+
+    if (result.err) {
+      throw result.err
+    }
   }
 
   /**
@@ -771,9 +950,67 @@ export class FileHandle extends EventEmitter {
   }
 
   /**
+   * Writes each buffer in `buffers`, in order, starting at `position` with
+   * a single vectored write.
+   * @param {Array<Buffer|TypedArray|ArrayBuffer|string>} buffers
+   * @param {number?} [position] - writes at the current position if `null`
    * @param {object=} [options]
+   * @return {Promise<{ bytesWritten: number, buffers: Array<Buffer|TypedArray|ArrayBuffer|string> }>}
    */
-  async writev (buffers, position) {
+  async writev (buffers, position, options) {
+    if (this.closing || this.closed) {
+      throw new Error('FileHandle is not opened')
+    }
+
+    const signal = options?.signal || null
+    const timeout = options?.timeout || null
+
+    if (signal?.aborted) {
+      throw new AbortError(signal)
+    }
+
+    if (
+      !Array.isArray(buffers) ||
+      !buffers.every((buffer) => typeof buffer === 'string' || isBufferLike(buffer))
+    ) {
+      throw new TypeError('Expecting buffers to be an array of strings or Buffer.')
+    }
+
+    if (typeof position !== 'number') {
+      position = -1
+    }
+
+    const views = buffers.map((buffer) => typeof buffer === 'string'
+      ? Buffer.from(buffer)
+      : toBufferView(buffer)
+    )
+
+    const buffer = Buffer.concat(views)
+
+    if (!buffer.length) {
+      return { bytesWritten: 0, buffers }
+    }
+
+    const params = {
+      id: this.id,
+      sizes: views.map((view) => view.byteLength).join(','),
+      offset: position
+    }
+
+    const result = await ipc.write('fs.writev', params, buffer, {
+      timeout,
+      signal
+    })
+
+    if (result.err) {
+      throw result.err
+    }
+
+    const bytesWritten = parseInt(result.data.result) || 0
+
+    dc.channel('handle.write').publish({ handle: this, bytesWritten })
+
+    return { bytesWritten, buffers }
   }
 }
 
@@ -789,6 +1026,11 @@ export class DirectoryHandle extends EventEmitter {
   static get MAX_BUFFER_SIZE () { return 256 }
   static get MAX_ENTRIES () { return this.MAX_BUFFER_SIZE }
 
+  /**
+   * The max number of entries that can be read with `readPlus()`.
+   */
+  static get MAX_PLUS_ENTRIES () { return 8192 }
+
   /**
    * The default number of entries `Dirent` that are buffered
    * for each read request.
@@ -1040,6 +1282,138 @@ export class DirectoryHandle extends EventEmitter {
 
     return result.data
   }
+
+  /**
+   * Reads the next `entries` directory entries along with their stats in a
+   * single request. Each entry is a `{ name, type, stats }` object where
+   * `stats` is `null` if the entry could not be stat'ed. The `binary`
+   * encoding packs entries in an `ArrayBuffer`, which is cheaper to produce
+   * and decode for large directories.
+   * @param {{ entries?: number, encoding?: 'json'|'binary', bigint?: boolean }=} [options]
+   * @return {Promise<{ name: string, type: number, stats: Stats|null }[]>}
+   */
+  async readPlus (options) {
+    if (this[kOpening]) {
+      await this[kOpening]
+    }
+
+    if (this.closing || this.closed) {
+      throw new Error('DirectoryHandle is not opened')
+    }
+
+    if (options?.signal?.aborted) {
+      throw new AbortError(options.signal)
+    }
+
+    const entries = clamp(
+      options?.entries ?? DirectoryHandle.MAX_ENTRIES,
+      1,
+      DirectoryHandle.MAX_PLUS_ENTRIES
+    )
+
+    const encoding = options?.encoding === 'binary' ? 'binary' : 'json'
+    const bigint = Boolean(options?.bigint)
+    const { id } = this
+
+    const result = await ipc.request('fs.readdirPlus', {
+      id,
+      entries,
+      encoding
+    }, {
+      signal: options?.signal,
+      timeout: options?.timeout,
+      responseType: encoding === 'binary' ? 'arraybuffer' : undefined
+    })
+
+    if (result.err) {
+      throw result.err
+    }
+
+    if (encoding === 'json') {
+      return result.data.map((entry) => ({
+        name: entry.name,
+        type: entry.type,
+        stats: entry.stats ? Stats.from(entry.stats, bigint) : null
+      }))
+    }
+
+    // an empty response from mac returns an empty object sometimes
+    if (isEmptyObject(result.data)) {
+      return []
+    }
+
+    return decodeReaddirPlus(result.data).map((entry) => ({
+      name: entry.name,
+      type: entry.type,
+      stats: entry.stats ? Stats.from(entry.stats, bigint) : null
+    }))
+  }
+}
+
+const READDIR_PLUS_STAT_FIELDS = [
+  'st_dev',
+  'st_mode',
+  'st_nlink',
+  'st_uid',
+  'st_gid',
+  'st_rdev',
+  'st_ino',
+  'st_size',
+  'st_blksize',
+  'st_blocks',
+  'st_flags',
+  'st_gen'
+]
+
+const READDIR_PLUS_TIME_FIELDS = ['st_atim', 'st_mtim', 'st_ctim', 'st_birthtim']
+
+/**
+ * Decodes the packed entries of a binary 'fs.readdirPlus' response, see
+ * `Core::FS::readdirPlus()` for the layout.
+ * @ignore
+ * @param {ArrayBuffer|Uint8Array} data
+ * @return {object[]}
+ */
+function decodeReaddirPlus (data) {
+  const bytes = data instanceof ArrayBuffer ? new Uint8Array(data) : data
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength)
+  const decoder = new TextDecoder()
+  const entries = []
+  let offset = 0
+
+  while (offset < view.byteLength) {
+    const length = view.getUint16(offset, true)
+    const type = view.getUint8(offset + 2)
+    const ok = view.getUint8(offset + 3) === 1
+    const stats = ok ? {} : null
+    offset += 4
+
+    for (const field of READDIR_PLUS_STAT_FIELDS) {
+      if (stats) {
+        stats[field] = view.getBigUint64(offset, true)
+      }
+
+      offset += 8
+    }
+
+    for (const field of READDIR_PLUS_TIME_FIELDS) {
+      if (stats) {
+        stats[field] = {
+          tv_sec: view.getBigInt64(offset, true),
+          tv_nsec: view.getBigInt64(offset + 8, true)
+        }
+      }
+
+      offset += 16
+    }
+
+    const name = decoder.decode(bytes.subarray(offset, offset + length))
+    offset += length
+
+    entries.push({ name, type, stats })
+  }
+
+  return entries
 }
 
 export default exports
@@ -99,9 +99,34 @@ export function access (path, mode, callback) {
 }
 
 /**
- * @ignore
+ * @see {@link https://nodejs.org/dist/latest-v20.x/docs/api/fs.html#fsappendfilepath-data-options-callback}
+ * @param {string | Buffer | URL | number } path - filename or file descriptor
+ * @param {string | Buffer | TypedArray | DataView | object } data
+ * @param {object?} options
+ * @param {string?} [options.encoding ? 'utf8']
+ * @param {string?} [options.mode ? 0o666]
+ * @param {string?} [options.flag ? 'a']
+ * @param {AbortSignal?} [options.signal]
+ * @param {function(Error?)} callback
  */
 export function appendFile (path, data, options, callback) {
+  if (typeof options === 'function') {
+    callback = options
+    options = {}
+  }
+
+  if (typeof options === 'string') {
+    options = { encoding: options }
+  }
+
+  if (typeof callback !== 'function') {
+    throw new TypeError('callback must be a function.')
+  }
+
+  promises.appendFile(path, data, options).then(
+    () => callback(null),
+    (err) => callback(err)
+  )
 }
 
 /**
@@ -214,6 +239,31 @@ export function copyFile (src, dest, flags, callback) {
   }).catch(callback)
 }
 
+/**
+ * Asynchronously copies `src` to `dest`, with `options.recursive` a directory
+ * and everything in it, calling `callback` upon success or error.
+ * @see {@link https://nodejs.org/api/fs.html#fscpsrc-dest-options-callback}
+ * @param {string} src
+ * @param {string} dest
+ * @param {object?} [options] - See `fs.promises.cp()`
+ * @param {function(Error=)=} [callback]
+ */
+export function cp (src, dest, options, callback) {
+  if (typeof options === 'function') {
+    callback = options
+    options = {}
+  }
+
+  if (typeof callback !== 'function') {
+    throw new TypeError('callback must be a function.')
+  }
+
+  promises.cp(src, dest, options).then(
+    () => callback(null),
+    (err) => callback(err)
+  )
+}
+
 /**
  * @see {@link https://nodejs.org/dist/latest-v20.x/docs/api/fs.html#fscreatewritestreampath-options}
  * @param {string | Buffer | URL} path
@@ -330,6 +380,31 @@ export function fstat (fd, options, callback) {
   }
 }
 
+/**
+ * Hashes the contents of the file at `path`, or of each of an array of
+ * paths, natively and calls `callback` with the result.
+ * @see `fs.promises.hash()`
+ * @param {string|string[]} path
+ * @param {object?} [options]
+ * @param {'sha256'|'sha1'|'blake3'} [options.algorithm = 'sha256']
+ * @param {function(Error?, object?)} callback
+ */
+export function hash (path, options, callback) {
+  if (typeof options === 'function') {
+    callback = options
+    options = {}
+  }
+
+  if (typeof callback !== 'function') {
+    throw new TypeError('callback must be a function.')
+  }
+
+  promises.hash(path, options).then(
+    (result) => callback(null, result),
+    (err) => callback(err)
+  )
+}
+
 /**
  * Chages ownership of link at `path` with `uid` and `gid.
  * @param {string} path
@@ -604,23 +679,10 @@ export function readFile (path, options = {}, callback) {
     throw new TypeError('callback must be a function.')
   }
 
-  visit(path, options, async (err, handle) => {
-    let buffer = null
-
-    if (err) {
-      callback(err)
-      return
-    }
-
-    try {
-      buffer = await handle.readFile(options)
-    } catch (err) {
-      callback(err)
-      return
-    }
-
-    callback(null, buffer)
-  })
+  promises.readFile(path, options).then(
+    (buffer) => callback(null, buffer),
+    (err) => callback(err)
+  )
 }
 
 /**
@@ -685,6 +747,29 @@ export function rename (src, dest, callback) {
   })
 }
 
+/**
+ * Removes `path`, with `options.recursive` a directory and everything in it.
+ * @see {@link https://nodejs.org/api/fs.html#fsrmpath-options-callback}
+ * @param {string} path
+ * @param {object?} [options] - See `fs.promises.rm()`
+ * @param {function} callback
+ */
+export function rm (path, options, callback) {
+  if (typeof options === 'function') {
+    callback = options
+    options = {}
+  }
+
+  if (typeof callback !== 'function') {
+    throw new TypeError('callback must be a function.')
+  }
+
+  promises.rm(path, options).then(
+    () => callback(null),
+    (err) => callback(err)
+  )
+}
+
 /**
  * Removes directory at `path`.
  * @param {string} path
@@ -833,21 +918,10 @@ export function writeFile (path, data, options, callback) {
     throw new TypeError('callback must be a function.')
   }
 
-  visit(path, options, async (err, handle) => {
-    if (err) {
-      callback(err)
-      return
-    }
-
-    try {
-      await handle.writeFile(data, options)
-    } catch (err) {
-      callback(err)
-      return
-    }
-
-    callback(null)
-  })
+  promises.writeFile(path, data, options).then(
+    () => callback(null),
+    (err) => callback(err)
+  )
 }
 
 /**
@@ -22,7 +22,13 @@
  * import fs from 'socket:fs/promises'
  * ```
  */
+import { isEmptyObject, isTypedArray } from '../util.js'
+import { normalizeFlags } from './flags.js'
+import { AbortError } from '../errors.js'
+import { rand64 } from '../crypto.js'
+import { Buffer } from '../buffer.js'
 import console from '../console.js'
+import hooks from '../hooks.js'
 import ipc from '../ipc.js'
 
 import { Dir, Dirent, sortDirectoryEntries } from './dir.js'
@@ -165,6 +171,44 @@ export async function copyFile (src, dest, flags) {
   }
 }
 
+/**
+ * Hashes the contents of the file at `path` natively, off the main thread,
+ * so only the digest crosses the bridge. Given an array of paths, the files
+ * are hashed in parallel and an array of `{ path, digest, size }` or
+ * `{ path, err }` is returned, in the order of `path`.
+ * @param {string|string[]} path
+ * @param {object?} [options]
+ * @param {'sha256'|'sha1'|'blake3'} [options.algorithm = 'sha256']
+ * @return {Promise<{ algorithm: string, digest: string, size: number }|object[]>}
+ */
+export async function hash (path, options) {
+  const algorithm = options?.algorithm ?? 'sha256'
+  const paths = Array.isArray(path) ? path : null
+
+  if (paths && !paths.every((path) => typeof path === 'string' && !path.includes('\n'))) {
+    throw new TypeError('The argument \'path\' must be an array of paths')
+  } else if (!paths && typeof path !== 'string') {
+    throw new TypeError('The argument \'path\' must be a string')
+  }
+
+  const result = paths
+    ? await ipc.send('fs.hash', { paths: paths.join('\n'), algorithm })
+    : await ipc.send('fs.hash', { path, algorithm })
+
+  if (result.err) {
+    throw result.err
+  }
+
+  if (!paths) {
+    return result.data
+  }
+
+  return result.data.results.map((entry) => entry.err
+    ? { path: entry.path, err: ipc.Result.from({ err: entry.err }).err }
+    : entry
+  )
+}
+
 /**
  * Chages ownership of link at `path` with `uid` and `gid.
  * @param {string} path
@@ -214,6 +258,83 @@ export async function link (src, dest) {
   }
 }
 
+/**
+ * Calls `callback` with the progress events of the `fs.rm` or `fs.cp` for `id`.
+ * @ignore
+ * @param {string} source
+ * @param {string} id
+ * @param {function?} callback
+ * @return {function} - Stops listening
+ */
+function onTreeProgress (source, id, callback) {
+  if (typeof callback !== 'function') {
+    return () => {}
+  }
+
+  return hooks.onData((event) => {
+    const { data } = event.detail.params
+    if (event.detail.params.source === source && String(data?.id) === id) {
+      callback({
+        entries: data.entries,
+        bytes: data.bytes,
+        errors: data.errors ?? []
+      })
+    }
+  })
+}
+
+/**
+ * Copies `src` to `dest`, with `options.recursive` a directory and everything
+ * in it. Files are cloned (copy-on-write) where the file system supports it.
+ * The copy runs natively off the main thread, `options.onProgress` is called
+ * with `{ entries, bytes, errors }` for batches of copied entries, where
+ * `errors` lists the entries (`{ path, code, message }`) that failed since
+ * the last call. Entries that fail don't stop the copy, the returned promise
+ * rejects with the first error once it is done.
+ * @see {@link https://nodejs.org/api/fs.html#fspromisescpsrc-dest-options}
+ * @param {string} src
+ * @param {string} dest
+ * @param {object?} [options]
+ * @param {boolean} [options.recursive = false]
+ * @param {boolean} [options.force = true] - Overwrite existing files
+ * @param {boolean} [options.errorOnExist = false] - Fail on existing files when `force` is `false`
+ * @param {boolean} [options.dereference = false] - Copy the targets of symbolic links
+ * @param {function?} [options.onProgress]
+ * @return {Promise<{ entries: number, bytes: number }>}
+ */
+export async function cp (src, dest, options) {
+  if (typeof src !== 'string') {
+    throw new TypeError('The argument \'src\' must be a string')
+  }
+
+  if (typeof dest !== 'string') {
+    throw new TypeError('The argument \'dest\' must be a string')
+  }
+
+  const id = String(rand64())
+  const stopListening = onTreeProgress('fs.cp', id, options?.onProgress)
+
+  try {
+    const result = await ipc.send('fs.cp', {
+      id,
+      src,
+      dest,
+      recursive: options?.recursive === true,
+      force: options?.force !== false,
+      errorOnExist: options?.errorOnExist === true,
+      dereference: options?.dereference === true
+    })
+
+    if (result.err) {
+      throw result.err
+    }
+
+    return { entries: result.data.entries, bytes: result.data.bytes }
+  } finally {
+    stopListening()
+  }
+}
+
 /**
  * Asynchronously creates a directory.
  *
@@ -301,7 +422,7 @@ export async function readdir (path, options) {
 
 /**
  * @see {@link https://nodejs.org/dist/latest-v20.x/docs/api/fs.html#fspromisesreadfilepath-options}
- * @param {string} path
+ * @param {string | Buffer | URL | FileHandle} path - filename or FileHandle
  * @param {object?} [options]
  * @param {(string|null)?} [options.encoding = null]
  * @param {string?} [options.flag = 'r']
@@ -313,11 +434,44 @@ export async function readFile (path, options) {
     options = { encoding: options }
   }
 
+  if (path instanceof FileHandle) {
+    return await path.readFile(options)
+  }
+
   options = { flags: 'r', ...options }
 
-  return await visit(path, options, async (handle) => {
-    return await handle.readFile(options)
+  // opened, read and closed natively in a single request
+  const result = await ipc.request('fs.readFile', {
+    path: String(path),
+    flags: normalizeFlags(options.flag ?? options.flags)
+  }, {
+    signal: options.signal,
+    timeout: options.timeout,
+    responseType: 'arraybuffer'
   })
+
+  if (result.err) {
+    throw result.err
+  }
+
+  let buffer = null
+
+  if (isTypedArray(result.data) || result.data instanceof ArrayBuffer) {
+    buffer = Buffer.from(result.data)
+  } else if (!result.data || isEmptyObject(result.data)) {
+    // an empty response from mac returns an empty object sometimes
+    buffer = Buffer.alloc(0)
+  } else {
+    throw new TypeError(
+      `Invalid response buffer from 'fs.readFile' Received: ${typeof result.data}`
+    )
+  }
+
+  if (typeof options.encoding === 'string') {
+    return buffer.toString(options.encoding)
+  }
+
+  return buffer
 }
 
 /**
@@ -380,6 +534,44 @@ export async function rename (src, dest) {
   }
 }
 
+/**
+ * Removes `path`, with `options.recursive` a directory and everything in it.
+ * The removal runs natively off the main thread, `options.onProgress` is
+ * called with `{ entries, bytes, errors }` for batches of removed entries,
+ * where `errors` lists the entries (`{ path, code, message }`) that failed
+ * since the last call. The returned promise rejects with the first error.
+ * @see {@link https://nodejs.org/api/fs.html#fspromisesrmpath-options}
+ * @param {string} path
+ * @param {object?} [options]
+ * @param {boolean} [options.recursive = false]
+ * @param {boolean} [options.force = false] - Ignore `path` not existing
+ * @param {function?} [options.onProgress]
+ * @return {Promise}
+ */
+export async function rm (path, options) {
+  if (typeof path !== 'string') {
+    throw new TypeError('The argument \'path\' must be a string')
+  }
+
+  const id = String(rand64())
+  const stopListening = onTreeProgress('fs.rm', id, options?.onProgress)
+
+  try {
+    const result = await ipc.send('fs.rm', {
+      id,
+      path,
+      recursive: options?.recursive === true,
+      force: options?.force === true
+    })
+
+    if (result.err) {
+      throw result.err
+    }
+  } finally {
+    stopListening()
+  }
+}
+
 /**
  * Removes directory at `path`.
  * @param {string} path
@@ -474,17 +666,169 @@ export async function unlink (path) {
  * @param {AbortSignal?} [options.signal]
  * @return {Promise<void>}
  */
-// FIXME: truncate file by default (support flags). Currently it fails if file exists
 export async function writeFile (path, data, options) {
   if (typeof options === 'string') {
     options = { encoding: options }
   }
 
+  if (path instanceof FileHandle) {
+    return await path.writeFile(data, options)
+  }
+
   options = { flag: 'w', mode: 0o666, ...options }
 
-  return await visit(path, options, async (handle) => {
-    return await handle.writeFile(data, options)
+  // opened, written and closed natively in a single request
+  const buffer = Buffer.from(data, options.encoding ?? 'utf8')
+  const result = await ipc.write('fs.writeFile', {
+    path: String(path),
+    flags: normalizeFlags(options.flag ?? options.flags),
+    mode: options.mode
+  }, buffer, {
+    signal: options.signal,
+    timeout: options.timeout
   })
+
+  if (result.err) {
+    throw result.err
+  }
+}
+
+/**
+ * @see {@link https://nodejs.org/dist/latest-v20.x/docs/api/fs.html#fspromisesappendfilepath-data-options}
+ * @param {string | Buffer | URL | FileHandle} path - filename or FileHandle
+ * @param {string|Buffer|Array|DataView|TypedArray} data
+ * @param {object?} [options]
+ * @param {string|null} [options.encoding = 'utf8']
+ * @param {number} [options.mode = 0o666]
+ * @param {string} [options.flag = 'a']
+ * @param {AbortSignal?} [options.signal]
+ * @return {Promise<void>}
+ */
+export async function appendFile (path, data, options) {
+  if (typeof options === 'string') {
+    options = { encoding: options }
+  }
+
+  return await writeFile(path, data, { flag: 'a', ...options })
+}
+
+/**
+ * Walks the directory tree at `path`, yielding a `Dirent` for every entry
+ * with `name` set to its path relative to `path`. Directories are read in
+ * parallel natively, so entries of sibling directories may interleave.
+ * Globs support `*`, `**`, `?`, `[...]` and `{a,b}`, a glob without a `/`
+ * is matched against the entry name, otherwise against its relative path.
+ * Returning early from the iterator or aborting `options.signal` stops the
+ * walk.
+ * @param {string} path
+ * @param {object?} [options]
+ * @param {string|string[]} [options.include] - Globs entries must match
+ * @param {string|string[]} [options.exclude] - Globs of entries (and directories) to skip
+ * @param {number} [options.depth = -1] - Maximum depth to descend, `-1` for no limit
+ * @param {boolean} [options.followSymlinks = false]
+ * @param {boolean} [options.withStats = false] - Set `dirent.stats` for every entry
+ * @param {number} [options.batchSize = 256] - Entries sent per native event
+ * @param {AbortSignal?} [options.signal]
+ * @return {AsyncGenerator<Dirent>}
+ */
+export async function * walk (path, options) {
+  if (typeof path !== 'string') {
+    throw new TypeError('The argument \'path\' must be a string')
+  }
+
+  const id = String(options?.id || rand64())
+  const signal = options?.signal ?? null
+  const entries = []
+  const globs = (value) => [].concat(value ?? []).join('\n')
+
+  let offset = 0
+  let error = null
+  let finished = false
+  let wake = null
+  // `fs.walk` events received, and the number sent once the reply is in,
+  // as events may arrive after the reply
+  let batches = 0
+  let expected = Infinity
+
+  if (signal?.aborted) {
+    throw new AbortError(signal)
+  }
+
+  const notify = () => {
+    if (typeof wake === 'function') {
+      wake()
+      wake = null
+    }
+  }
+
+  const onabort = () => {
+    error = new AbortError(signal)
+    notify()
+  }
+
+  const stopListening = hooks.onData((event) => {
+    const { data, source } = event.detail.params
+    if (source !== 'fs.walk' || String(data?.id) !== id || !Array.isArray(data.entries)) {
+      return
+    }
+
+    for (const entry of data.entries) {
+      const stats = entry.stats ? Stats.from(entry.stats) : undefined
+      entries.push(new Dirent(entry.path, entry.type, stats))
+    }
+
+    batches++
+    notify()
+  })
+
+  signal?.addEventListener?.('abort', onabort)
+
+  ipc.send('fs.walk', {
+    id,
+    path,
+    include: globs(options?.include),
+    exclude: globs(options?.exclude),
+    depth: options?.depth ?? -1,
+    followSymlinks: options?.followSymlinks === true,
+    withStats: options?.withStats === true,
+    batchSize: options?.batchSize ?? 256
+  }).then((result) => {
+    error = error ?? result.err ?? null
+    expected = Number(result.data?.batches ?? 0)
+    finished = true
+    notify()
+  }, (err) => {
+    error = error ?? err
+    finished = true
+    notify()
+  })
+
+  try {
+    while (true) {
+      if (error) {
+        throw error
+      }
+
+      if (offset < entries.length) {
+        yield entries[offset++]
+        continue
+      }
+
+      if (finished && batches >= expected) {
+        break
+      }
+
+      entries.length = offset = 0
+      await new Promise((resolve) => { wake = resolve })
+    }
+  } finally {
+    stopListening()
+    signal?.removeEventListener?.('abort', onabort)
+
+    if (!finished) {
+      await ipc.send('fs.stopWalk', { id })
+    }
+  }
 }
 
 /**
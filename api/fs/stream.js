@@ -3,6 +3,7 @@
  */
 import { Readable, Writable } from '../stream.js'
 import { AbortError } from '../errors.js'
+import { Buffer } from '../buffer.js'
 
 import * as exports from './stream.js'
 
@@ -34,7 +35,7 @@ export class ReadStream extends Readable {
     this.end = typeof options?.end === 'number' ? options.end : Infinity
     this.start = typeof options?.start === 'number' ? options.start : 0
     this.handle = null
-    this.buffer = new ArrayBuffer(this.highWaterMark)
+    this.reader = null
     this.signal = options?.signal
     this.timeout = options?.timeout || undefined
     this.bytesRead = 0
@@ -122,7 +123,7 @@ export class ReadStream extends Readable {
   }
 
   async _read (callback) {
-    const { signal, handle, timeout, buffer } = this
+    const { signal, handle, timeout } = this
 
     if (!handle || !handle.opened) {
       return callback(new Error('File handle not opened'))
@@ -132,26 +133,28 @@ export class ReadStream extends Readable {
       return callback(new AbortError(this.signal))
     }
 
-    const position = Math.max(0, this.start) + this.bytesRead
-    const length = Math.max(0, this.end) < Infinity
-      ? Math.min(this.end - position, buffer.byteLength)
-      : buffer.byteLength
+    // the file is streamed in a single chunked response where supported
+    if (!this.reader) {
+      this.reader = handle.readableWebStream({
+        start: Math.max(0, this.start) + this.bytesRead,
+        end: Math.max(0, this.end),
+        highWaterMark: this.highWaterMark,
+        timeout,
+        signal
+      }).getReader()
+    }
 
     let result = null
 
     try {
-      result = await handle.read(buffer, 0, length, position, {
-        timeout,
-        signal
-      })
+      result = await this.reader.read()
     } catch (err) {
       return callback(err)
     }
 
-    if (typeof result.bytesRead === 'number' && result.bytesRead > 0) {
-      const slice = new Uint8Array(buffer.slice(0, result.bytesRead))
-      this.bytesRead += result.bytesRead
-      this.push(slice)
+    if (!result.done && result.value.byteLength > 0) {
+      this.bytesRead += result.value.byteLength
+      this.push(result.value)
 
       if (this.bytesRead >= this.end) {
         this.push(null)
@@ -162,6 +165,15 @@ export class ReadStream extends Readable {
 
     callback(null)
   }
+
+  _destroy (callback) {
+    if (this.reader) {
+      this.reader.cancel().catch(() => {})
+      this.reader = null
+    }
+
+    super._destroy(callback)
+  }
 }
 
 /**
@@ -263,22 +275,31 @@ export class WriteStream extends Writable {
     return super.emit(event, ...args)
   }
 
-  async _write (buffer, callback) {
+  /**
+   * Writes queued chunks as a batch with a single `FileHandle.writev()`.
+   * @protected
+   */
+  async _writev (buffers, callback) {
     const { signal, handle, timeout } = this
 
     if (!handle || !handle.opened) {
       return callback(new Error('File handle not opened'))
     }
 
-    const position = this.start + this.bytesWritten
-    let result = null
+    buffers = buffers
+      .map((buffer) => typeof buffer === 'string' ? Buffer.from(buffer) : buffer)
+      .filter((buffer) => buffer.length > 0)
 
-    if (!buffer.length) {
+    if (!buffers.length) {
       return callback(null)
     }
 
+    const position = this.start + this.bytesWritten
+    const length = buffers.reduce((length, buffer) => length + buffer.length, 0)
+    let result = null
+
     try {
-      result = await handle.write(buffer, 0, buffer.length, position, {
+      result = await handle.writev(buffers, position, {
         timeout,
         signal
       })
@@ -289,8 +310,9 @@ export class WriteStream extends Writable {
     if (typeof result.bytesWritten === 'number' && result.bytesWritten > 0) {
       this.bytesWritten += result.bytesWritten
 
-      if (result.bytesWritten !== buffer.length) {
-        return await this._write(buffer.slice(result.bytesWritten), callback)
+      if (result.bytesWritten !== length) {
+        const remaining = Buffer.concat(buffers).subarray(result.bytesWritten)
+        return await this._writev([remaining], callback)
       }
     }
 
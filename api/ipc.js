@@ -1382,6 +1382,50 @@ export async function request (command, value, options) {
   })
 }
 
+/**
+ * Sends an async IPC command request with parameters requesting a chunked
+ * response. On success the `Result` data is a `ReadableStream` of the
+ * response body, which is read as the chunks arrive. Routes that fail reply
+ * with JSON, which is resolved as a `Result` error.
+ * @param {string} command
+ * @param {any=} value
+ * @param {object=} options
+ * @param {AbortSignal=} [options.signal]
+ * @return {Promise<Result>}
+ * @ignore
+ */
+export async function stream (command, value, options) {
+  if (typeof globalThis.fetch !== 'function') {
+    const err = new Error('fetch is not supported in environment')
+    return Result.from(err)
+  }
+
+  await ready()
+
+  const params = new IPCSearchParams(value, Date.now())
+  const uri = `ipc://${command}?${params}`
+
+  let response = null
+
+  if (debug.enabled) {
+    debug.log('ipc.stream:', uri)
+  }
+
+  try {
+    response = await globalThis.fetch(uri, { signal: options?.signal })
+  } catch (err) {
+    return Result.from(null, err, command)
+  }
+
+  const contentType = response.headers.get('content-type') || ''
+
+  if (contentType.includes('application/json')) {
+    return Result.from(await response.json(), null, command, response.headers)
+  }
+
+  return Result.from(response.body, null, command, response.headers)
+}
+
 /**
  * Factory for creating a proxy based IPC API.
  * @param {string} domain
@@ -1398,6 +1442,7 @@ export function createBinding (domain, ctx) {
     request,
     send,
     sendSync,
+    stream,
     write
   }
 
@@ -1464,7 +1509,10 @@ if (typeof globalThis?.window !== 'undefined') {
   document.addEventListener('DOMContentLoaded', () => {
     queueMicrotask(async () => {
       try {
-        await send('platform.event', 'domcontentloaded')
+        await send('platform.event', {
+          value: 'domcontentloaded',
+          data: Math.round(globalThis.performance?.now?.() ?? 0)
+        })
       } catch (err) {
         console.error('ERR:', err)
       }
@@ -200,6 +200,53 @@ extern "C" {
     sapi_context_dispatch_callback callback
   );
 
+  /**
+   * Calls `callback` for a `context` on the runtime event loop after
+   * `timeout` milliseconds, unless `context` is released before.
+   * @param context  - An extension context
+   * @param timeout  - The timeout in milliseconds
+   * @param data     - User data to be given to `callback` when called
+   * @param callback - The callback to call
+   * @return A timer id for `sapi_context_clear_timeout()`, or `0` on failure
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  uint64_t sapi_context_set_timeout (
+    sapi_context_t* context,
+    uint64_t timeout,
+    const void* data,
+    sapi_context_dispatch_callback callback
+  );
+
+  /**
+   * Calls `callback` for a `context` on the runtime event loop every
+   * `interval` milliseconds until cleared or `context` is released.
+   * @param context  - An extension context
+   * @param interval - The interval in milliseconds
+   * @param data     - User data to be given to `callback` when called
+   * @param callback - The callback to call
+   * @return A timer id for `sapi_context_clear_timeout()`, or `0` on failure
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  uint64_t sapi_context_set_interval (
+    sapi_context_t* context,
+    uint64_t interval,
+    const void* data,
+    sapi_context_dispatch_callback callback
+  );
+
+  /**
+   * Cancels a timer created with `sapi_context_set_timeout()` or
+   * `sapi_context_set_interval()`.
+   * @param context - An extension context
+   * @param id      - The timer id
+   * @return `true` if the timer was pending and is now cancelled
+   */
+  SOCKET_RUNTIME_EXTENSION_EXPORT
+  bool sapi_context_clear_timeout (
+    sapi_context_t* context,
+    uint64_t id
+  );
+
   /**
    * Retain a context preventing any allocated memory from being deallocated
    * when the context is considered no longer valid. This function SHOULD NOT
@@ -28,10 +28,55 @@ namespace SSC {
   FILE* console;
 #endif
 
+#if defined(__linux__) && !defined(__ANDROID__)
+  struct DispatchSource {
+    GSource base; // should ALWAYS be first member
+    App *app;
+  };
+
+  // a single persistent source drains `App::dispatchQueue` instead of
+  // allocating an idle source per callback
+  // @see https://api.gtkd.org/glib.c.types.GSourceFuncs.html
+  static GSourceFuncs dispatchSourceFunctions = {
+    .prepare = [](GSource *source, gint *timeout) -> gboolean {
+      auto app = reinterpret_cast<DispatchSource *>(source)->app;
+      *timeout = -1;
+      return !app->dispatchQueue.empty();
+    },
+
+    .check = [](GSource *source) -> gboolean {
+      auto app = reinterpret_cast<DispatchSource *>(source)->app;
+      return !app->dispatchQueue.empty();
+    },
+
+    .dispatch = [](
+      GSource *source,
+      GSourceFunc callback,
+      gpointer user_data
+    ) -> gboolean {
+      auto app = reinterpret_cast<DispatchSource *>(source)->app;
+      // cleared before draining so a callback dispatched from here on
+      // wakes the main context again
+      app->isDispatchPending = false;
+      // whatever is left over is picked up by `prepare()` on the next
+      // iteration, after pending input and paint sources had their turn
+      app->dispatchQueue.drain(App::DISPATCH_BUDGET);
+      return G_SOURCE_CONTINUE;
+    }
+  };
+#endif
+
   App::App () {
     this->core = new Core();
     auto cwd = getCwd();
     uv_chdir(cwd.c_str());
+
+#if defined(__linux__) && !defined(__ANDROID__)
+    this->dispatchSource = g_source_new(&dispatchSourceFunctions, sizeof(DispatchSource));
+    reinterpret_cast<DispatchSource *>(this->dispatchSource)->app = this;
+    g_source_set_priority(this->dispatchSource, G_PRIORITY_HIGH_IDLE);
+    g_source_attach(this->dispatchSource, nullptr);
+#endif
   }
 
   App::App (int) : App() {
@@ -40,6 +85,16 @@ namespace SSC {
 #endif
   }
 
+  App::~App () {
+#if defined(__linux__) && !defined(__ANDROID__)
+    if (this->dispatchSource != nullptr) {
+      g_source_destroy(this->dispatchSource);
+      g_source_unref(this->dispatchSource);
+      this->dispatchSource = nullptr;
+    }
+#endif
+  }
+
   int App::run () {
 #if defined(__linux__) && !defined(__ANDROID__)
     gtk_main();
@@ -111,19 +166,12 @@ namespace SSC {
 
   void App::dispatch (std::function<void()> callback) {
 #if defined(__linux__) && !defined(__ANDROID__)
-    auto threadCallback = new std::function<void()>(callback);
-
-    g_idle_add_full(
-      G_PRIORITY_HIGH_IDLE,
-      (GSourceFunc)([](void* callback) -> int {
-        (*static_cast<std::function<void()>*>(callback))();
-        return G_SOURCE_REMOVE;
-      }),
-      threadCallback,
-      [](void* callback) {
-        delete static_cast<std::function<void()>*>(callback);
-      }
-    );
+    this->dispatchQueue.push(std::move(callback));
+
+    // one wake up per drain, not per callback
+    if (!this->isDispatchPending.exchange(true)) {
+      g_main_context_wakeup(nullptr);
+    }
 #elif defined(__APPLE__)
     auto priority = DISPATCH_QUEUE_PRIORITY_DEFAULT;
     auto queue = dispatch_get_global_queue(priority, 0);
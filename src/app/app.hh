@@ -20,6 +20,14 @@ namespace SSC {
       MSG msg;
       WNDCLASSEX wcex;
       _In_ HINSTANCE hInstance;
+#elif defined(__linux__) && !defined(__ANDROID__)
+      // the longest `dispatch()` callbacks may run per main loop iteration
+      // before GTK gets to process input and paint again
+      static constexpr auto DISPATCH_BUDGET = std::chrono::milliseconds(4);
+
+      DispatchQueue dispatchQueue;
+      GSource* dispatchSource = nullptr;
+      Atomic<bool> isDispatchPending = false;
 #endif
 
       ExitCallback onExit = nullptr;
@@ -38,6 +46,7 @@ namespace SSC {
 
       App (int);
       App ();
+      ~App ();
 
       int run ();
       void kill ();
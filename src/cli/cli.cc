@@ -144,10 +144,61 @@ bool equal (const String& s1, const String& s2) {
   return s1.compare(s2) == 0;
 };
 
-const Map SSC::getUserConfig () {
+const Map& SSC::getUserConfig () {
   return settings;
 }
 
+const String SSC::getUserConfigValue (const String& key) {
+  if (settings.contains(key)) {
+    return settings.at(key);
+  }
+
+  return "";
+}
+
+static String encodeCStringLiteral (const String& input) {
+  static const char* digits = "01234567";
+  String output = "\"";
+
+  for (const auto ch : input) {
+    const auto byte = (unsigned char) ch;
+    if (byte == '"' || byte == '\\' || byte == '?' || byte < 0x20 || byte >= 0x7f) {
+      output += '\\';
+      output += digits[(byte >> 6) & 7];
+      output += digits[(byte >> 3) & 7];
+      output += digits[byte & 7];
+    } else {
+      output += ch;
+    }
+  }
+
+  return output + "\"";
+}
+
+// Generates a pre-parsed user config table for `user-config-bytes.hh`.
+// Keys are emitted in sorted order (`Map` is ordered) so the runtime can
+// binary search them without parsing INI source at startup.
+static String getUserConfigTableCode (const Map& config) {
+  StringStream keys;
+  StringStream values;
+
+  for (const auto& entry : config) {
+    keys
+      << "  std::string_view(" << encodeCStringLiteral(entry.first)
+      << ", " << entry.first.size() << "),\n";
+    values
+      << "  std::string_view(" << encodeCStringLiteral(entry.second)
+      << ", " << entry.second.size() << "),\n";
+  }
+
+  const auto size = std::to_string(config.size());
+  return String(
+    "constexpr size_t __ssc_config_size = " + size + ";\n"
+    "constexpr std::string_view __ssc_config_keys[" + size + "] = {\n" + keys.str() + "};\n"
+    "constexpr std::string_view __ssc_config_values[" + size + "] = {\n" + values.str() + "};"
+  );
+}
+
 bool SSC::isDebugEnabled () {
   return DEBUG == 1;
 }
@@ -2058,31 +2109,9 @@ int main (const int argc, const char* argv[]) {
         ini += "\n";
 
         if (configExists) {
-          auto hex = encodeHexString(ini);
-          auto bytes = StringStream();
-          auto length = hex.size() - 1;
-          int size = 0;
-
-          for (int i = 0; i < length; i += 2) {
-            size++;
-
-            if (i != 0 && (i & 3) == 0) {
-              bytes << "\n";
-            }
-
-            bytes << "  ";
-            if (i + 2 < length) {
-              bytes << "0x" << hex.substr(i, 2) << ",";
-            } else if (i + 1 < length) {
-              bytes << "0x0" << hex.substr(i, 1);
-            } else {
-              bytes << "0x" << hex.substr(i, 2);
-            }
-          }
-
-          code = String(
-            "constexpr unsigned char __ssc_config_bytes["+ std::to_string(size) +"] = {\n" + bytes.str() + "\n};"
-          );
+          // the runtime reads this table directly, so it is generated from
+          // `ini` before any CLI specific mutations are made to `settings`
+          code = getUserConfigTableCode(INI::parse(ini));
         }
 
         settings = INI::parse(ini);
@@ -3071,15 +3100,23 @@ int main (const int argc, const char* argv[]) {
       fs::copy(trim(prefixFile("src/core/codec.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/config.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/core.hh")), jni / "core", fs::copy_options::overwrite_existing);
+      fs::copy(trim(prefixFile("src/core/coroutine.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/debug.hh")), jni / "core", fs::copy_options::overwrite_existing);
+      fs::copy(trim(prefixFile("src/core/descriptor_table.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/env.hh")), jni / "core", fs::copy_options::overwrite_existing);
+      fs::copy(trim(prefixFile("src/core/hash.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/ini.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/io.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/json.hh")), jni / "core", fs::copy_options::overwrite_existing);
+      fs::copy(trim(prefixFile("src/core/metadata_cache.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/platform.hh")), jni / "core", fs::copy_options::overwrite_existing);
+      fs::copy(trim(prefixFile("src/core/pool.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/preload.hh")), jni / "core", fs::copy_options::overwrite_existing);
+      fs::copy(trim(prefixFile("src/core/queue.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/string.hh")), jni / "core", fs::copy_options::overwrite_existing);
+      fs::copy(trim(prefixFile("src/core/timing_wheel.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/types.hh")), jni / "core", fs::copy_options::overwrite_existing);
+      fs::copy(trim(prefixFile("src/core/uring.hh")), jni / "core", fs::copy_options::overwrite_existing);
       fs::copy(trim(prefixFile("src/core/version.hh")), jni / "core", fs::copy_options::overwrite_existing);
       // ipc
       fs::copy(trim(prefixFile("src/ipc/ipc.hh")), jni / "ipc", fs::copy_options::overwrite_existing);
@@ -6333,6 +6370,8 @@ int main (const int argc, const char* argv[]) {
       sources.push_back("socket.ini");
 
       FileSystemWatcher* sourcesWatcher = new FileSystemWatcher(sources);
+      // a save that touches many files rebuilds once
+      sourcesWatcher->options.coalesce = true;
       auto watchingSources = sourcesWatcher->start([=](
         const String& path,
         const Vector<FileSystemWatcher::Event>& events,
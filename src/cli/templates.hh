@@ -1725,6 +1725,40 @@ watch = false
 ; allow_airplay = true
 
 
+[core]
+
+; The number of threads in the core CPU worker pool.
+; default value: the number of CPU cores
+; workers = 4
+
+; The number of event loops, each with its own thread, that UDP peers and
+; file descriptors are spread across. `0` or `1` uses a single event loop.
+; default value: 0
+; shards = 4
+
+; Pin each event loop shard thread to a CPU core (Linux and Windows only).
+; default value: false
+; shards_affinity = true
+
+; Cache `fs.stat`, `fs.lstat` and `fs.access` results, including "not found"
+; results, by path. Entries are dropped when their directory changes.
+; default value: false
+; fs_metadata_cache = true
+
+; The maximum number of entries in the metadata cache.
+; default value: 4096
+; fs_metadata_cache_size = 4096
+
+; Milliseconds a metadata cache entry is used for, `0` for no limit.
+; default value: 1000
+; fs_metadata_cache_ttl = 1000
+
+; Reads kept in flight ahead of an `fs.stream` response, which
+; `fs.createReadStream()` uses where chunked responses are supported.
+; default value: 4
+; fs_stream_window = 4
+
+
 [debug]
 ; Advanced Compiler Settings for debug purposes (ie C++ compiler -g, etc).
 flags = "-g"
@@ -1812,6 +1846,15 @@ categories = "Developer Tools"
 ; The icon to use for identifying your app in Linux desktop environments.
 icon = "src/icon.png"
 
+; Run the core event loop on its own thread instead of the GTK main thread.
+; default value: false
+; event_loop_thread = true
+
+; Submit file system operations through io_uring instead of the libuv thread
+; pool. Falls back to libuv when the kernel doesn't allow io_uring.
+; default value: false
+; fs_io_uring = true
+
 
 [mac]
 
@@ -8,24 +8,65 @@ namespace SSC {
   static constexpr char NAMESPACE_SEPARATOR = '.';
   static const String NAMESPACE_SEPARATOR_STRING = String(1, NAMESPACE_SEPARATOR);
 
+  static const String getNamespace (const String& key) {
+    const auto parts = split(key, NAMESPACE_SEPARATOR_STRING);
+
+    if (parts.size() == 0) {
+      return "";
+    }
+
+    return join(
+      Vector<String>(parts.begin(), parts.begin() + parts.size() - 1),
+      NAMESPACE_SEPARATOR_STRING
+    );
+  }
+
   Config::Config (const String& source) {
     this->map = INI::parse(source, NAMESPACE_SEPARATOR_STRING);
+    this->reindex();
   }
 
   Config::Config (const Config& source) : prefix(source.prefix) {
-    this->map = source.data();
+    this->map = source.map;
+    this->namespaces = source.namespaces;
   }
 
   Config::Config (const Map& source) {
     this->map = source;
+    this->reindex();
   }
 
   Config::Config (const String& prefix, const Map& source) : prefix(prefix) {
     this->map = source;
+    this->reindex();
   }
 
   Config::Config (const String& prefix, const Config& source) : prefix(prefix) {
-    this->map = source.data();
+    this->map = source.map;
+    this->namespaces = source.namespaces;
+  }
+
+  void Config::index (const String& key) {
+    this->namespaces[getNamespace(key)].insert(key);
+  }
+
+  void Config::unindex (const String& key) {
+    const auto ns = getNamespace(key);
+    const auto entry = this->namespaces.find(ns);
+
+    if (entry != this->namespaces.end()) {
+      entry->second.erase(key);
+      if (entry->second.size() == 0) {
+        this->namespaces.erase(entry);
+      }
+    }
+  }
+
+  void Config::reindex () {
+    this->namespaces.clear();
+    for (const auto& tuple : this->map) {
+      this->index(tuple.first);
+    }
   }
 
   const String Config::get (const String& key) const noexcept {
@@ -41,7 +82,9 @@ namespace SSC {
   }
 
   void Config::set (const String& key, const String& value) noexcept {
-    this->map.insert_or_assign(key, value);
+    if (this->map.insert_or_assign(key, value).second) {
+      this->index(key);
+    }
   }
 
   const std::size_t Config::size () const noexcept {
@@ -59,6 +102,7 @@ namespace SSC {
   bool Config::erase (const String& key) noexcept {
     if (this->map.contains(key)) {
       this->map.erase(key);
+      this->unindex(key);
       return true;
     }
 
@@ -68,6 +112,7 @@ namespace SSC {
     for (const auto& tuple : view) {
       if (this->map.contains(tuple.first)) {
         this->map.erase(tuple.first);
+        this->unindex(tuple.first);
         erased = true;
       }
     }
@@ -80,17 +125,23 @@ namespace SSC {
   }
 
   const Config Config::slice (const String& key) const noexcept {
-    const auto view = this->query("[" + key + "]");
+    // namespace brackets are not valid in a key and would fail to `query()`
+    if (key.find_first_of("[]") != String::npos) {
+      return Config { key, Map {} };
+    }
+
+    const auto needle = key + NAMESPACE_SEPARATOR;
     Map slice;
 
-    for (const auto& tuple : view) {
-      if (
-        tuple.first.starts_with(key + NAMESPACE_SEPARATOR) &&
-        tuple.second.size() > 0
-      ) {
-        const auto k = tuple.first.substr(key.size() + 1, tuple.first.size());
-        const auto v = tuple.second;
-        slice.insert_or_assign(k, v);
+    // keys are sorted, so every key in the slice is in one contiguous range
+    for (
+      auto it = this->map.lower_bound(needle);
+      it != this->map.end() && it->first.starts_with(needle);
+      ++it
+    ) {
+      if (it->second.size() > 0) {
+        const auto k = it->first.substr(needle.size(), it->first.size());
+        slice.insert_or_assign(k, it->second);
       }
     }
 
@@ -193,35 +244,47 @@ namespace SSC {
     state.compared = trim(state.compared);
 
     const auto& path = join(state.paths, NAMESPACE_SEPARATOR_STRING);
-    for (const auto& tuple : this->map) {
-      const auto parts = split(tuple.first, NAMESPACE_SEPARATOR_STRING);
-      const auto& target = tuple.first;
-      const auto prefix = join(
-        Vector<String>(parts.begin(), parts.begin() + parts.size() - 1),
-        NAMESPACE_SEPARATOR_STRING
-      );
-
-      bool match = false;
-      if (path.starts_with(NAMESPACE_SEPARATOR_STRING)) {
-        if (state.compare) {
-          match = prefix.ends_with(path);
-        } else {
-          match = prefix.find(path) != String::npos;
-        }
-      } else if (path == "*") {
-        match = true;
-      } else if (prefix.starts_with(path)) {
-        match = true;
+    const auto visit = [&state](const String& target, const String& prefix) {
+      if (state.property == "*") {
+        state.targets.push_back(target);
+        state.compare = false;
+      } else if (state.compare || state.property.size() > 0) {
+        state.targets.push_back(prefix);
+      } else {
+        state.targets.push_back(target);
       }
+    };
 
-      if (match) {
-        if (state.property == "*") {
-          state.targets.push_back(target);
-          state.compare = false;
-        } else if (state.compare || state.property.size() > 0) {
-          state.targets.push_back(prefix);
-        } else {
-          state.targets.push_back(target);
+    if (path == "*") {
+      for (const auto& tuple : this->namespaces) {
+        for (const auto& target : tuple.second) {
+          visit(target, tuple.first);
+        }
+      }
+    } else if (path.starts_with(NAMESPACE_SEPARATOR_STRING)) {
+      // `[.name]` matches anywhere in a namespace, so only the (much smaller)
+      // set of namespaces is scanned, never the individual keys
+      for (const auto& tuple : this->namespaces) {
+        const auto& prefix = tuple.first;
+        const auto match = state.compare
+          ? prefix.ends_with(path)
+          : prefix.find(path) != String::npos;
+
+        if (match) {
+          for (const auto& target : tuple.second) {
+            visit(target, prefix);
+          }
+        }
+      }
+    } else {
+      // namespaces starting with `path` are one contiguous sorted range
+      for (
+        auto it = this->namespaces.lower_bound(path);
+        it != this->namespaces.end() && it->first.starts_with(path);
+        ++it
+      ) {
+        for (const auto& target : it->second) {
+          visit(target, it->first);
         }
       }
     }
@@ -266,6 +329,10 @@ namespace SSC {
   }
 
   const String& Config::operator [] (const String& key) {
+    if (!this->map.contains(key)) {
+      this->index(key);
+    }
+
     return this->map[key];
   }
 
@@ -283,6 +350,7 @@ namespace SSC {
     }
 
     this->map.clear();
+    this->namespaces.clear();
     return true;
   }
 
@@ -2,6 +2,7 @@
 #define SSC_CORE_CONFIG_H
 
 #include <iterator>
+#include <set>
 
 // TODO(@jwerle): remove this and any need for it
 #ifndef SSC_SETTINGS
@@ -41,7 +42,8 @@
 
 namespace SSC {
   // implemented in `init.cc`
-  extern const Map getUserConfig ();
+  extern const Map& getUserConfig ();
+  extern const String getUserConfigValue (const String& key);
   extern bool isDebugEnabled ();
   extern const char* getDevHost ();
   extern int getDevPort ();
@@ -56,6 +58,18 @@ namespace SSC {
      * caller in `Config::data()`
      */
     Map map;
+
+    /**
+     * Sorted index of namespaces (a key without its last `.` component)
+     * to the keys in that namespace. Kept in sync with `map` so `query()`
+     * and `slice()` only visit matching entries.
+     */
+    std::map<String, std::set<String>> namespaces;
+
+    void index (const String& key);
+    void unindex (const String& key);
+    void reindex ();
+
     public:
       using Iterator = Map::const_iterator;
       using Path = Vector<String>;
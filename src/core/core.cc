@@ -1,25 +1,73 @@
 #include "core.hh"
 
-#define IMAX_BITS(m) ((m)/((m) % 255+1) / 255 % 255 * 8 + 7-86 / ((m) % 255+12))
-#define RAND_MAX_WIDTH IMAX_BITS(RAND_MAX)
+#if defined(__linux__)
+#include <sched.h>
+#endif
 
 namespace SSC {
-  uint64_t rand64 () {
-    uint64_t r = 0;
-    static bool init = false;
+  /**
+   * Per-thread xoshiro256** generator state.
+   * @see https://prng.di.unimi.it/xoshiro256starstar.c
+   */
+  struct RandomState {
+    uint64_t s[4] = {0};
+
+    static inline uint64_t rotl (const uint64_t x, int k) {
+      return (x << k) | (x >> (64 - k));
+    }
 
-    if (!init) {
-      init = true;
-      srand(time(0));
+    static inline uint64_t splitmix64 (uint64_t& x) {
+      uint64_t z = (x += 0x9e3779b97f4a7c15);
+      z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+      z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+      return z ^ (z >> 31);
     }
 
-    for (int i = 0; i < 64; i += RAND_MAX_WIDTH) {
-      r <<= RAND_MAX_WIDTH;
-      r ^= (unsigned) rand();
+    RandomState () {
+      // `uv_random()` reads from `getrandom(2)` on Linux, `arc4random_buf(3)`
+      // on Apple platforms and `RtlGenRandom()` on Windows
+      if (uv_random(nullptr, nullptr, this->s, sizeof(this->s), 0, nullptr) != 0) {
+        uint64_t x = uv_hrtime() ^ (uint64_t) (uintptr_t) this;
+        x ^= (uint64_t) std::hash<std::thread::id>{}(std::this_thread::get_id());
+        for (auto& word : this->s) {
+          word = splitmix64(x);
+        }
+      }
+
+      // the all zero state is the only invalid state for xoshiro256**
+      if (!(this->s[0] | this->s[1] | this->s[2] | this->s[3])) {
+        uint64_t x = uv_hrtime();
+        for (auto& word : this->s) {
+          word = splitmix64(x);
+        }
+      }
     }
-    return r;
+
+    inline uint64_t next () {
+      const uint64_t result = rotl(this->s[1] * 5, 7) * 9;
+      const uint64_t t = this->s[1] << 17;
+
+      this->s[2] ^= this->s[0];
+      this->s[3] ^= this->s[1];
+      this->s[1] ^= this->s[2];
+      this->s[0] ^= this->s[3];
+      this->s[2] ^= t;
+      this->s[3] = rotl(this->s[3], 45);
+
+      return result;
+    }
+  };
+
+  uint64_t rand64 () {
+    static thread_local RandomState state;
+    return state.next();
   }
 
+  uint64_t monotonic64 () {
+    // `0` is reserved to mean "no id" by callers
+    static Atomic<uint64_t> counter = 1;
+    return counter.fetch_add(1, std::memory_order_relaxed);
+  }
 
   void msleep (uint64_t ms) {
     std::this_thread::yield();
@@ -166,6 +214,10 @@ namespace SSC {
     return this->str().c_str();
   }
 
+  Core::~Core () {
+    closeEventLoopShards();
+  }
+
   Post Core::getPost (uint64_t id) {
     Lock lock(postsMutex);
     if (posts->find(id) == posts->end()) return Post{};
@@ -190,7 +242,9 @@ namespace SSC {
   void Core::expirePosts () {
     Lock lock(postsMutex);
     std::vector<uint64_t> ids;
-    auto now = std::chrono::system_clock::now()
+    uint64_t now = std::chrono::time_point_cast<std::chrono::milliseconds>(
+      std::chrono::system_clock::now()
+    )
       .time_since_epoch()
       .count();
 
@@ -212,23 +266,42 @@ namespace SSC {
     Lock lock(postsMutex);
     p.ttl = std::chrono::time_point_cast<std::chrono::milliseconds>(
       std::chrono::system_clock::now() +
-      std::chrono::milliseconds(32 * 1024)
+      std::chrono::milliseconds(POST_TTL)
     )
       .time_since_epoch()
       .count();
+
+    // replacing a post cancels the expiry of the post it replaces
+    auto it = posts->find(id);
+    if (it != posts->end() && it->second.timer != 0) {
+      timers.clearTimeout(it->second.timer);
+    }
+
+    // expire the post when its TTL elapses if it was never consumed
+    p.timer = timers.setTimeout(POST_TTL, [this, id, ttl = p.ttl]() {
+      Lock lock(postsMutex);
+      auto it = posts->find(id);
+      // skipped if the post was replaced while this timer was firing
+      if (it != posts->end() && it->second.ttl == ttl) {
+        it->second.timer = 0;
+        removePost(id);
+      }
+    });
+
     posts->insert_or_assign(id, p);
   }
 
   void Core::removePost (uint64_t id) {
     Lock lock(postsMutex);
-    if (posts->find(id) == posts->end()) return;
-    auto post = getPost(id);
+    auto it = posts->find(id);
+    if (it == posts->end()) return;
 
-    if (post.body) {
-      delete [] post.body;
+    if (it->second.timer != 0) {
+      timers.clearTimeout(it->second.timer);
     }
 
-    posts->erase(id);
+    freePostBody(it->second);
+    posts->erase(it);
   }
 
   String Core::createPost (String seq, String params, Post post) {
@@ -548,7 +621,7 @@ namespace SSC {
       buffer = Core::OS::RECV_BUFFER;
     }
 
-    this->core->dispatchEventLoop([=, this]() {
+    this->core->dispatchEventLoop(peerId, [=, this]() {
       auto peer = this->core->getPeer(peerId);
 
       if (peer == nullptr) {
@@ -601,23 +674,39 @@ namespace SSC {
 
   void Core::Platform::event (
     const String seq,
+    int index,
     const String event,
     const String data,
     Module::Callback cb
   ) {
+    const auto now = DescriptorTable<FS::Descriptor>::now();
+
     this->core->dispatchEventLoop([=, this]() {
       // init page
       if (event == "domcontentloaded") {
         Lock lock(this->core->fs.mutex);
+        auto& descriptors = this->core->fs.descriptors;
+        uint64_t elapsed = 0;
 
-        for (auto const &tuple : this->core->fs.descriptors) {
-          auto desc = tuple.second;
-          if (desc != nullptr) {
-            desc->stale = true;
-          } else {
-            this->core->fs.descriptors.erase(tuple.first);
+        // milliseconds since the page started loading
+        try {
+          elapsed = std::stoull(data);
+        } catch (...) {}
+
+        const auto loadedAt = now - std::min(now, elapsed);
+
+        // descriptors of the previous page in this window are collected
+        // unless retained, other windows and the loading page keep theirs
+        descriptors.forEach([&descriptors, index, loadedAt](auto id, auto desc) {
+          if (desc->index != index || desc->insertedAt >= loadedAt) {
+            return;
           }
-        }
+
+          desc->stale = true;
+          if (!desc->isRetained()) {
+            descriptors.markStale(desc);
+          }
+        });
 
         #if !defined(__ANDROID__)
         for (auto const &tuple : this->core->fs.watchers) {
@@ -944,6 +1033,14 @@ namespace SSC {
   }
 
 #if defined(__linux__) && !defined(__ANDROID__)
+  // `[linux] event_loop_thread = true` runs `eventLoop` on its own thread
+  // instead of driving it from the GTK main loop with a `GSource`
+  static bool isEventLoopThreadEnabled () {
+    static auto userConfig = getUserConfig();
+    static const auto enabled = userConfig["linux_event_loop_thread"] == "true";
+    return enabled;
+  }
+
   struct UVSource {
     GSource base; // should ALWAYS be first member
     gpointer tag;
@@ -976,6 +1073,14 @@ namespace SSC {
   };
 #endif
 
+  Core::Options Core::getDefaultOptions () {
+    auto options = Options {};
+  #if defined(__linux__) && !defined(__ANDROID__)
+    options.eventLoopThread = isEventLoopThreadEnabled();
+  #endif
+    return options;
+  }
+
   void Core::initEventLoop () {
     if (didLoopInit) {
       return;
@@ -984,30 +1089,40 @@ namespace SSC {
     didLoopInit = true;
     Lock lock(loopMutex);
     uv_loop_init(&eventLoop);
+    // required by `uv_metrics_idle_time()` in `Core::Diagnostics`
+    uv_loop_configure(&eventLoop, UV_METRICS_IDLE_TIME);
     eventLoopAsync.data = (void *) this;
     uv_async_init(&eventLoop, &eventLoopAsync, [](uv_async_t *handle) {
       auto core = reinterpret_cast<SSC::Core  *>(handle->data);
-      while (true) {
-        Lock lock(core->loopMutex);
-        if (core->eventLoopDispatchQueue.size() == 0) break;
-        auto dispatch = core->eventLoopDispatchQueue.front();
-        if (dispatch != nullptr) dispatch();
-        core->eventLoopDispatchQueue.pop();
+      // callbacks run without `loopMutex` held so producers never wait on
+      // them, the drain is bounded so a busy producer can't starve the loop
+      core->eventLoopDispatchQueue.drain();
+
+      // `uv_stop()` is not thread safe, so `stopEventLoop()` signals the
+      // loop and it is stopped here, on the loop thread
+      if (!core->isLoopRunning) {
+        uv_stop(handle->loop);
+      } else if (!core->eventLoopDispatchQueue.empty()) {
+        uv_async_send(handle);
       }
     });
 
 #if defined(__linux__) && !defined(__ANDROID__)
-    GSource *source = g_source_new(&loopSourceFunctions, sizeof(UVSource));
-    UVSource *uvSource = (UVSource *) source;
-    uvSource->core = this;
-    uvSource->tag = g_source_add_unix_fd(
-      source,
-      uv_backend_fd(&eventLoop),
-      (GIOCondition) (G_IO_IN | G_IO_OUT | G_IO_ERR)
-    );
+    if (!options.eventLoopThread) {
+      GSource *source = g_source_new(&loopSourceFunctions, sizeof(UVSource));
+      UVSource *uvSource = (UVSource *) source;
+      uvSource->core = this;
+      uvSource->tag = g_source_add_unix_fd(
+        source,
+        uv_backend_fd(&eventLoop),
+        (GIOCondition) (G_IO_IN | G_IO_OUT | G_IO_ERR)
+      );
 
-    g_source_attach(source, nullptr);
+      g_source_attach(source, nullptr);
+    }
 #endif
+
+    initEventLoopShards();
   }
 
   uv_loop_t* Core::getEventLoop () {
@@ -1015,6 +1130,148 @@ namespace SSC {
     return &eventLoop;
   }
 
+  uv_loop_t* Core::getEventLoop (uint64_t id) {
+    initEventLoop();
+
+    if (eventLoopShards.size() == 0) {
+      return &eventLoop;
+    }
+
+    return &eventLoopShards[getEventLoopShardIndex(id)]->loop;
+  }
+
+  static inline uint64_t hashEventLoopShardId (uint64_t id) {
+    // splitmix64 finalizer, ids from JavaScript are not uniformly distributed
+    id = (id ^ (id >> 30)) * 0xbf58476d1ce4e5b9;
+    id = (id ^ (id >> 27)) * 0x94d049bb133111eb;
+    return id ^ (id >> 31);
+  }
+
+  static void setCurrentThreadAffinity (size_t cpu) {
+  #if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+  #elif defined(_WIN32)
+    if (cpu < sizeof(DWORD_PTR) * 8) {
+      SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR) 1 << cpu);
+    }
+  #endif
+    // macOS and iOS do not support pinning threads to a core
+  }
+
+  void Core::initEventLoopShards () {
+    static auto userConfig = getUserConfig();
+    size_t count = 0;
+
+    try {
+      count = std::stoul(userConfig["core_shards"]);
+    } catch (...) {
+      count = 0;
+    }
+
+    // a single loop is the default, sharding is opt-in
+    if (count <= 1 || eventLoopShards.size() > 0) {
+      return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      auto shard = std::make_unique<EventLoopShard>();
+      shard->index = i;
+      uv_loop_init(&shard->loop);
+      shard->async.data = (void *) shard.get();
+      uv_async_init(&shard->loop, &shard->async, [](uv_async_t *handle) {
+        auto shard = reinterpret_cast<EventLoopShard *>(handle->data);
+        shard->queue.drain();
+        if (!shard->queue.empty()) {
+          uv_async_send(handle);
+        }
+      });
+
+      eventLoopShards.push_back(std::move(shard));
+    }
+  }
+
+  void Core::startEventLoopShards () {
+    static auto userConfig = getUserConfig();
+    const auto affinity = userConfig["core_shards_affinity"] == "true";
+    const size_t cpus = std::max(1u, std::thread::hardware_concurrency());
+    std::lock_guard<std::mutex> lock(eventLoopShardsMutex);
+
+    for (auto& shard : eventLoopShards) {
+      if (shard->thread != nullptr) {
+        continue;
+      }
+
+      auto pointer = shard.get();
+      shard->thread = new std::thread([pointer, affinity, cpus]() {
+        if (affinity) {
+          setCurrentThreadAffinity(pointer->index % cpus);
+        }
+
+        // the async handle keeps the loop alive until `uv_stop()`
+        uv_run(&pointer->loop, UV_RUN_DEFAULT);
+      });
+    }
+  }
+
+  void Core::stopEventLoopShards () {
+    std::lock_guard<std::mutex> lock(eventLoopShardsMutex);
+
+    for (auto& shard : eventLoopShards) {
+      if (shard->thread == nullptr) {
+        continue;
+      }
+
+      auto loop = &shard->loop;
+      shard->queue.push([loop]() { uv_stop(loop); });
+      uv_async_send(&shard->async);
+
+      if (shard->thread->joinable()) {
+        shard->thread->join();
+      }
+
+      delete shard->thread;
+      shard->thread = nullptr;
+    }
+  }
+
+  void Core::closeEventLoopShards () {
+    stopEventLoopShards();
+    std::lock_guard<std::mutex> lock(eventLoopShardsMutex);
+
+    // the shard threads are joined, so the loops are closed on this thread
+    for (auto& shard : eventLoopShards) {
+    #if SSC_IO_URING
+      IOUring::release(&shard->loop);
+    #endif
+
+      uv_walk(&shard->loop, [](uv_handle_t* handle, void* arg) {
+        if (!uv_is_closing(handle)) {
+          uv_close(handle, nullptr);
+        }
+      }, nullptr);
+
+      uv_run(&shard->loop, UV_RUN_DEFAULT);
+      uv_loop_close(&shard->loop);
+    }
+
+    eventLoopShards.clear();
+  }
+
+  size_t Core::getEventLoopShardCount () {
+    return eventLoopShards.size();
+  }
+
+  size_t Core::getEventLoopShardIndex (uint64_t id) {
+    if (eventLoopShards.size() == 0) {
+      return 0;
+    }
+
+    return hashEventLoopShardId(id) % eventLoopShards.size();
+  }
+
   int Core::getEventLoopTimeout () {
     auto loop = getEventLoop();
     uv_update_time(loop);
@@ -1027,8 +1284,9 @@ namespace SSC {
 
   void Core::stopEventLoop() {
     isLoopRunning = false;
-    uv_stop(&eventLoop);
-  #if defined(__ANDROID__) || defined(_WIN32)
+    uv_async_send(&eventLoopAsync);
+    stopEventLoopShards();
+  #if !defined(__APPLE__)
     if (eventLoopThread != nullptr) {
       if (eventLoopThread->joinable()) {
         eventLoopThread->join();
@@ -1040,18 +1298,6 @@ namespace SSC {
   #endif
   }
 
-  void Core::sleepEventLoop (int64_t ms) {
-    if (ms > 0) {
-      auto timeout = getEventLoopTimeout();
-      ms = timeout > ms ? timeout : ms;
-      std::this_thread::sleep_for(std::chrono::milliseconds(ms));
-    }
-  }
-
-  void Core::sleepEventLoop () {
-    sleepEventLoop(getEventLoopTimeout());
-  }
-
   void Core::signalDispatchEventLoop () {
     initEventLoop();
     runEventLoop();
@@ -1059,23 +1305,32 @@ namespace SSC {
   }
 
   void Core::dispatchEventLoop (EventLoopDispatchCallback callback) {
-    {
-      Lock lock(loopMutex);
-      eventLoopDispatchQueue.push(callback);
+    diagnostics.sampleDispatch(callback);
+    eventLoopDispatchQueue.push(std::move(callback));
+    signalDispatchEventLoop();
+  }
+
+  void Core::dispatchEventLoop (uint64_t id, EventLoopDispatchCallback callback) {
+    initEventLoop();
+
+    if (eventLoopShards.size() == 0) {
+      return dispatchEventLoop(std::move(callback));
     }
 
-    signalDispatchEventLoop();
+    auto& shard = eventLoopShards[getEventLoopShardIndex(id)];
+    shard->queue.push(std::move(callback));
+    runEventLoop();
+    uv_async_send(&shard->async);
   }
 
   void pollEventLoop (Core *core) {
     auto loop = core->getEventLoop();
 
+    // `eventLoopAsync` is a referenced handle that keeps the loop alive, so
+    // `uv_run()` blocks in the backend until `uv_async_send()` (or other I/O)
+    // wakes it and only returns after `uv_stop()` from `stopEventLoop()`
     while (core->isLoopRunning) {
-      core->sleepEventLoop(EVENT_LOOP_POLL_TIMEOUT);
-
-      do {
-        uv_run(loop, UV_RUN_DEFAULT);
-      } while (core->isLoopRunning && core->isLoopAlive());
+      uv_run(loop, UV_RUN_DEFAULT);
     }
 
     core->isLoopRunning = false;
@@ -1089,6 +1344,7 @@ namespace SSC {
     isLoopRunning = true;
 
     initEventLoop();
+    startEventLoopShards();
     dispatchEventLoop([=, this]() {
       initTimers();
       startTimers();
@@ -1097,7 +1353,14 @@ namespace SSC {
 #if defined(__APPLE__)
     Lock lock(loopMutex);
     dispatch_async(eventLoopQueue, ^{ pollEventLoop(this); });
-#elif defined(__ANDROID__) || !defined(__linux__)
+#else
+  #if defined(__linux__) && !defined(__ANDROID__)
+    // the GTK main loop drives `eventLoop` through a `GSource` by default
+    if (!options.eventLoopThread) {
+      return;
+    }
+  #endif
+
     Lock lock(loopMutex);
     // clean up old thread if still running
     if (eventLoopThread != nullptr) {
@@ -1113,43 +1376,33 @@ namespace SSC {
 #endif
   }
 
-  static Timer releaseWeakDescriptors = {
-    .timeout = 256, // in milliseconds
-    .invoke = [](uv_timer_t *handle) {
-      auto core = reinterpret_cast<Core *>(handle->data);
-      Vector<uint64_t> ids;
-      String msg = "";
+  // closes the descriptors on the stale list, an empty list costs nothing
+  static void releaseWeakDescriptors (Core* core) {
+    Lock lock(core->fs.mutex);
+    auto& descriptors = core->fs.descriptors;
 
-      Lock lock(core->fs.mutex);
-      for (auto const &tuple : core->fs.descriptors) {
-        ids.push_back(tuple.first);
-      }
-
-      for (auto const id : ids) {
-        Lock lock(core->fs.mutex);
-        auto desc = core->fs.descriptors.at(id);
+    if (descriptors.getStaleCount() == 0) {
+      return;
+    }
 
-        if (desc == nullptr) {
-          core->fs.descriptors.erase(id);
-          continue;
-        }
+    for (const auto handle : descriptors.takeStale()) {
+      auto desc = descriptors.resolve(handle);
 
-        if (desc->isRetained() || !desc->isStale()) {
-          continue;
-        }
+      if (desc == nullptr || desc->isRetained() || !desc->isStale()) {
+        continue;
+      }
 
-        if (desc->isDirectory()) {
-          core->fs.closedir("", id, [](auto seq, auto msg, auto post) {});
-        } else if (desc->isFile()) {
-          core->fs.close("", id, [](auto seq, auto msg, auto post) {});
-        } else {
-          // free
-          core->fs.descriptors.erase(id);
-          delete desc;
-        }
+      if (desc->isDirectory()) {
+        core->fs.closedir("", desc->id, [](auto seq, auto msg, auto post) {});
+      } else if (desc->isFile()) {
+        core->fs.close("", desc->id, [](auto seq, auto msg, auto post) {});
+      } else {
+        // free
+        descriptors.remove(desc->id);
+        delete desc;
       }
     }
-  };
+  }
 
   void Core::initTimers () {
     if (didTimersInit) {
@@ -1157,46 +1410,21 @@ namespace SSC {
     }
 
     Lock lock(timersMutex);
-
-    auto loop = getEventLoop();
-
-    std::vector<Timer *> timersToInit = {
-      &releaseWeakDescriptors
-    };
-
-    for (const auto& timer : timersToInit) {
-      uv_timer_init(loop, &timer->handle);
-      timer->handle.data = (void *) this;
-    }
-
     didTimersInit = true;
   }
 
   void Core::startTimers () {
     Lock lock(timersMutex);
 
-    std::vector<Timer *> timersToStart = {
-      &releaseWeakDescriptors
-    };
+    timers.start();
 
-    for (const auto &timer : timersToStart) {
-      if (timer->started) {
-        uv_timer_again(&timer->handle);
-      } else {
-        timer->started = 0 == uv_timer_start(
-          &timer->handle,
-          timer->invoke,
-          timer->timeout,
-          !timer->repeated
-            ? 0
-            : timer->interval > 0
-              ? timer->interval
-              : timer->timeout
-        );
-      }
+    if (!timers.has(releaseWeakDescriptorsTimer)) {
+      releaseWeakDescriptorsTimer = timers.setInterval(256, [this]() {
+        releaseWeakDescriptors(this);
+      });
     }
 
-    didTimersStart = false;
+    didTimersStart = true;
   }
 
   void Core::stopTimers () {
@@ -1205,17 +1433,8 @@ namespace SSC {
     }
 
     Lock lock(timersMutex);
-
-    std::vector<Timer *> timersToStop = {
-      &releaseWeakDescriptors
-    };
-
-    for (const auto& timer : timersToStop) {
-      if (timer->started) {
-        uv_timer_stop(&timer->handle);
-      }
-    }
-
+    timers.stop();
     didTimersStart = false;
   }
+
 }
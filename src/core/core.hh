@@ -3,14 +3,21 @@
 
 #include "codec.hh"
 #include "config.hh"
+#include "coroutine.hh"
 #include "debug.hh"
+#include "descriptor_table.hh"
 #include "env.hh"
+#include "hash.hh"
 #include "ini.hh"
 #include "io.hh"
 #include "json.hh"
+#include "metadata_cache.hh"
 #include "platform.hh"
+#include "pool.hh"
 #include "preload.hh"
+#include "queue.hh"
 #include "string.hh"
+#include "timing_wheel.hh"
 #include "types.hh"
 #include "version.hh"
 
@@ -38,9 +45,18 @@
 #endif
 
 namespace SSC {
-  constexpr int EVENT_LOOP_POLL_TIMEOUT = 32; // in milliseconds
-
+  /**
+   * Returns a random 64 bit unsigned integer from a per-thread
+   * xoshiro256** generator seeded from the operating system.
+   */
   uint64_t rand64 ();
+
+  /**
+   * Returns a process unique, monotonically increasing 64 bit unsigned
+   * integer suitable for internal handles. Never returns `0`.
+   */
+  uint64_t monotonic64 ();
+
   void msleep (uint64_t ms);
 
 #if defined(_WIN32)
@@ -111,19 +127,29 @@ namespace SSC {
     String headers = "";
     std::shared_ptr<std::function<bool(const char*, const char*, bool)>> event_stream;
     std::shared_ptr<std::function<bool(const char*, size_t, bool)>> chunk_stream;
+    // `body` is from `BufferPool` instead of `new char[]`
+    bool pooled = false;
+    // the `Core::Timers` timeout that expires the post, see `putPost()`
+    uint64_t timer = 0;
   };
 
+  /**
+   * Frees `post.body` with the allocator it came from.
+   */
+  inline void freePostBody (const Post& post) {
+    if (post.body == nullptr) {
+      return;
+    }
+
+    if (post.pooled) {
+      BufferPool::release(post.body);
+    } else {
+      delete [] post.body;
+    }
+  }
+
   using Posts = std::map<uint64_t, Post>;
-  using EventLoopDispatchCallback = std::function<void()>;
-
-  struct Timer {
-    uv_timer_t handle;
-    bool repeated = false;
-    bool started = false;
-    uint64_t timeout = 0;
-    uint64_t interval = 0;
-    uv_timer_cb invoke;
-  };
+  using EventLoopDispatchCallback = Task;
 
   typedef enum {
     PEER_TYPE_NONE = 0,
@@ -356,9 +382,82 @@ namespace SSC {
           }
       };
 
+      /**
+       * Event loop health metrics: utilization from `uv_metrics_idle_time()`,
+       * iteration count, dispatch queue depth, `dispatchEventLoop()` latency
+       * and timer lag of the core loop and (on Linux) the GTK main loop.
+       * Sampling starts on first use of `loop()` and stays on until
+       * `stop()`, all durations are in milliseconds.
+       */
       class Diagnostics : public Module {
         public:
+          // interval between lag probes and between utilization samples
+          static constexpr uint64_t LAG_INTERVAL = 100;
+          static constexpr uint64_t SAMPLE_INTERVAL = 1000;
+          // one in this many `dispatchEventLoop()` calls is timed
+          static constexpr uint64_t DISPATCH_SAMPLE_RATE = 64;
+
+          struct Stat {
+            uint64_t count = 0;
+            double last = 0;
+            // exponentially weighted moving average
+            double mean = 0;
+            // largest value in the current and previous sample window
+            double max = 0;
+            double windowMax = 0;
+
+            void update (double value);
+            void roll ();
+            JSON::Object json () const;
+          };
+
+          struct LoopMetrics {
+            uint64_t iterations = 0;
+            double idleTime = 0;
+            double utilization = 0;
+            size_t queued = 0;
+            Stat dispatchLatency;
+            Stat lag;
+            Stat mainLoopLag;
+          };
+
           Diagnostics (auto core) : Module(core) {}
+          ~Diagnostics ();
+
+          void start ();
+          void stop ();
+          bool isRunning ();
+
+          LoopMetrics getLoopMetrics ();
+          void loop (const String seq, Module::Callback cb);
+          void descriptors (const String seq, Module::Callback cb);
+          void metadataCache (const String seq, Module::Callback cb);
+
+          /**
+           * Wraps one in `DISPATCH_SAMPLE_RATE` tasks to record the time
+           * between dispatch and execution. Called by `dispatchEventLoop()`.
+           */
+          void sampleDispatch (Task& task);
+          void updateMainLoopLag (double value);
+
+        private:
+          std::mutex mutex;
+          Atomic<bool> running = false;
+          Atomic<uint64_t> dispatched = 0;
+          Atomic<uint64_t> iterations = 0;
+          LoopMetrics metrics;
+
+          uv_check_t check;
+          uv_timer_t probe;
+          bool didInit = false;
+          uint64_t probeTime = 0;
+          uint64_t probes = 0;
+          uint64_t sampleTime = 0;
+          uint64_t sampleIdleTime = 0;
+          unsigned int mainLoopSource = 0;
+          uint64_t mainLoopProbeTime = 0;
+
+          void sample ();
       };
 
       class DNS : public Module {
@@ -383,14 +482,33 @@ namespace SSC {
         public:
           FS (auto core) : Module(core) {}
 
-          struct Descriptor {
+          // corresponds to `DirectoryHandle.MAX_BUFFER_SIZE`
+          static constexpr size_t MAX_DIRENTS = 256;
+          // corresponds to `DirectoryHandle.MAX_PLUS_ENTRIES`
+          static constexpr size_t MAX_READDIR_PLUS_ENTRIES = 8192;
+          // the fixed part of a binary `readdirPlus()` record
+          static constexpr size_t READDIR_PLUS_RECORD_SIZE = 4 + 20 * 8;
+          // the largest single read or write, `uv_buf_t` lengths are 32 bit
+          // on some platforms
+          static constexpr size_t MAX_IO_SIZE = 1024 * 1024 * 1024;
+
+          struct Descriptor : DescriptorTableEntry {
             uint64_t id;
             std::atomic<bool> retained = false;
             std::atomic<bool> stale = false;
+            // the window that opened the descriptor, only its page loads
+            // collect it
+            int index = -1;
             Mutex mutex;
             uv_dir_t *dir = nullptr;
             uv_file fd = 0;
+            // the path given to `open()` or `opendir()`, entries are
+            // stat'ed by path where there is no `fstatat(2)`
+            String path = "";
             Core *core;
+            // entries for `uv_fs_readdir()`, allocated on the first read of
+            // a directory and reused for the rest of its reads
+            std::unique_ptr<uv_dirent_t[]> dirents = nullptr;
 
             Descriptor (Core *core, uint64_t id);
             bool isDirectory ();
@@ -399,23 +517,35 @@ namespace SSC {
             bool isStale ();
           };
 
+          /**
+           * Contexts are recycled through a per-thread free-list, they are
+           * created and freed on the event loop thread of the operation.
+           */
           struct RequestContext : Module::RequestContext {
+            using Pool = ThreadLocalPool<RequestContext>;
+
             uint64_t id;
             Descriptor *desc = nullptr;
             uv_fs_t req;
             uv_buf_t buf;
-            // 256 which corresponds to DirectoryHandle.MAX_BUFFER_SIZE
-            uv_dirent_t dirents[256];
             int offset = 0;
             int result = 0;
 
+            static void* operator new (size_t size) {
+              return Pool::allocate(size);
+            }
+
+            static void operator delete (void* pointer, size_t size) {
+              Pool::release(pointer, size);
+            }
+
             RequestContext () = default;
             RequestContext (Descriptor *desc)
               : RequestContext(desc, "", nullptr) {}
             RequestContext (String seq, Callback cb)
               : RequestContext(nullptr, seq, cb) {}
             RequestContext (Descriptor *desc, String seq, Callback cb) {
-              this->id = SSC::rand64();
+              this->id = SSC::monotonic64();
               this->cb = cb;
               this->seq = seq;
               this->desc = desc;
@@ -436,13 +566,60 @@ namespace SSC {
           std::map<uint64_t, FileSystemWatcher*> watchers;
         #endif
 
-          std::map<uint64_t, Descriptor*> descriptors;
+          /**
+           * Options for `walk()`. Globs without a `/` match an entry's name,
+           * others match its path relative to the walked directory.
+           */
+          struct WalkOptions {
+            // entries are reported if they match one, all if empty
+            Vector<String> include;
+            // entries to skip, excluded directories are not entered
+            Vector<String> exclude;
+            // the deepest level reported, `1` for the entries of the
+            // walked directory only, `-1` for no limit
+            int depth = -1;
+            // enter symbolic links to directories and stat their targets
+            bool followSymlinks = false;
+            bool withStats = false;
+            // entries per `fs.walk` event
+            size_t batchSize = 256;
+          };
+
+          struct Walk;
+
+          // entries between `fs.rm` and `fs.cp` progress events
+          static constexpr size_t TREE_PROGRESS_ENTRIES = 256;
+
+          struct CopyOptions {
+            // copy directories and their contents
+            bool recursive = false;
+            // replace existing files, otherwise they are skipped
+            bool force = true;
+            // fail on an existing file when `force` is not set
+            bool errorOnExist = false;
+            // copy what symbolic links point to instead of the links
+            bool dereference = false;
+          };
+
+          // guarded by `mutex`
+          DescriptorTable<Descriptor> descriptors;
+          std::map<uint64_t, std::shared_ptr<Walk>> walks;
           Mutex mutex;
 
+          std::unique_ptr<MetadataCache> metadataCache = nullptr;
+          std::once_flag metadataCacheFlag;
+
           Descriptor * getDescriptor (uint64_t id);
           void removeDescriptor (uint64_t id);
           bool hasDescriptor (uint64_t id);
 
+          /**
+           * The cache used by `stat()`, `lstat()` and `access()`, created
+           * on first use. `nullptr` unless `[core] fs_metadata_cache` is
+           * enabled.
+           */
+          MetadataCache* getMetadataCache ();
+
           void constants (const String seq, Module::Callback cb);
           void access (
             const String seq,
@@ -478,6 +655,21 @@ namespace SSC {
             int flags,
             Module::Callback cb
           );
+          /**
+           * Copies `src` to `dest` on a worker, files are cloned where the
+           * file system supports it (`FICLONE`, `clonefile(2)`) and copied
+           * in the kernel otherwise. Progress and errors are emitted as
+           * `fs.cp` events for `id` every `TREE_PROGRESS_ENTRIES` entries,
+           * an entry that fails doesn't stop the copy.
+           */
+          void cp (
+            const String seq,
+            uint64_t id,
+            const String src,
+            const String dest,
+            const CopyOptions options,
+            Module::Callback cb
+          );
           void closedir (const String seq, uint64_t id, Module::Callback cb);
           void closeOpenDescriptor (
             const String seq,
@@ -491,6 +683,36 @@ namespace SSC {
             Module::Callback cb
           );
           void fstat (const String seq, uint64_t id, Module::Callback cb);
+          /**
+           * Flushes the file's data, and its metadata unless `datasync` is
+           * set, to the storage device.
+           */
+          void fsync (
+            const String seq,
+            uint64_t id,
+            bool datasync,
+            Module::Callback cb
+          );
+          /**
+           * Hashes the contents of `path` on a worker, replying with the
+           * hex digest and the number of bytes hashed.
+           */
+          void hash (
+            const String seq,
+            const String path,
+            Hasher::Algorithm algorithm,
+            Module::Callback cb
+          );
+          /**
+           * Hashes each of `paths` on the workers in parallel, replying
+           * once with a digest or an error for each path, in order.
+           */
+          void hash (
+            const String seq,
+            const Vector<String> paths,
+            Hasher::Algorithm algorithm,
+            Module::Callback cb
+          );
           void getOpenDescriptors (const String seq, Module::Callback cb);
           void lstat (const String seq, const String path, Module::Callback cb);
 					void link (
@@ -523,9 +745,20 @@ namespace SSC {
             const String path,
             Module::Callback cb
           );
+          /**
+           * Opens, stats, reads and closes the file at `path` in a single
+           * operation on the event loop and returns its bytes as a post.
+           */
+          void readFile (
+            const String seq,
+            const String path,
+            int flags,
+            Module::Callback cb
+          );
           void open (
             const String seq,
             uint64_t id,
+            int index,
             const String path,
             int flags,
             int mode,
@@ -534,6 +767,7 @@ namespace SSC {
           void opendir (
             const String seq,
             uint64_t id,
+            int index,
             const String path,
             Module::Callback cb
           );
@@ -544,12 +778,44 @@ namespace SSC {
             size_t offset,
             Module::Callback cb
           );
+          /**
+           * Reads into consecutive segments of `sizes` bytes from `offset`
+           * with a single vectored read. The post body holds the segments
+           * back to back.
+           */
+          void readv (
+            const String seq,
+            uint64_t id,
+            const Vector<size_t> sizes,
+            int64_t offset,
+            Module::Callback cb
+          );
           void readdir (
             const String seq,
             uint64_t id,
             size_t entries,
             Module::Callback cb
           );
+          /**
+           * Reads up to `entries` entries of an open directory with the
+           * `lstat(2)` fields of each, taken with `fstatat(2)` relative to
+           * the directory. With `binary`, entries are packed into the post
+           * body instead of JSON, one record each of:
+           *
+           *   uint16 name length, uint8 type, uint8 `1` if stats are set,
+           *   uint64 dev, mode, nlink, uid, gid, rdev, ino, size, blksize,
+           *   blocks, flags, gen, int64 seconds and nanoseconds of atim,
+           *   mtim, ctim and birthtim, then the UTF-8 name
+           *
+           * in little endian byte order.
+           */
+          void readdirPlus (
+            const String seq,
+            uint64_t id,
+            size_t entries,
+            bool binary,
+            Module::Callback cb
+          );
           void retainOpenDescriptor (
             const String seq,
             uint64_t id,
@@ -566,6 +832,19 @@ namespace SSC {
             const String path,
             Module::Callback cb
           );
+          /**
+           * Removes `path`, and everything in it with `recursive`, on a
+           * worker. A missing `path` is not an error with `force`. Progress
+           * is reported like `cp()` as `fs.rm` events.
+           */
+          void rm (
+            const String seq,
+            uint64_t id,
+            const String path,
+            bool recursive,
+            bool force,
+            Module::Callback cb
+          );
           void stat (
             const String seq,
             const String path,
@@ -581,6 +860,36 @@ namespace SSC {
             const String path,
             Module::Callback cb
           );
+          /**
+           * Walks the tree at `path` with each directory read on the worker
+           * pool. Entries are emitted in batches as `fs.walk` events for `id`
+           * and `cb` is called when the walk completes or is stopped.
+           */
+          void walk (
+            const String seq,
+            uint64_t id,
+            const String path,
+            const WalkOptions options,
+            Module::Callback cb
+          );
+          /**
+           * Replies with a chunked response (`Post::chunk_stream`) of the
+           * bytes of `id` from `offset` to `end` (exclusive, `-1` for the
+           * end of the file). Up to `window` reads of `chunkSize` bytes are
+           * kept in flight ahead of the response and chunks are sent in
+           * order from the loop as they complete. The response has a
+           * `x-fs-stream-length` header and ends early on a read error.
+           */
+          void stream (
+            const String seq,
+            uint64_t id,
+            uint64_t offset,
+            int64_t end,
+            size_t chunkSize,
+            size_t window,
+            Module::Callback cb
+          );
+          void stopWalk (const String seq, uint64_t id, Module::Callback cb);
           void watch (
             const String seq,
             uint64_t id,
@@ -595,6 +904,32 @@ namespace SSC {
             size_t offset,
             Module::Callback cb
           );
+          /**
+           * Writes `bytes`, split into consecutive segments of `sizes` bytes,
+           * at `offset` with a single vectored write.
+           */
+          void writev (
+            const String seq,
+            uint64_t id,
+            char *bytes,
+            const Vector<size_t> sizes,
+            int64_t offset,
+            Module::Callback cb
+          );
+          /**
+           * Opens the file at `path` with `flags` and `mode`, writes all of
+           * `bytes` and closes it in a single operation on the event loop.
+           * Writes go to the end of the file when `flags` has `O_APPEND`.
+           */
+          void writeFile (
+            const String seq,
+            const String path,
+            char *bytes,
+            size_t size,
+            int flags,
+            int mode,
+            Module::Callback cb
+          );
       };
 
       class OS : public Module {
@@ -642,6 +977,7 @@ namespace SSC {
           Platform (auto core) : Module(core) {}
           void event (
             const String seq,
+            int index,
             const String event,
             const String data,
             Module::Callback cb
@@ -709,12 +1045,147 @@ namespace SSC {
           );
       };
 
+      /**
+       * A work-stealing pool of CPU threads for offloading work that should
+       * not run on the event loop or the main thread. Each thread owns a
+       * deque, pops its own work from the back and steals from the front of
+       * other threads' deques when idle. Threads are started lazily on first
+       * use. The count comes from `[core] workers` in `socket.ini` and
+       * defaults to one thread per CPU core.
+       */
+      class Workers : public Module {
+        public:
+          struct Stats {
+            size_t threads = 0;
+            size_t queued = 0;
+            size_t active = 0;
+            uint64_t submitted = 0;
+            uint64_t completed = 0;
+            uint64_t stolen = 0;
+          };
+
+          Workers (auto core) : Module(core) {}
+          ~Workers ();
+
+          /**
+           * Starts `threads` workers (`0` for the configured or default
+           * count). Calling this is optional, `dispatch()` starts the pool.
+           */
+          void start (size_t threads = 0);
+          void stop ();
+          bool isRunning ();
+
+          /**
+           * Runs `task` on a worker thread.
+           */
+          void dispatch (Task task);
+
+          /**
+           * Runs `work` on a worker thread and then calls `done` with its
+           * result on the core event loop.
+           */
+          template <typename Work, typename Done>
+          void dispatch (Work work, Done done) {
+            this->dispatch(Task([
+              this,
+              work = std::move(work),
+              done = std::move(done)
+            ]() mutable {
+              auto result = work();
+              this->core->dispatchEventLoop(Task([
+                done = std::move(done),
+                result = std::move(result)
+              ]() mutable {
+                done(std::move(result));
+              }));
+            }));
+          }
+
+          size_t size ();
+          Stats stats ();
+
+        private:
+          struct Worker {
+            std::mutex mutex;
+            std::condition_variable condition;
+            std::deque<Task> tasks;
+            bool isSleeping = false; // guarded by `mutex`
+            Atomic<uint64_t> completed = 0;
+          };
+
+          Vector<std::unique_ptr<Worker>> queues;
+          Vector<Thread> threads;
+          // held while starting or stopping, until the threads are joined
+          std::mutex mutex;
+          // shared while dispatching, exclusive while `running` and
+          // `queues` change
+          std::shared_mutex state;
+          Atomic<bool> running = false;
+          Atomic<size_t> queued = 0;
+          Atomic<size_t> sleeping = 0;
+          Atomic<size_t> active = 0;
+          Atomic<uint64_t> submitted = 0;
+          Atomic<uint64_t> stolen = 0;
+          Atomic<size_t> next = 0;
+
+          void wake (size_t index);
+          void run (size_t index);
+          bool pop (size_t index, Task& task);
+      };
+
+      /**
+       * Timeouts and intervals on the core event loop, kept in a hierarchical
+       * timing wheel (see `timing_wheel.hh`) driven by a single `uv_timer_t`.
+       * Deadlines are rounded up to `RESOLUTION` milliseconds, so timers that
+       * are due close together fire in the same pass. Callbacks are called
+       * on the event loop thread. Timers can be scheduled from any thread.
+       */
+      class Timers : public Module {
+        public:
+          using ID = TimingWheel::ID;
+          using Callback = TimingWheel::Callback;
+
+          // in milliseconds
+          static constexpr uint64_t RESOLUTION = 8;
+
+          Timers (auto core) : Module(core) {}
+          ~Timers ();
+
+          ID setTimeout (uint64_t timeout, const Callback& callback);
+          ID setInterval (uint64_t interval, const Callback& callback);
+          bool clearTimeout (ID id);
+          bool clearInterval (ID id);
+          bool has (ID id);
+          size_t size ();
+
+          /**
+           * Resumes or pauses the underlying `uv_timer_t`. Timers that come
+           * due while paused fire when resumed. Timers start resumed.
+           */
+          void start ();
+          void stop ();
+
+        private:
+          Mutex mutex;
+          TimingWheel wheel;
+          uv_timer_t handle;
+          bool didInit = false;
+          bool running = true;
+          uint64_t armed = 0;
+
+          ID schedule (uint64_t timeout, uint64_t interval, const Callback& callback);
+          void advance ();
+          void arm ();
+      };
+
       Diagnostics diagnostics;
       DNS dns;
       FS fs;
       OS os;
       Platform platform;
+      Timers timers;
       UDP udp;
+      Workers workers;
 
       std::shared_ptr<Posts> posts;
       std::map<uint64_t, Peer*> peers;
@@ -727,12 +1198,30 @@ namespace SSC {
       std::atomic<bool> didLoopInit = false;
       std::atomic<bool> didTimersInit = false;
       std::atomic<bool> didTimersStart = false;
+      Timers::ID releaseWeakDescriptorsTimer = 0;
 
       std::atomic<bool> isLoopRunning = false;
 
       uv_loop_t eventLoop;
       uv_async_t eventLoopAsync;
-      std::queue<EventLoopDispatchCallback> eventLoopDispatchQueue;
+      DispatchQueue eventLoopDispatchQueue;
+
+      /**
+       * An additional event loop with its own thread used when sharding is
+       * enabled with `[core] shards = N` in `socket.ini`. Peers and
+       * descriptors are assigned to a shard by a hash of their id.
+       */
+      struct EventLoopShard {
+        size_t index = 0;
+        uv_loop_t loop;
+        uv_async_t async;
+        DispatchQueue queue;
+        std::thread *thread = nullptr;
+      };
+
+      Vector<std::unique_ptr<EventLoopShard>> eventLoopShards;
+      // held while shard threads are started or stopped
+      std::mutex eventLoopShardsMutex;
 
 #if defined(__APPLE__)
       dispatch_queue_attr_t eventLoopQueueAttrs = dispatch_queue_attr_make_with_qos_class(
@@ -749,18 +1238,35 @@ namespace SSC {
       std::thread *eventLoopThread = nullptr;
 #endif
 
-      Core () :
+      struct Options {
+        // Linux only, run `eventLoop` on a thread of its own with
+        // `pollEventLoop()` instead of driving it from the GTK main loop
+        bool eventLoopThread = false;
+      };
+
+      Options options;
+
+      // options from `socket.ini`
+      static Options getDefaultOptions ();
+
+      Core () : Core(getDefaultOptions()) {}
+      Core (const Options& options) :
         diagnostics(this),
         dns(this),
         fs(this),
         os(this),
         platform(this),
-        udp(this)
+        timers(this),
+        udp(this),
+        workers(this)
       {
+        this->options = options;
         this->posts = std::shared_ptr<Posts>(new Posts());
         initEventLoop();
       }
 
+      ~Core ();
+
       void resumeAllPeers ();
       void pauseAllPeers ();
       bool hasPeer (uint64_t id);
@@ -770,6 +1276,9 @@ namespace SSC {
       Peer* createPeer (peer_type_t type, uint64_t id);
       Peer* createPeer (peer_type_t type, uint64_t id, bool isEphemeral);
 
+      // milliseconds a post waits to be consumed before it is freed
+      static constexpr uint64_t POST_TTL = 32 * 1024;
+
       Post getPost (uint64_t id);
       bool hasPost (uint64_t id);
       bool hasPostBody (const char* body);
@@ -786,15 +1295,23 @@ namespace SSC {
 
       // loop
       uv_loop_t* getEventLoop ();
+      uv_loop_t* getEventLoop (uint64_t id);
       int getEventLoopTimeout ();
       bool isLoopAlive ();
       void initEventLoop ();
       void runEventLoop ();
       void stopEventLoop ();
       void dispatchEventLoop (EventLoopDispatchCallback dispatch);
+      void dispatchEventLoop (uint64_t id, EventLoopDispatchCallback dispatch);
       void signalDispatchEventLoop ();
-      void sleepEventLoop (int64_t ms);
-      void sleepEventLoop ();
+
+      // loop shards
+      void initEventLoopShards ();
+      void startEventLoopShards ();
+      void stopEventLoopShards ();
+      void closeEventLoopShards ();
+      size_t getEventLoopShardCount ();
+      size_t getEventLoopShardIndex (uint64_t id);
   };
 
   String createJavaScript (const String& name, const String& source);
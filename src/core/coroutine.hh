@@ -0,0 +1,442 @@
+#ifndef SSC_CORE_COROUTINE_H
+#define SSC_CORE_COROUTINE_H
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+
+#include "platform.hh"
+#include "pool.hh"
+#include "types.hh"
+#include "uring.hh"
+
+namespace SSC {
+  /**
+   * A per-thread free-list of fixed size classes for coroutine frames. Core
+   * coroutines are created and destroyed on the event loop thread that owns
+   * them, so blocks are recycled without locking. Blocks larger than the
+   * biggest class use the global allocator.
+   */
+  using CoroutineFramePool = ThreadLocalBlockPool<256, 16, 64, struct CoroutineFrame>;
+
+  template <typename T> class Async;
+
+  namespace detail {
+    struct AsyncPromiseBase {
+      std::coroutine_handle<> continuation = nullptr;
+      std::exception_ptr exception = nullptr;
+      bool detached = false;
+
+      static void* operator new (size_t size) {
+        return CoroutineFramePool::allocate(size);
+      }
+
+      static void operator delete (void* pointer) {
+        CoroutineFramePool::release(pointer);
+      }
+
+      std::suspend_always initial_suspend () noexcept {
+        return {};
+      }
+
+      struct FinalAwaiter {
+        bool await_ready () noexcept {
+          return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend (std::coroutine_handle<Promise> handle) noexcept {
+          auto& promise = handle.promise();
+          auto continuation = promise.continuation;
+
+          if (promise.detached) {
+            handle.destroy();
+          }
+
+          if (continuation != nullptr) {
+            return continuation;
+          }
+
+          return std::noop_coroutine();
+        }
+
+        void await_resume () noexcept {}
+      };
+
+      FinalAwaiter final_suspend () noexcept {
+        return {};
+      }
+
+      void unhandled_exception () {
+        this->exception = std::current_exception();
+      }
+    };
+
+    template <typename T>
+    struct AsyncPromise : AsyncPromiseBase {
+      std::optional<T> value;
+
+      Async<T> get_return_object ();
+
+      void return_value (T value) {
+        this->value = std::move(value);
+      }
+
+      T result () {
+        if (this->exception != nullptr) {
+          std::rethrow_exception(this->exception);
+        }
+
+        return std::move(*this->value);
+      }
+    };
+
+    template <>
+    struct AsyncPromise<void> : AsyncPromiseBase {
+      Async<void> get_return_object ();
+
+      void return_void () {}
+
+      void result () {
+        if (this->exception != nullptr) {
+          std::rethrow_exception(this->exception);
+        }
+      }
+    };
+  }
+
+  /**
+   * A lazily started coroutine task. `co_await` an `Async<T>` from another
+   * coroutine to run it and receive its result, or call `start()` to run it
+   * detached, in which case its frame is freed when it completes. Work that
+   * awaits libuv requests resumes on the loop that completed the request.
+   */
+  template <typename T = void>
+  class Async {
+    public:
+      using promise_type = detail::AsyncPromise<T>;
+      using Handle = std::coroutine_handle<promise_type>;
+
+      Async () = default;
+      Async (Handle handle) : handle(handle) {}
+      Async (const Async&) = delete;
+      Async (Async&& task) noexcept : handle(task.handle) {
+        task.handle = nullptr;
+      }
+
+      Async& operator = (const Async&) = delete;
+      Async& operator = (Async&& task) noexcept {
+        if (this != &task) {
+          if (this->handle) {
+            this->handle.destroy();
+          }
+
+          this->handle = task.handle;
+          task.handle = nullptr;
+        }
+
+        return *this;
+      }
+
+      ~Async () {
+        if (this->handle) {
+          this->handle.destroy();
+        }
+      }
+
+      /**
+       * Runs the task without an awaiter. The frame owns itself from here.
+       */
+      void start () {
+        if (!this->handle) {
+          return;
+        }
+
+        auto handle = this->handle;
+        this->handle = nullptr;
+        handle.promise().detached = true;
+        handle.resume();
+      }
+
+      bool await_ready () const noexcept {
+        return !this->handle || this->handle.done();
+      }
+
+      std::coroutine_handle<> await_suspend (std::coroutine_handle<> continuation) noexcept {
+        this->handle.promise().continuation = continuation;
+        return this->handle;
+      }
+
+      T await_resume () {
+        return this->handle.promise().result();
+      }
+
+    private:
+      Handle handle = nullptr;
+  };
+
+  namespace detail {
+    template <typename T>
+    inline Async<T> AsyncPromise<T>::get_return_object () {
+      return Async<T>(std::coroutine_handle<AsyncPromise<T>>::from_promise(*this));
+    }
+
+    inline Async<void> AsyncPromise<void>::get_return_object () {
+      return Async<void>(std::coroutine_handle<AsyncPromise<void>>::from_promise(*this));
+    }
+  }
+
+  /**
+   * Suspends the awaiting coroutine and resumes it from a task given to
+   * `dispatch`, such as `Core::dispatchEventLoop()`, to hop onto a loop.
+   */
+  template <typename Dispatch>
+  struct DispatchAwaiter {
+    Dispatch dispatch;
+
+    bool await_ready () const noexcept {
+      return false;
+    }
+
+    void await_suspend (std::coroutine_handle<> handle) {
+      this->dispatch(Task([handle]() { handle.resume(); }));
+    }
+
+    void await_resume () const noexcept {}
+  };
+
+  /**
+   * The settled result of an awaited `uv_fs_t` request. `result` is the
+   * libuv result (negative on error), `stat` holds the stat buffer for
+   * stat requests, `path` the resolved path for `realpath`/`readlink` and
+   * `entries` the `{type, name}` pairs read by `readdir`.
+   */
+  struct UVFSResult {
+    ssize_t result = 0;
+    uv_stat_t stat;
+    String path = "";
+    Vector<std::pair<int, String>> entries;
+
+    bool ok () const {
+      return this->result >= 0;
+    }
+  };
+
+  /**
+   * Awaits one `uv_fs_*` request. The request lives in the awaiting
+   * coroutine's frame, so it comes from the same pooled allocation. `submit`
+   * issues the request with the given callback and returns its status.
+   */
+  template <typename Submit>
+  struct UVFSAwaiter {
+    Submit submit;
+    uv_fs_t req;
+    std::coroutine_handle<> handle = nullptr;
+    UVFSResult value;
+
+    UVFSAwaiter (Submit submit) : submit(std::move(submit)) {}
+
+    UVFSAwaiter (const UVFSAwaiter&) = delete;
+
+    bool await_ready () const noexcept {
+      return false;
+    }
+
+    bool await_suspend (std::coroutine_handle<> handle) {
+      this->handle = handle;
+      this->req.data = this;
+      const auto err = this->submit(&this->req, [](uv_fs_t* req) {
+        auto awaiter = static_cast<UVFSAwaiter*>(req->data);
+        awaiter->settle(uv_fs_get_result(req));
+        awaiter->handle.resume();
+      });
+
+      // submission failed synchronously, continue without suspending
+      if (err < 0) {
+        this->value.result = err;
+        uv_fs_req_cleanup(&this->req);
+        return false;
+      }
+
+      return true;
+    }
+
+    UVFSResult await_resume () {
+      return std::move(this->value);
+    }
+
+    void settle (ssize_t result) {
+      this->value.result = result;
+
+      if (result >= 0) {
+        switch (uv_fs_get_type(&this->req)) {
+          case UV_FS_STAT:
+          case UV_FS_LSTAT:
+          case UV_FS_FSTAT:
+            this->value.stat = *uv_fs_get_statbuf(&this->req);
+            break;
+          case UV_FS_REALPATH:
+          case UV_FS_READLINK:
+            this->value.path = String((const char*) uv_fs_get_ptr(&this->req));
+            break;
+          case UV_FS_READDIR: {
+            // names are freed with the request, so they are copied out
+            auto dir = (uv_dir_t*) uv_fs_get_ptr(&this->req);
+            for (ssize_t i = 0; i < result; ++i) {
+              this->value.entries.emplace_back(dir->dirents[i].type, dir->dirents[i].name);
+            }
+            break;
+          }
+          default:
+            break;
+        }
+      }
+
+      uv_fs_req_cleanup(&this->req);
+    }
+  };
+
+  // submits through `uring` when there is one and returns its status,
+  // unless it refused the request
+#if SSC_IO_URING
+  #define URING_SUBMIT(call)                                                   \
+    if (uring != nullptr) {                                                    \
+      const auto err = uring->call;                                            \
+      if (err != UV_ENOSYS) {                                                  \
+        return err;                                                            \
+      }                                                                        \
+    }
+#else
+  #define URING_SUBMIT(call)
+#endif
+
+  /**
+   * Awaitable wrappers over `uv_fs_*` requests on a loop, for example
+   * `auto result = co_await UVFS(loop).open(path, O_RDONLY, 0);`
+   *
+   * On Linux, requests that `io_uring` supports go through `uring` when one
+   * is given and fall back to libuv when it refuses them.
+   */
+  class UVFS {
+    public:
+      uv_loop_t* loop = nullptr;
+    #if SSC_IO_URING
+      IOUring* uring = nullptr;
+    #endif
+
+      UVFS (uv_loop_t* loop) : loop(loop) {}
+    #if SSC_IO_URING
+      UVFS (uv_loop_t* loop, IOUring* uring) : loop(loop), uring(uring) {}
+    #endif
+
+      auto access (const String& path, int mode) {
+        return this->request([=, loop = this->loop](uv_fs_t* req, uv_fs_cb cb) {
+          return uv_fs_access(loop, req, path.c_str(), mode, cb);
+        });
+      }
+
+      auto mkdir (const String& path, int mode) {
+        return this->request([=, loop = this->loop](uv_fs_t* req, uv_fs_cb cb) {
+          return uv_fs_mkdir(loop, req, path.c_str(), mode, cb);
+        });
+      }
+
+      auto open (const String& path, int flags, int mode) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(open(req, path.c_str(), flags, mode, cb));
+          return uv_fs_open(loop, req, path.c_str(), flags, mode, cb);
+        });
+      }
+
+      auto close (uv_file fd) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(close(req, fd, cb));
+          return uv_fs_close(loop, req, fd, cb);
+        });
+      }
+
+      auto read (uv_file fd, uv_buf_t buffer, int64_t offset) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(read(req, fd, &buffer, 1, offset, cb));
+          return uv_fs_read(loop, req, fd, &buffer, 1, offset, cb);
+        });
+      }
+
+      auto write (uv_file fd, uv_buf_t buffer, int64_t offset) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(write(req, fd, &buffer, 1, offset, cb));
+          return uv_fs_write(loop, req, fd, &buffer, 1, offset, cb);
+        });
+      }
+
+      // vectored forms, a single `preadv(2)`/`pwritev(2)` over `buffers`
+      auto read (uv_file fd, Vector<uv_buf_t> buffers, int64_t offset) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          const auto count = (unsigned int) buffers.size();
+          URING_SUBMIT(read(req, fd, buffers.data(), count, offset, cb));
+          return uv_fs_read(loop, req, fd, buffers.data(), count, offset, cb);
+        });
+      }
+
+      auto write (uv_file fd, Vector<uv_buf_t> buffers, int64_t offset) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          const auto count = (unsigned int) buffers.size();
+          URING_SUBMIT(write(req, fd, buffers.data(), count, offset, cb));
+          return uv_fs_write(loop, req, fd, buffers.data(), count, offset, cb);
+        });
+      }
+
+      auto stat (const String& path) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(stat(req, path.c_str(), cb));
+          return uv_fs_stat(loop, req, path.c_str(), cb);
+        });
+      }
+
+      auto lstat (const String& path) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(lstat(req, path.c_str(), cb));
+          return uv_fs_lstat(loop, req, path.c_str(), cb);
+        });
+      }
+
+      auto fstat (uv_file fd) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(fstat(req, fd, cb));
+          return uv_fs_fstat(loop, req, fd, cb);
+        });
+      }
+
+      // reads up to `dir->nentries` entries into `dir->dirents`
+      auto readdir (uv_dir_t* dir) {
+        return this->request([=, loop = this->loop](uv_fs_t* req, uv_fs_cb cb) {
+          return uv_fs_readdir(loop, req, dir, cb);
+        });
+      }
+
+      auto fsync (uv_file fd) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(fsync(req, fd, cb));
+          return uv_fs_fsync(loop, req, fd, cb);
+        });
+      }
+
+      auto fdatasync (uv_file fd) {
+        return this->request([=, this](uv_fs_t* req, uv_fs_cb cb) {
+          URING_SUBMIT(fdatasync(req, fd, cb));
+          return uv_fs_fdatasync(loop, req, fd, cb);
+        });
+      }
+
+    private:
+      template <typename Submit>
+      static UVFSAwaiter<Submit> request (Submit submit) {
+        return UVFSAwaiter<Submit>(std::move(submit));
+      }
+  };
+
+  #undef URING_SUBMIT
+}
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef SSC_CORE_DESCRIPTOR_TABLE_H
+#define SSC_CORE_DESCRIPTOR_TABLE_H
+
+#include <chrono>
+#include <unordered_map>
+
+#include "types.hh"
+
+namespace SSC {
+  /**
+   * The part of a value that a `DescriptorTable` owns. Values stored in a
+   * table must derive from it.
+   */
+  struct DescriptorTableEntry {
+    // the slot and generation of the value, `0` when not in a table
+    uint64_t handle = 0;
+    // milliseconds on a monotonic clock when the value was inserted
+    uint64_t insertedAt = 0;
+    // bytes read or written through the descriptor
+    Atomic<uint64_t> bytes = 0;
+
+    // intrusive links of the table's stale list
+    DescriptorTableEntry* stalePrev = nullptr;
+    DescriptorTableEntry* staleNext = nullptr;
+    bool isStaleListed = false;
+  };
+
+  /**
+   * A table of descriptors keyed by the (random) ids the JavaScript side
+   * gives them. Values live in a dense slot array, slots are reused through
+   * a free-list and carry a generation that is bumped on removal, so a
+   * `Handle` to a removed value never resolves to the value that reuses its
+   * slot. Values marked stale are kept on an intrusive list, which lets a
+   * collector visit only the candidates instead of the whole table. This
+   * class is not thread safe.
+   */
+  template <typename T>
+  class DescriptorTable {
+    public:
+      // the generation in the high 32 bits, the slot index + 1 in the low
+      using Handle = uint64_t;
+
+      struct Metrics {
+        size_t count = 0;
+        size_t stale = 0;
+        // slots allocated, used and free
+        size_t capacity = 0;
+        // bytes read or written through the open descriptors
+        uint64_t bytes = 0;
+        // age in milliseconds of the oldest and an average descriptor
+        uint64_t oldestAge = 0;
+        uint64_t meanAge = 0;
+      };
+
+      DescriptorTable () = default;
+      DescriptorTable (const DescriptorTable&) = delete;
+      DescriptorTable& operator = (const DescriptorTable&) = delete;
+
+      static uint64_t now () {
+        using namespace std::chrono;
+        return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+      }
+
+      /**
+       * Inserts `value` for `id`, replacing (and returning) the value already
+       * stored for it, if any. The replaced value is no longer in the table.
+       */
+      T* insert (uint64_t id, T* value) {
+        if (value == nullptr) {
+          return nullptr;
+        }
+
+        auto previous = this->remove(id);
+        uint32_t index = 0;
+
+        if (this->free.size() > 0) {
+          index = this->free.back();
+          this->free.pop_back();
+        } else {
+          index = (uint32_t) this->slots.size();
+          this->slots.push_back(Slot {});
+        }
+
+        auto& slot = this->slots[index];
+        slot.id = id;
+        slot.value = value;
+
+        value->handle = ((uint64_t) slot.generation << 32) | (index + 1);
+        value->insertedAt = DescriptorTable::now();
+        this->ids.insert_or_assign(id, value->handle);
+        this->insertedAtSum += value->insertedAt;
+
+        return previous;
+      }
+
+      /**
+       * Removes and returns the value stored for `id`, `nullptr` if none.
+       */
+      T* remove (uint64_t id) {
+        const auto it = this->ids.find(id);
+        if (it == this->ids.end()) {
+          return nullptr;
+        }
+
+        auto& slot = this->slots[(it->second & 0xffffffff) - 1];
+        auto value = static_cast<T*>(slot.value);
+
+        this->unmarkStale(value);
+        this->insertedAtSum -= value->insertedAt;
+        this->free.push_back((uint32_t) ((it->second & 0xffffffff) - 1));
+        this->ids.erase(it);
+
+        slot.value = nullptr;
+        slot.generation++;
+        value->handle = 0;
+
+        return value;
+      }
+
+      T* get (uint64_t id) const {
+        const auto it = this->ids.find(id);
+        return it != this->ids.end() ? this->resolve(it->second) : nullptr;
+      }
+
+      /**
+       * The value for `handle`, `nullptr` if it was removed since.
+       */
+      T* resolve (Handle handle) const {
+        const auto index = handle & 0xffffffff;
+        if (index == 0 || index > this->slots.size()) {
+          return nullptr;
+        }
+
+        const auto& slot = this->slots[index - 1];
+        if (slot.generation != (uint32_t) (handle >> 32)) {
+          return nullptr;
+        }
+
+        return static_cast<T*>(slot.value);
+      }
+
+      bool has (uint64_t id) const {
+        return this->ids.contains(id);
+      }
+
+      size_t size () const {
+        return this->ids.size();
+      }
+
+      bool empty () const {
+        return this->ids.empty();
+      }
+
+      /**
+       * Calls `callback(id, value)` for each value, in slot order. The
+       * callback must not insert or remove values.
+       */
+      template <typename Callback>
+      void forEach (const Callback& callback) const {
+        for (const auto& slot : this->slots) {
+          if (slot.value != nullptr) {
+            callback(slot.id, static_cast<T*>(slot.value));
+          }
+        }
+      }
+
+      Vector<uint64_t> keys () const {
+        Vector<uint64_t> keys;
+        keys.reserve(this->ids.size());
+        this->forEach([&keys](auto id, auto) { keys.push_back(id); });
+        return keys;
+      }
+
+      /**
+       * Puts `value` on the stale list, it must be in the table.
+       */
+      void markStale (T* value) {
+        DescriptorTableEntry* entry = value;
+        if (entry->isStaleListed || entry->handle == 0) {
+          return;
+        }
+
+        entry->isStaleListed = true;
+        entry->stalePrev = nullptr;
+        entry->staleNext = this->staleHead;
+
+        if (this->staleHead != nullptr) {
+          this->staleHead->stalePrev = entry;
+        }
+
+        this->staleHead = entry;
+        this->staleCount++;
+      }
+
+      void unmarkStale (T* value) {
+        DescriptorTableEntry* entry = value;
+        if (!entry->isStaleListed) {
+          return;
+        }
+
+        if (entry->stalePrev != nullptr) {
+          entry->stalePrev->staleNext = entry->staleNext;
+        } else {
+          this->staleHead = entry->staleNext;
+        }
+
+        if (entry->staleNext != nullptr) {
+          entry->staleNext->stalePrev = entry->stalePrev;
+        }
+
+        entry->isStaleListed = false;
+        entry->stalePrev = nullptr;
+        entry->staleNext = nullptr;
+        this->staleCount--;
+      }
+
+      /**
+       * Empties the stale list, returning handles to its values. Handles
+       * are used because collecting one value may remove others.
+       */
+      Vector<Handle> takeStale () {
+        Vector<Handle> handles;
+        handles.reserve(this->staleCount);
+
+        while (this->staleHead != nullptr) {
+          handles.push_back(this->staleHead->handle);
+          this->unmarkStale(static_cast<T*>(this->staleHead));
+        }
+
+        return handles;
+      }
+
+      size_t getStaleCount () const {
+        return this->staleCount;
+      }
+
+      Metrics metrics () const {
+        Metrics metrics;
+        const auto now = DescriptorTable::now();
+
+        metrics.count = this->ids.size();
+        metrics.stale = this->staleCount;
+        metrics.capacity = this->slots.size();
+
+        if (metrics.count > 0) {
+          metrics.meanAge = now - this->insertedAtSum / metrics.count;
+        }
+
+        this->forEach([&metrics, now](auto, auto value) {
+          metrics.bytes += value->bytes;
+          metrics.oldestAge = std::max(metrics.oldestAge, now - value->insertedAt);
+        });
+
+        return metrics;
+      }
+
+    private:
+      struct Slot {
+        uint64_t id = 0;
+        DescriptorTableEntry* value = nullptr;
+        uint32_t generation = 1;
+      };
+
+      Vector<Slot> slots;
+      Vector<uint32_t> free;
+      std::unordered_map<uint64_t, Handle> ids;
+      DescriptorTableEntry* staleHead = nullptr;
+      size_t staleCount = 0;
+      uint64_t insertedAtSum = 0;
+  };
+}
+
+#endif
@@ -0,0 +1,262 @@
+#include "core.hh"
+
+namespace SSC {
+  static double elapsed (uint64_t start, uint64_t end) {
+    return end > start ? (double) (end - start) / 1e6 : 0;
+  }
+
+  void Core::Diagnostics::Stat::update (double value) {
+    this->count++;
+    this->last = value;
+    this->mean = this->count == 1
+      ? value
+      : this->mean + (value - this->mean) / 8;
+    this->max = std::max(this->max, value);
+  }
+
+  void Core::Diagnostics::Stat::roll () {
+    this->windowMax = this->max;
+    this->max = 0;
+  }
+
+  JSON::Object Core::Diagnostics::Stat::json () const {
+    return JSON::Object::Entries {
+      {"count", this->count},
+      {"last", this->last},
+      {"mean", this->mean},
+      {"max", std::max(this->max, this->windowMax)}
+    };
+  }
+
+  Core::Diagnostics::~Diagnostics () {
+  #if defined(__linux__) && !defined(__ANDROID__)
+    if (this->mainLoopSource > 0) {
+      g_source_remove(this->mainLoopSource);
+    }
+  #endif
+  }
+
+  void Core::Diagnostics::start () {
+    if (this->running.exchange(true)) {
+      return;
+    }
+
+    this->core->dispatchEventLoop([this]() {
+      auto loop = this->core->getEventLoop();
+      const auto now = uv_hrtime();
+
+      if (!this->didInit) {
+        this->didInit = true;
+        uv_check_init(loop, &this->check);
+        uv_timer_init(loop, &this->probe);
+        this->check.data = (void *) this;
+        this->probe.data = (void *) this;
+
+        // sampling must never keep the loop alive on its own
+        uv_unref((uv_handle_t *) &this->check);
+        uv_unref((uv_handle_t *) &this->probe);
+      }
+
+      this->probeTime = now;
+      this->probes = 0;
+      this->sampleTime = now;
+      this->sampleIdleTime = uv_metrics_idle_time(loop);
+
+      uv_check_start(&this->check, [](uv_check_t *handle) {
+        auto diagnostics = reinterpret_cast<Diagnostics *>(handle->data);
+        diagnostics->iterations++;
+      });
+
+      uv_timer_start(&this->probe, [](uv_timer_t *handle) {
+        auto diagnostics = reinterpret_cast<Diagnostics *>(handle->data);
+        const auto now = uv_hrtime();
+        const auto lag = elapsed(diagnostics->probeTime, now) - LAG_INTERVAL;
+
+        diagnostics->probeTime = now;
+
+        {
+          std::lock_guard<std::mutex> lock(diagnostics->mutex);
+          diagnostics->metrics.lag.update(std::max(0.0, lag));
+        }
+
+        if (++diagnostics->probes % (SAMPLE_INTERVAL / LAG_INTERVAL) == 0) {
+          diagnostics->sample();
+        }
+      }, LAG_INTERVAL, LAG_INTERVAL);
+    });
+
+  #if defined(__linux__) && !defined(__ANDROID__)
+    this->mainLoopProbeTime = uv_hrtime();
+    this->mainLoopSource = g_timeout_add(LAG_INTERVAL, [](gpointer data) -> gboolean {
+      auto diagnostics = reinterpret_cast<Diagnostics *>(data);
+      const auto now = uv_hrtime();
+      const auto lag = elapsed(diagnostics->mainLoopProbeTime, now) - LAG_INTERVAL;
+      diagnostics->mainLoopProbeTime = now;
+      diagnostics->updateMainLoopLag(std::max(0.0, lag));
+      return G_SOURCE_CONTINUE;
+    }, this);
+  #endif
+  }
+
+  void Core::Diagnostics::stop () {
+    if (!this->running.exchange(false)) {
+      return;
+    }
+
+    this->core->dispatchEventLoop([this]() {
+      uv_check_stop(&this->check);
+      uv_timer_stop(&this->probe);
+    });
+
+  #if defined(__linux__) && !defined(__ANDROID__)
+    if (this->mainLoopSource > 0) {
+      g_source_remove(this->mainLoopSource);
+      this->mainLoopSource = 0;
+    }
+  #endif
+  }
+
+  bool Core::Diagnostics::isRunning () {
+    return this->running;
+  }
+
+  void Core::Diagnostics::sample () {
+    const auto now = uv_hrtime();
+    const auto idleTime = uv_metrics_idle_time(this->core->getEventLoop());
+    const auto wall = elapsed(this->sampleTime, now);
+    const auto idle = elapsed(this->sampleIdleTime, idleTime);
+
+    this->sampleTime = now;
+    this->sampleIdleTime = idleTime;
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->metrics.idleTime = (double) idleTime / 1e6;
+    this->metrics.utilization = wall > 0
+      ? std::clamp(1.0 - idle / wall, 0.0, 1.0)
+      : 0;
+
+    this->metrics.dispatchLatency.roll();
+    this->metrics.lag.roll();
+    this->metrics.mainLoopLag.roll();
+  }
+
+  void Core::Diagnostics::sampleDispatch (Task& task) {
+    if (!this->running) {
+      return;
+    }
+
+    if (this->dispatched.fetch_add(1, std::memory_order_relaxed) % DISPATCH_SAMPLE_RATE != 0) {
+      return;
+    }
+
+    const auto queued = uv_hrtime();
+    task = Task([this, queued, task = std::move(task)]() mutable {
+      {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->metrics.dispatchLatency.update(elapsed(queued, uv_hrtime()));
+      }
+
+      task();
+    });
+  }
+
+  void Core::Diagnostics::updateMainLoopLag (double value) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->metrics.mainLoopLag.update(value);
+  }
+
+  Core::Diagnostics::LoopMetrics Core::Diagnostics::getLoopMetrics () {
+    LoopMetrics metrics;
+
+    {
+      std::lock_guard<std::mutex> lock(this->mutex);
+      metrics = this->metrics;
+    }
+
+    metrics.iterations = this->iterations;
+    metrics.queued = this->core->eventLoopDispatchQueue.size();
+
+    for (const auto& shard : this->core->eventLoopShards) {
+      metrics.queued += shard->queue.size();
+    }
+
+    return metrics;
+  }
+
+  void Core::Diagnostics::loop (const String seq, Module::Callback cb) {
+    this->start();
+    this->core->dispatchEventLoop([=, this]() {
+      const auto metrics = this->getLoopMetrics();
+      auto json = JSON::Object::Entries {
+        {"source", "diagnostics.loop"},
+        {"data", JSON::Object::Entries {
+          {"iterations", metrics.iterations},
+          {"idleTime", metrics.idleTime},
+          {"utilization", metrics.utilization},
+          {"queued", (uint64_t) metrics.queued},
+          {"dispatchLatency", metrics.dispatchLatency.json()},
+          {"lag", metrics.lag.json()},
+          {"mainLoopLag", metrics.mainLoopLag.json()}
+        }}
+      };
+
+      cb(seq, json, Post{});
+    });
+  }
+
+  void Core::Diagnostics::descriptors (const String seq, Module::Callback cb) {
+    DescriptorTable<FS::Descriptor>::Metrics metrics;
+
+    {
+      Lock lock(this->core->fs.mutex);
+      metrics = this->core->fs.descriptors.metrics();
+    }
+
+    auto json = JSON::Object::Entries {
+      {"source", "diagnostics.descriptors"},
+      {"data", JSON::Object::Entries {
+        {"count", (uint64_t) metrics.count},
+        {"stale", (uint64_t) metrics.stale},
+        {"capacity", (uint64_t) metrics.capacity},
+        {"bytes", metrics.bytes},
+        {"oldestAge", metrics.oldestAge},
+        {"meanAge", metrics.meanAge}
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+
+  void Core::Diagnostics::metadataCache (const String seq, Module::Callback cb) {
+    auto cache = this->core->fs.getMetadataCache();
+
+    if (cache == nullptr) {
+      auto json = JSON::Object::Entries {
+        {"source", "diagnostics.metadataCache"},
+        {"data", JSON::Object::Entries {
+          {"enabled", false}
+        }}
+      };
+
+      return cb(seq, json, Post{});
+    }
+
+    const auto stats = cache->stats();
+    auto json = JSON::Object::Entries {
+      {"source", "diagnostics.metadataCache"},
+      {"data", JSON::Object::Entries {
+        {"enabled", true},
+        {"hits", stats.hits},
+        {"misses", stats.misses},
+        {"stores", stats.stores},
+        {"invalidations", stats.invalidations},
+        {"evictions", stats.evictions},
+        {"expirations", stats.expirations},
+        {"size", (uint64_t) stats.size},
+        {"watched", (uint64_t) stats.watched}
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+}
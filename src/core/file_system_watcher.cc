@@ -1,5 +1,12 @@
 #include "file_system_watcher.hh"
 
+#if defined(__linux__) && !defined(__ANDROID__)
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "debug.hh"
+#endif
+
 namespace SSC {
   static FileSystemWatcher::Path resolveFileNameForContext (
       const String& filename,
@@ -12,6 +19,58 @@ namespace SSC {
     return FileSystemWatcher::Path(filename);
   }
 
+  static void dispatch (
+    FileSystemWatcher::Context* context,
+    const FileSystemWatcher::Path& path,
+    int eventTypes
+  ) {
+    using Event = FileSystemWatcher::Event;
+    const auto now = FileSystemWatcher::Clock::now();
+    const auto watcher = context->watcher;
+    const auto debounce = std::chrono::milliseconds(watcher->options.debounce);
+
+    if (!watcher->options.includeRemoved && !std::filesystem::exists(path)) {
+      return;
+    }
+
+    // debounced by path, events for other paths in a directory (tree) are
+    // still reported unless they are coalesced into one for the watched path
+    if (debounce.count() > 0) {
+      auto& reported = watcher->reported;
+      const auto key = watcher->options.coalesce ? context->name : path.string();
+
+      // paths are forgotten once their debounce is over
+      if (now - watcher->lastPruned >= debounce) {
+        std::erase_if(reported, [&](const auto& entry) {
+          return now - entry.second >= debounce;
+        });
+
+        watcher->lastPruned = now;
+      }
+
+      const auto it = reported.find(key);
+      if (it != reported.end() && now - it->second < debounce) {
+        return;
+      }
+
+      reported.insert_or_assign(key, now);
+    }
+
+    // build events vector
+    auto events = Vector<Event>();
+
+    if ((eventTypes & UV_RENAME) == UV_RENAME) {
+      events.push_back(Event::RENAME);
+    }
+
+    if ((eventTypes & UV_CHANGE) == UV_CHANGE) {
+      events.push_back(Event::CHANGE);
+    }
+
+    context->lastUpdated = now;
+    watcher->callback(path.string(), events, *context);
+  }
+
   void FileSystemWatcher::poll (FileSystemWatcher* watcher) {
     Lock lock(watcher->mutex);
 
@@ -31,35 +90,290 @@ namespace SSC {
     const auto filename = String(eventTarget);
     const auto context = reinterpret_cast<Context*>(handle->data);
     const auto path = resolveFileNameForContext(filename, context);
-    const auto now = Clock::now();
+    dispatch(context, path, eventTypes);
+  }
+
+#if defined(__linux__) && !defined(__ANDROID__)
+  // the events libuv watches for, mapped to `UV_CHANGE` and `UV_RENAME` the
+  // same way
+  static constexpr uint32_t INOTIFY_EVENTS = (
+    IN_ATTRIB |
+    IN_CREATE |
+    IN_MODIFY |
+    IN_DELETE |
+    IN_DELETE_SELF |
+    IN_MOVE_SELF |
+    IN_MOVED_FROM |
+    IN_MOVED_TO
+  );
+
+  // directories scanned in each iteration of the loop, so watching a large
+  // tree doesn't block it
+  static constexpr size_t INOTIFY_SCAN_BATCH = 256;
+
+  void FileSystemWatcher::handleInotifyCallback (
+    uv_poll_t* poll,
+    int status,
+    int events
+  ) {
+    alignas(struct inotify_event) char buffer[64 * 1024];
+    auto watcher = reinterpret_cast<FileSystemWatcher*>(poll->data);
+    auto inotify = watcher->inotify;
+    bool overflowed = false;
 
-    if (!std::filesystem::exists(path)) {
+    if (status < 0 || inotify == nullptr) {
       return;
     }
 
-    const auto delta = std::chrono::duration_cast<std::chrono::milliseconds>(
-      now - context->lastUpdated
-    );
+    while (true) {
+      const auto size = read(inotify->fd, buffer, sizeof(buffer));
+
+      if (size < 0 && errno == EINTR) {
+        continue;
+      }
+
+      // drained (`EAGAIN`)
+      if (size <= 0) {
+        break;
+      }
+
+      for (auto offset = 0; offset < size;) {
+        const auto event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+        offset += sizeof(struct inotify_event) + event->len;
+
+        // events were dropped, the trees are scanned again once the
+        // queue is drained
+        if ((event->mask & IN_Q_OVERFLOW) == IN_Q_OVERFLOW) {
+          overflowed = true;
+          continue;
+        }
+
+        const auto it = inotify->watches.find(event->wd);
+
+        // removed with `removeWatches()`, with events still queued
+        if (it == inotify->watches.end()) {
+          continue;
+        }
+
+        // the directory was removed or unmounted
+        if ((event->mask & IN_IGNORED) == IN_IGNORED) {
+          const auto descriptor = inotify->descriptors.find(it->second.path);
+          if (descriptor != inotify->descriptors.end() && descriptor->second == event->wd) {
+            inotify->descriptors.erase(descriptor);
+          }
+
+          inotify->watches.erase(it);
+          inotify->isFull = false;
+          continue;
+        }
+
+        // copied, `removeWatches()` may erase it
+        const auto watch = it->second;
+
+        // events of a directory in a tree are reported by its parent
+        if (event->len == 0 && watch.path != watch.context->name) {
+          continue;
+        }
+
+        const auto path = event->len > 0
+          ? watch.path + "/" + event->name
+          : watch.path;
+
+        dispatch(
+          watch.context,
+          path,
+          (event->mask & (IN_ATTRIB | IN_MODIFY)) > 0 ? UV_CHANGE : UV_RENAME
+        );
+
+        // stopped by the callback
+        if (watcher->inotify != inotify) {
+          return;
+        }
+
+        if ((event->mask & IN_ISDIR) == IN_ISDIR) {
+          if ((event->mask & (IN_CREATE | IN_MOVED_TO)) > 0) {
+            watcher->addWatches(path, watch.context, true);
+          } else if ((event->mask & IN_MOVED_FROM) == IN_MOVED_FROM) {
+            watcher->removeWatches(path);
+          }
+        }
+      }
+    }
+
+    if (overflowed && watcher->inotify == inotify) {
+      watcher->rescan();
+    }
+  }
+
+  // queues `directory` to be watched along with its tree, the trees are
+  // scanned on the loop a batch at a time
+  void FileSystemWatcher::addWatches (
+    const String& directory,
+    Context* context,
+    bool report
+  ) {
+    auto inotify = this->inotify;
+    inotify->pending.push_back(Inotify::Scan { directory, context, report });
+
+    if (!uv_is_active(reinterpret_cast<uv_handle_t*>(&inotify->idle))) {
+      uv_idle_start(&inotify->idle, handleInotifyScanCallback);
+    }
+  }
+
+  void FileSystemWatcher::handleInotifyScanCallback (uv_idle_t* idle) {
+    auto watcher = reinterpret_cast<FileSystemWatcher*>(idle->data);
+    auto inotify = watcher->inotify;
+
+    for (size_t i = 0; i < INOTIFY_SCAN_BATCH && inotify->pending.size() > 0 && !inotify->isFull; ++i) {
+      const auto scan = inotify->pending.back();
+      const auto context = scan.context;
+      const auto& path = scan.path;
+      inotify->pending.pop_back();
+
+      // the watched directory may be a link, links in its tree are not
+      // followed so a tree can't contain itself
+      const auto mask = INOTIFY_EVENTS | IN_ONLYDIR | (
+        path == context->name ? 0 : IN_DONT_FOLLOW
+      );
+
+      const auto wd = inotify_add_watch(inotify->fd, path.c_str(), mask);
+
+      if (wd < 0) {
+        if (errno == ENOSPC || errno == ENOMEM) {
+          inotify->isFull = true;
+          debug(
+            "FileSystemWatcher: Out of inotify watches at '%s' (fs.inotify.max_user_watches)",
+            path.c_str()
+          );
+        }
+
+        // otherwise removed or replaced since it was found
+        continue;
+      }
+
+      // a directory found again at another path keeps its descriptor
+      const auto existing = inotify->watches.find(wd);
+      if (existing != inotify->watches.end() && existing->second.path != path) {
+        const auto descriptor = inotify->descriptors.find(existing->second.path);
+        if (descriptor != inotify->descriptors.end() && descriptor->second == wd) {
+          inotify->descriptors.erase(descriptor);
+        }
+      }
+
+      inotify->watches.insert_or_assign(wd, Inotify::Watch { path, context, inotify->generation });
+      inotify->descriptors.insert_or_assign(path, wd);
+
+      std::error_code error;
+      auto iterator = std::filesystem::directory_iterator(path, error);
+
+      for (; !error && iterator != std::filesystem::directory_iterator(); iterator.increment(error)) {
+        // entries created before the watch was added have no events
+        if (scan.report) {
+          dispatch(context, iterator->path(), UV_RENAME);
+
+          // stopped by the callback
+          if (watcher->inotify != inotify) {
+            return;
+          }
+        }
+
+        if (iterator->symlink_status(error).type() == std::filesystem::file_type::directory) {
+          inotify->pending.push_back(Inotify::Scan { iterator->path().string(), context, scan.report });
+        }
+      }
+    }
+
+    // the rest of the trees can't be watched
+    if (inotify->isFull) {
+      inotify->pending.clear();
+    }
 
-    if (delta.count() < context->watcher->options.debounce) {
+    if (inotify->pending.size() > 0) {
       return;
     }
 
-    // build events vector
-    auto events = Vector<Event>();
+    uv_idle_stop(idle);
 
-    if ((eventTypes & UV_RENAME) == UV_RENAME) {
-      events.push_back(Event::RENAME);
+    if (inotify->isRescanning) {
+      inotify->isRescanning = false;
+      watcher->finishRescan();
     }
+  }
 
-    if ((eventTypes & UV_CHANGE) == UV_CHANGE) {
-      events.push_back(Event::CHANGE);
+  void FileSystemWatcher::removeWatches (const String& directory) {
+    auto inotify = this->inotify;
+    const auto prefix = directory + "/";
+    const auto remove = [inotify](auto it) {
+      const auto watch = inotify->watches.find(it->second);
+      if (watch != inotify->watches.end() && watch->second.path == it->first) {
+        inotify_rm_watch(inotify->fd, it->second);
+        inotify->watches.erase(watch);
+      }
+
+      return inotify->descriptors.erase(it);
+    };
+
+    const auto it = inotify->descriptors.find(directory);
+    if (it != inotify->descriptors.end()) {
+      remove(it);
     }
 
-    context->lastUpdated = now;
-    context->watcher->callback(path.string(), events, *context);
+    // the directories in the tree are next to each other in the ordered
+    // descriptors
+    auto next = inotify->descriptors.lower_bound(prefix);
+    while (next != inotify->descriptors.end() && next->first.starts_with(prefix)) {
+      next = remove(next);
+    }
+
+    inotify->isFull = false;
+  }
+
+  void FileSystemWatcher::rescan () {
+    auto inotify = this->inotify;
+    inotify->generation++;
+    inotify->isFull = false;
+    inotify->isRescanning = true;
+
+    // adding a watch for a directory that has one returns its descriptor,
+    // so only directories that appeared while events were dropped get new
+    // watches
+    for (auto& entry : this->contexts) {
+      if (entry.second.isDirectory && this->options.recursive) {
+        this->addWatches(entry.second.name, &entry.second, false);
+      }
+    }
   }
 
+  void FileSystemWatcher::finishRescan () {
+    auto inotify = this->inotify;
+
+    // directories not found again were removed or moved out of the trees
+    for (auto it = inotify->watches.begin(); it != inotify->watches.end();) {
+      if (it->second.generation == inotify->generation) {
+        ++it;
+        continue;
+      }
+
+      const auto descriptor = inotify->descriptors.find(it->second.path);
+      if (descriptor != inotify->descriptors.end() && descriptor->second == it->first) {
+        inotify->descriptors.erase(descriptor);
+      }
+
+      inotify_rm_watch(inotify->fd, it->first);
+      it = inotify->watches.erase(it);
+    }
+
+    // which changes were missed is unknown, so everything is reported as
+    // changed, regardless of the debounce
+    for (auto& entry : this->contexts) {
+      if (entry.second.isDirectory && this->options.recursive) {
+        this->reported.erase(entry.second.name);
+        dispatch(&entry.second, entry.second.name, UV_RENAME | UV_CHANGE);
+      }
+    }
+  }
+#endif
+
   FileSystemWatcher::FileSystemWatcher (const String& path) {
     this->paths.push_back(path);
   }
@@ -76,6 +390,9 @@ namespace SSC {
         this->thread->join();
       }
 
+      // run the close callbacks of handles closed in `stop()`
+      uv_run(this->loop, UV_RUN_DEFAULT);
+
       delete this->thread;
       this->thread = nullptr;
     }
@@ -98,18 +415,48 @@ namespace SSC {
     }
 
     for (const auto& path : this->paths) {
-      const bool exists = this->handles.contains(path);
+      const bool exists = this->contexts.contains(path);
       auto context = &this->contexts[path];
-      auto handle = &this->handles[path];
 
-      // init if not already in handles mapping
+      // init context if not already in contexts mapping
       if (!exists) {
-        // init context
         context->isDirectory = std::filesystem::is_directory(path);
         context->lastUpdated = Clock::now();
         context->watcher = this;
-        context->name = std::filesystem::absolute(path).string();
+        context->name = std::filesystem::absolute(path).lexically_normal().string();
 
+        if (context->name.size() > 1 && context->name.ends_with("/")) {
+          context->name.pop_back();
+        }
+      }
+
+    #if defined(__linux__) && !defined(__ANDROID__)
+      if (context->isDirectory && this->options.recursive) {
+        if (this->inotify == nullptr) {
+          const auto fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+          if (fd >= 0) {
+            this->inotify = new Inotify();
+            this->inotify->fd = fd;
+            uv_poll_init(this->loop, &this->inotify->poll, fd);
+            uv_idle_init(this->loop, &this->inotify->idle);
+            this->inotify->poll.data = reinterpret_cast<void*>(this);
+            this->inotify->idle.data = reinterpret_cast<void*>(this);
+          }
+        }
+
+        // watched with libuv, without its tree, if out of inotify instances
+        if (this->inotify != nullptr) {
+          this->addWatches(context->name, context, false);
+          continue;
+        }
+      }
+    #endif
+
+      const bool initialized = this->handles.contains(path);
+      auto handle = &this->handles[path];
+
+      // init if not already in handles mapping
+      if (!initialized) {
         // init uv fs event handle
         uv_fs_event_init(this->loop, handle);
 
@@ -117,12 +464,12 @@ namespace SSC {
         handle->data = reinterpret_cast<void*>(context);
       }
 
-      uv_fs_event_flags flags;
+      unsigned int flags = 0;
 
-      if (context->isDirectory) {
-        flags = UV_FS_EVENT_RECURSIVE;
-      } else {
+      if (!context->isDirectory) {
         flags = UV_FS_EVENT_WATCH_ENTRY;
+      } else if (this->options.recursive) {
+        flags = UV_FS_EVENT_RECURSIVE;
       }
 
       // start (or restart)
@@ -134,6 +481,12 @@ namespace SSC {
       );
     }
 
+  #if defined(__linux__) && !defined(__ANDROID__)
+    if (this->inotify != nullptr) {
+      uv_poll_start(&this->inotify->poll, UV_READABLE, handleInotifyCallback);
+    }
+  #endif
+
     return true;
 
   }
@@ -150,6 +503,27 @@ namespace SSC {
       uv_fs_event_stop(&handle.second);
     }
 
+  #if defined(__linux__) && !defined(__ANDROID__)
+    if (this->inotify != nullptr) {
+      // closing the instance removes its watches, once libuv is done with
+      // the descriptor and the scan
+      uv_poll_stop(&this->inotify->poll);
+      uv_idle_stop(&this->inotify->idle);
+      this->inotify->poll.data = reinterpret_cast<void*>(this->inotify);
+      this->inotify->idle.data = reinterpret_cast<void*>(this->inotify);
+      uv_close(reinterpret_cast<uv_handle_t*>(&this->inotify->poll), [](uv_handle_t* handle) {
+        auto inotify = reinterpret_cast<Inotify*>(handle->data);
+        uv_close(reinterpret_cast<uv_handle_t*>(&inotify->idle), [](uv_handle_t* handle) {
+          auto inotify = reinterpret_cast<Inotify*>(handle->data);
+          close(inotify->fd);
+          delete inotify;
+        });
+      });
+
+      this->inotify = nullptr;
+    }
+  #endif
+
     // stop loop if `thread` is not a `nullptr` which means we created it
     if (this->loop != nullptr && this->thread != nullptr) {
       uv_stop(this->loop);
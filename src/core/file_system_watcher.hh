@@ -1,6 +1,8 @@
 #ifndef SSC_FILE_SYSTEM_WATCHER
 #define SSC_FILE_SYSTEM_WATCHER
 
+#include <unordered_map>
+
 #include "platform.hh"
 #include "types.hh"
 
@@ -30,6 +32,9 @@ namespace SSC {
 
       struct Options {
         int debounce = 250; // in milliseconds
+        bool includeRemoved = false; // report events for removed paths
+        bool recursive = true; // report events in the directories of directories
+        bool coalesce = false; // debounce by watched path instead of by changed path
       };
 
       using EventCallback = std::function<void(
@@ -45,6 +50,9 @@ namespace SSC {
       ContextMap contexts;
       Vector<String> paths;
       Options options;
+      // when paths were last reported, for the debounce
+      std::unordered_map<String, TimePoint> reported;
+      TimePoint lastPruned;
 
       // thread state
       AtomicBool isRunning = false;
@@ -53,7 +61,47 @@ namespace SSC {
 
       // uv
       HandleMap handles;
-      Loop* loop;
+      Loop* loop = nullptr;
+
+    #if defined(__linux__) && !defined(__ANDROID__)
+      // libuv only watches the top level of a directory on Linux, so
+      // recursively watched directories share one inotify instance with a
+      // watch for each directory in their trees, added and removed as
+      // directories appear and disappear
+      struct Inotify {
+        struct Watch {
+          String path;
+          Context* context; // of the watched directory the tree is in
+          uint64_t generation = 0; // of the scan that found the directory
+        };
+
+        // a directory to watch along with its tree
+        struct Scan {
+          String path;
+          Context* context;
+          bool report = false; // report the entries found
+        };
+
+        int fd = -1;
+        uv_poll_t poll;
+        uv_idle_t idle; // scans a batch of `pending` each loop iteration
+        std::unordered_map<int, Watch> watches;
+        std::map<String, int> descriptors; // ordered so trees are ranges
+        Vector<Scan> pending;
+        uint64_t generation = 0; // incremented by each `rescan()`
+        bool isFull = false; // out of `fs.inotify.max_user_watches`
+        bool isRescanning = false; // until `pending` is empty
+      };
+
+      Inotify* inotify = nullptr;
+
+      static void handleInotifyCallback (uv_poll_t* poll, int status, int events);
+      static void handleInotifyScanCallback (uv_idle_t* idle);
+      void addWatches (const String& directory, Context* context, bool report);
+      void removeWatches (const String& directory);
+      void rescan ();
+      void finishRescan ();
+    #endif
 
       static void poll (FileSystemWatcher*);
       static void handleEventCallback (
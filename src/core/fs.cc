@@ -169,1132 +169,2734 @@ namespace SSC {
   }
   #undef SET_CONSTANT
 
-  JSON::Object getStatsJSON (const String& source, uv_stat_t* stats) {
+  static JSON::Object::Entries getStatsEntries (const uv_stat_t* stats) {
     return JSON::Object::Entries {
-      {"source", source},
-      {"data", JSON::Object::Entries {
-        {"st_dev", std::to_string(stats->st_dev)},
-        {"st_mode", std::to_string(stats->st_mode)},
-        {"st_nlink", std::to_string(stats->st_nlink)},
-        {"st_uid", std::to_string(stats->st_uid)},
-        {"st_gid", std::to_string(stats->st_gid)},
-        {"st_rdev", std::to_string(stats->st_rdev)},
-        {"st_ino", std::to_string(stats->st_ino)},
-        {"st_size", std::to_string(stats->st_size)},
-        {"st_blksize", std::to_string(stats->st_blksize)},
-        {"st_blocks", std::to_string(stats->st_blocks)},
-        {"st_flags", std::to_string(stats->st_flags)},
-        {"st_gen", std::to_string(stats->st_gen)},
-        {"st_atim", JSON::Object::Entries {
-          {"tv_sec", std::to_string(stats->st_atim.tv_sec)},
-          {"tv_nsec", std::to_string(stats->st_atim.tv_nsec)},
-        }},
-        {"st_mtim", JSON::Object::Entries {
-          {"tv_sec", std::to_string(stats->st_mtim.tv_sec)},
-          {"tv_nsec", std::to_string(stats->st_mtim.tv_nsec)}
-        }},
-        {"st_ctim", JSON::Object::Entries {
-          {"tv_sec", std::to_string(stats->st_ctim.tv_sec)},
-          {"tv_nsec", std::to_string(stats->st_ctim.tv_nsec)}
-        }},
-        {"st_birthtim", JSON::Object::Entries {
-          {"tv_sec", std::to_string(stats->st_birthtim.tv_sec)},
-          {"tv_nsec", std::to_string(stats->st_birthtim.tv_nsec)}
-        }}
+      {"st_dev", std::to_string(stats->st_dev)},
+      {"st_mode", std::to_string(stats->st_mode)},
+      {"st_nlink", std::to_string(stats->st_nlink)},
+      {"st_uid", std::to_string(stats->st_uid)},
+      {"st_gid", std::to_string(stats->st_gid)},
+      {"st_rdev", std::to_string(stats->st_rdev)},
+      {"st_ino", std::to_string(stats->st_ino)},
+      {"st_size", std::to_string(stats->st_size)},
+      {"st_blksize", std::to_string(stats->st_blksize)},
+      {"st_blocks", std::to_string(stats->st_blocks)},
+      {"st_flags", std::to_string(stats->st_flags)},
+      {"st_gen", std::to_string(stats->st_gen)},
+      {"st_atim", JSON::Object::Entries {
+        {"tv_sec", std::to_string(stats->st_atim.tv_sec)},
+        {"tv_nsec", std::to_string(stats->st_atim.tv_nsec)},
+      }},
+      {"st_mtim", JSON::Object::Entries {
+        {"tv_sec", std::to_string(stats->st_mtim.tv_sec)},
+        {"tv_nsec", std::to_string(stats->st_mtim.tv_nsec)}
+      }},
+      {"st_ctim", JSON::Object::Entries {
+        {"tv_sec", std::to_string(stats->st_ctim.tv_sec)},
+        {"tv_nsec", std::to_string(stats->st_ctim.tv_nsec)}
+      }},
+      {"st_birthtim", JSON::Object::Entries {
+        {"tv_sec", std::to_string(stats->st_birthtim.tv_sec)},
+        {"tv_nsec", std::to_string(stats->st_birthtim.tv_nsec)}
       }}
     };
   }
 
-	void Core::FS::RequestContext::setBuffer(char* base, uint32_t len) {
-		this->buf.base = base;
-		this->buf.len = len;
+  JSON::Object getStatsJSON (const String& source, uv_stat_t* stats) {
+    return JSON::Object::Entries {
+      {"source", source},
+      {"data", getStatsEntries(stats)}
+    };
   }
 
-  void Core::FS::RequestContext::freeBuffer() {
-    delete[] static_cast<char*>(this->buf.base);
-    this->buf.base = nullptr;
-    this->buf.len = 0;
+  static JSON::Object getErrorJSON (const String& source, ssize_t err) {
+    return JSON::Object::Entries {
+      {"source", source},
+      {"err", JSON::Object::Entries {
+        {"code", (int64_t) err},
+        {"message", String(uv_strerror((int) err))}
+      }}
+    };
   }
 
-  char* Core::FS::RequestContext::getBuffer () {
-    return this->buf.base;
+  static JSON::Object getErrorJSON (const String& source, uint64_t id, ssize_t err) {
+    return JSON::Object::Entries {
+      {"source", source},
+      {"err", JSON::Object::Entries {
+        {"id", std::to_string(id)},
+        {"code", (int64_t) err},
+        {"message", String(uv_strerror((int) err))}
+      }}
+    };
   }
 
-  uint32_t Core::FS::RequestContext::getBufferSize () {
-    return this->buf.len;
+  static JSON::Object getNotOpenErrorJSON (const String& source, uint64_t id) {
+    return JSON::Object::Entries {
+      {"source", source},
+      {"err", JSON::Object::Entries {
+        {"id", std::to_string(id)},
+        {"code", "ENOTOPEN"},
+        {"type", "NotFoundError"},
+        {"message", "No file descriptor found with that id"}
+      }}
+    };
   }
 
-  Core::FS::Descriptor::Descriptor (Core *core, uint64_t id) {
-    this->core = core;
-    this->id = id;
-  }
+  // `[linux] fs_io_uring = true` submits file system operations through an
+  // `io_uring` per event loop instead of the libuv thread pool. Loops keep
+  // using libuv when the kernel doesn't allow it.
+  static UVFS getFS (uv_loop_t* loop) {
+  #if SSC_IO_URING
+    static auto userConfig = getUserConfig();
+    static const auto enabled = userConfig["linux_fs_io_uring"] == "true";
 
-  bool Core::FS::Descriptor::isDirectory () {
-    Lock lock(this->mutex);
-    return this->dir != nullptr;
-  }
+    if (enabled) {
+      return UVFS(loop, IOUring::get(loop));
+    }
+  #endif
 
-  bool Core::FS::Descriptor::isFile () {
-    Lock lock(this->mutex);
-    return this->fd > 0 && this->dir == nullptr;
+    return UVFS(loop);
   }
 
-  bool Core::FS::Descriptor::isRetained () {
-    return this->retained;
-  }
+  static void invalidateMetadataCache (Core* core, const String& path) {
+    auto cache = core->fs.getMetadataCache();
 
-  bool Core::FS::Descriptor::isStale () {
-    return this->stale;
+    if (cache != nullptr && path.size() > 0) {
+      cache->invalidate(path);
+    }
   }
 
-  Core::FS::Descriptor * Core::FS::getDescriptor (uint64_t id) {
-    Lock lock(this->mutex);
-    if (descriptors.find(id) != descriptors.end()) {
-      return descriptors.at(id);
+  // drops the cached metadata of `paths` when an operation that changes
+  // them replies, so a lookup that follows it sees the change
+  static Core::Module::Callback invalidateMetadataCache (
+    Core* core,
+    const Vector<String>& paths,
+    const Core::Module::Callback& cb
+  ) {
+    auto cache = core->fs.getMetadataCache();
+
+    if (cache == nullptr) {
+      return cb;
     }
-    return nullptr;
+
+    return [cache, paths, cb](auto seq, auto json, auto post) {
+      for (const auto& path : paths) {
+        cache->invalidate(path);
+      }
+
+      cb(seq, json, post);
+    };
   }
 
-  void Core::FS::removeDescriptor (uint64_t id) {
-    Lock lock(this->mutex);
-    if (descriptors.find(id) != descriptors.end()) {
-      descriptors.erase(id);
+  // Coroutine implementations of `Core::FS` operations. Each is started on
+  // the loop that owns the operation and copies its arguments into its
+  // pooled frame, so nothing is captured by reference across a suspension.
+
+  static Async<> accessAsync (Core* core, String seq, String path, int mode, Core::Module::Callback cb) {
+    auto cache = core->fs.getMetadataCache();
+    auto entry = MetadataCache::Entry {};
+    auto ticket = MetadataCache::UNCACHEABLE;
+
+    if (cache == nullptr || !cache->get(MetadataCache::Kind::Access, path, mode, entry, ticket)) {
+      auto result = co_await getFS(core->getEventLoop()).access(path, mode);
+      entry.result = (int) result.result;
+
+      if (cache != nullptr) {
+        cache->put(MetadataCache::Kind::Access, path, mode, entry, ticket);
+      }
     }
-  }
 
-  bool Core::FS::hasDescriptor (uint64_t id) {
-    Lock lock(this->mutex);
-    return descriptors.find(id) != descriptors.end();
+    if (entry.result < 0) {
+      co_return cb(seq, getErrorJSON("fs.access", entry.result), Post{});
+    }
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.access"},
+      {"data", JSON::Object::Entries {
+        {"mode", mode},
+      }}
+    };
+
+    cb(seq, json, Post{});
   }
 
-  void Core::FS::retainOpenDescriptor (
-    const String seq,
+  static Async<> openAsync (
+    Core* core,
+    String seq,
     uint64_t id,
-    Module::Callback cb
+    int index,
+    String path,
+    int flags,
+    int mode,
+    Core::Module::Callback cb
   ) {
-    auto desc = getDescriptor(id);
+    auto result = co_await getFS(core->getEventLoop(id)).open(path, flags, mode);
 
-    if (desc == nullptr) {
-      auto json = JSON::Object::Entries {
-        {"source", "fs.retainOpenDescriptor"},
-        {"err", JSON::Object::Entries {
-          {"id", std::to_string(id)},
-          {"code", "ENOTOPEN"},
-          {"type", "NotFoundError"},
-          {"message", "No file descriptor found with that id"}
-        }}
-      };
+    if (!result.ok()) {
+      co_return cb(seq, getErrorJSON("fs.open", id, result.result), Post{});
+    }
 
-      return cb(seq, json, Post{});
+    auto desc = new Core::FS::Descriptor(core, id);
+    desc->index = index;
+    desc->fd = (uv_file) result.result;
+    desc->path = path;
+
+    if ((flags & (O_CREAT | O_TRUNC)) != 0) {
+      invalidateMetadataCache(core, path);
+    }
+
+    {
+      // insert into `descriptors` map
+      Lock lock(core->fs.mutex);
+      core->fs.descriptors.insert(desc->id, desc);
     }
 
-    desc->retained = true;
     auto json = JSON::Object::Entries {
-      {"source", "fs.retainOpenDescriptor"},
+      {"source", "fs.open"},
       {"data", JSON::Object::Entries {
-        {"id", std::to_string(desc->id)}
+        {"id", std::to_string(desc->id)},
+        {"fd", desc->fd}
       }}
     };
 
     cb(seq, json, Post{});
   }
 
-  void Core::FS::access (
-    const String seq,
-    const String path,
-    int mode,
-    Module::Callback cb
+  static Async<> closeAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    Core::Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_access(loop, req, filename, mode, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
+    auto result = co_await getFS(core->getEventLoop(desc->id)).close(desc->fd);
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.access"},
-            {"err", JSON::Object::Entries {
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.access"},
-            {"data", JSON::Object::Entries {
-              {"mode", req->flags},
-            }}
-          };
-        }
+    if (!result.ok()) {
+      co_return cb(seq, getErrorJSON("fs.close", desc->id, result.result), Post{});
+    }
 
-        ctx->cb(ctx->seq, json, Post {});
-        delete ctx;
-      });
+    auto json = JSON::Object::Entries {
+      {"source", "fs.close"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(desc->id)},
+        {"fd", desc->fd}
+      }}
+    };
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.access"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    // times are updated when the last write is flushed
+    if (desc->bytes > 0) {
+      invalidateMetadataCache(core, desc->path);
+    }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      }
-    });
+    core->fs.removeDescriptor(desc->id);
+    delete desc;
+
+    cb(seq, json, Post{});
   }
 
-  void Core::FS::chmod (
-    const String seq,
-    const String path,
-    int mode,
-    Module::Callback cb
+  static Async<> readAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    size_t size,
+    size_t offset,
+    Core::Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_chmod(loop, req, filename, mode, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
+    // the kernel overwrites what is read, so the buffer is not zero filled
+    auto bytes = BufferPool::allocate(size);
+    auto buffer = uv_buf_init(bytes, (unsigned int) size);
+    auto result = co_await getFS(core->getEventLoop(desc->id)).read(desc->fd, buffer, offset);
+
+    if (!result.ok()) {
+      BufferPool::release(bytes);
+      co_return cb(seq, getErrorJSON("fs.read", desc->id, result.result), Post{});
+    }
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.chmod"},
-            {"err", JSON::Object::Entries {
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.chmod"},
-            {"data", JSON::Object::Entries {
-              {"mode", req->flags},
-            }}
-          };
-        }
+    desc->bytes += result.result;
 
-        ctx->cb(ctx->seq, json, Post {});
-        delete ctx;
-      });
+    auto headers = Headers {{
+      {"content-type" ,"application/octet-stream"},
+      {"content-length", result.result}
+    }};
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.chmod"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    Post post = {0};
+    post.id = SSC::rand64();
+    post.body = bytes;
+    post.length = (int) result.result;
+    post.headers = headers.str();
+    post.pooled = true;
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      }
-    });
+    cb(seq, JSON::Object{}, post);
   }
 
-	void Core::FS::chown (
-    const String seq,
-    const String path,
-    uv_uid_t uid,
-    uv_gid_t gid,
-    Module::Callback cb
+  // one `preadv(2)` into `sizes.size()` consecutive segments of a single
+  // pooled buffer, which becomes the post body
+  static Async<> readvAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    Vector<size_t> sizes,
+    int64_t offset,
+    Core::Module::Callback cb
   ) {
-    core->dispatchEventLoop([=, this]() {
-      auto ctx = new RequestContext(seq, cb);
-      auto uv_cb = [](uv_fs_t* req) {
-        auto ctx = static_cast<RequestContext*>(req->data);
-        auto json = JSON::Object{};
+    size_t size = 0;
+    for (const auto segment : sizes) {
+      size += segment;
+    }
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.chown"},
-            {"err", JSON::Object::Entries {
-              {"code", uv_fs_get_result(req)},
-              {"message", String(uv_strerror(uv_fs_get_result(req)))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.chown"},
-            {"data", JSON::Object::Entries {
-              {"mode", req->flags},
-            }}
-          };
-        }
+    auto bytes = BufferPool::allocate(size);
+    auto buffers = Vector<uv_buf_t>();
+    buffers.reserve(sizes.size());
 
-        ctx->cb(ctx->seq, json, Post {});
-        delete ctx;
-      };
+    for (size_t i = 0, position = 0; i < sizes.size(); position += sizes[i++]) {
+      buffers.push_back(uv_buf_init(bytes + position, (unsigned int) sizes[i]));
+    }
 
-      auto err = uv_fs_chown(
-          &core->eventLoop, &ctx->req, path.c_str(), uid, gid, uv_cb);
+    auto fs = getFS(core->getEventLoop(desc->id));
+    auto result = co_await fs.read(desc->fd, std::move(buffers), offset);
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.chown"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
-        ctx->cb(seq, json, Post{});
-        delete ctx;
-      }
-    });
+    if (!result.ok()) {
+      BufferPool::release(bytes);
+      co_return cb(seq, getErrorJSON("fs.readv", desc->id, result.result), Post{});
+    }
+
+    desc->bytes += result.result;
+
+    auto headers = Headers {{
+      {"content-type" ,"application/octet-stream"},
+      {"content-length", result.result}
+    }};
+
+    Post post = {0};
+    post.id = SSC::rand64();
+    post.body = bytes;
+    post.length = (size_t) result.result;
+    post.headers = headers.str();
+    post.pooled = true;
+
+    cb(seq, JSON::Object{}, post);
   }
 
-  void Core::FS::lchown (
-		const String seq,
-    const String path,
-    uv_uid_t uid,
-    uv_gid_t gid,
-    Module::Callback cb
+  // one `pwritev(2)` of `bytes` split into `sizes.size()` segments
+  static Async<> writevAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    char* bytes,
+    Vector<size_t> sizes,
+    int64_t offset,
+    Core::Module::Callback cb
   ) {
-    core->dispatchEventLoop([=, this]() {
-      auto ctx = new RequestContext(seq, cb);
-      auto uv_cb = [](uv_fs_t* req) {
-        auto ctx = static_cast<RequestContext*>(req->data);
+    auto buffers = Vector<uv_buf_t>();
+    buffers.reserve(sizes.size());
+
+    for (size_t i = 0, position = 0; i < sizes.size(); position += sizes[i++]) {
+      buffers.push_back(uv_buf_init(bytes + position, (unsigned int) sizes[i]));
+    }
+
+    auto fs = getFS(core->getEventLoop(desc->id));
+    auto result = co_await fs.write(desc->fd, std::move(buffers), offset);
+
+    if (!result.ok()) {
+      co_return cb(seq, getErrorJSON("fs.writev", desc->id, result.result), Post{});
+    }
+
+    desc->bytes += result.result;
+    invalidateMetadataCache(core, desc->path);
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.writev"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(desc->id)},
+        {"result", (int64_t) result.result}
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+
+  static Async<> writeAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    char* bytes,
+    size_t size,
+    size_t offset,
+    Core::Module::Callback cb
+  ) {
+    auto buffer = uv_buf_init(bytes, (unsigned int) size);
+    auto result = co_await getFS(core->getEventLoop(desc->id)).write(desc->fd, buffer, offset);
+
+    if (!result.ok()) {
+      co_return cb(seq, getErrorJSON("fs.write", desc->id, result.result), Post{});
+    }
+
+    desc->bytes += result.result;
+    invalidateMetadataCache(core, desc->path);
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.write"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(desc->id)},
+        {"result", (int64_t) result.result}
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+
+  static Async<> statAsync (Core* core, String seq, String path, Core::Module::Callback cb) {
+    auto cache = core->fs.getMetadataCache();
+    auto entry = MetadataCache::Entry {};
+    auto ticket = MetadataCache::UNCACHEABLE;
+
+    if (cache == nullptr || !cache->get(MetadataCache::Kind::Stat, path, 0, entry, ticket)) {
+      auto result = co_await getFS(core->getEventLoop()).stat(path);
+      entry.result = (int) result.result;
+      entry.stat = result.stat;
+
+      if (cache != nullptr) {
+        cache->put(MetadataCache::Kind::Stat, path, 0, entry, ticket);
+      }
+    }
+
+    if (entry.result < 0) {
+      co_return cb(seq, getErrorJSON("fs.stat", entry.result), Post{});
+    }
+
+    cb(seq, getStatsJSON("fs.stat", &entry.stat), Post{});
+  }
+
+  static Async<> lstatAsync (Core* core, String seq, String path, Core::Module::Callback cb) {
+    auto cache = core->fs.getMetadataCache();
+    auto entry = MetadataCache::Entry {};
+    auto ticket = MetadataCache::UNCACHEABLE;
+
+    if (cache == nullptr || !cache->get(MetadataCache::Kind::LStat, path, 0, entry, ticket)) {
+      auto result = co_await getFS(core->getEventLoop()).lstat(path);
+      entry.result = (int) result.result;
+      entry.stat = result.stat;
+
+      if (cache != nullptr) {
+        cache->put(MetadataCache::Kind::LStat, path, 0, entry, ticket);
+      }
+    }
+
+    if (entry.result < 0) {
+      co_return cb(seq, getErrorJSON("fs.stat", entry.result), Post{});
+    }
+
+    cb(seq, getStatsJSON("fs.lstat", &entry.stat), Post{});
+  }
+
+  static Async<> fstatAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    Core::Module::Callback cb
+  ) {
+    auto result = co_await getFS(core->getEventLoop(desc->id)).fstat(desc->fd);
+
+    if (!result.ok()) {
+      co_return cb(seq, getErrorJSON("fs.fstat", desc->id, result.result), Post{});
+    }
+
+    cb(seq, getStatsJSON("fs.fstat", &result.stat), Post{});
+  }
+
+  static Async<> fsyncAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    bool datasync,
+    Core::Module::Callback cb
+  ) {
+    auto fs = getFS(core->getEventLoop(desc->id));
+    auto result = datasync
+      ? co_await fs.fdatasync(desc->fd)
+      : co_await fs.fsync(desc->fd);
+
+    if (!result.ok()) {
+      co_return cb(seq, getErrorJSON("fs.fsync", desc->id, result.result), Post{});
+    }
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.fsync"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(desc->id)},
+        {"fd", desc->fd}
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+
+  // an entry read by `readdirPlus()`, `err` is set if it couldn't be stat'ed
+  struct DirentStats {
+    int type = UV_DIRENT_UNKNOWN;
+    String name;
+    int err = 0;
+    uv_stat_t stat;
+  };
+
+#if defined(_WIN32)
+  static int lstatAt (uv_loop_t* loop, const String& directory, const String& name, uv_stat_t* stats) {
+    uv_fs_t req;
+    const auto path = directory + "\\" + name;
+    // no callback, so the request runs synchronously on this thread
+    const auto err = uv_fs_lstat(loop, &req, path.c_str(), nullptr);
+
+    if (err == 0) {
+      *stats = req.statbuf;
+    }
+
+    uv_fs_req_cleanup(&req);
+    return err;
+  }
+#else
+  static int lstatAt (uv_loop_t* loop, int dirfd, const String& name, uv_stat_t* stats) {
+    struct stat source;
+
+    if (fstatat(dirfd, name.c_str(), &source, AT_SYMLINK_NOFOLLOW) < 0) {
+      return -errno;
+    }
+
+    stats->st_dev = source.st_dev;
+    stats->st_mode = source.st_mode;
+    stats->st_nlink = source.st_nlink;
+    stats->st_uid = source.st_uid;
+    stats->st_gid = source.st_gid;
+    stats->st_rdev = source.st_rdev;
+    stats->st_ino = source.st_ino;
+    stats->st_size = source.st_size;
+    stats->st_blksize = source.st_blksize;
+    stats->st_blocks = source.st_blocks;
+  #if defined(__APPLE__)
+    stats->st_atim.tv_sec = source.st_atimespec.tv_sec;
+    stats->st_atim.tv_nsec = source.st_atimespec.tv_nsec;
+    stats->st_mtim.tv_sec = source.st_mtimespec.tv_sec;
+    stats->st_mtim.tv_nsec = source.st_mtimespec.tv_nsec;
+    stats->st_ctim.tv_sec = source.st_ctimespec.tv_sec;
+    stats->st_ctim.tv_nsec = source.st_ctimespec.tv_nsec;
+    stats->st_birthtim.tv_sec = source.st_birthtimespec.tv_sec;
+    stats->st_birthtim.tv_nsec = source.st_birthtimespec.tv_nsec;
+    stats->st_flags = source.st_flags;
+    stats->st_gen = source.st_gen;
+  #else
+    stats->st_atim.tv_sec = source.st_atim.tv_sec;
+    stats->st_atim.tv_nsec = source.st_atim.tv_nsec;
+    stats->st_mtim.tv_sec = source.st_mtim.tv_sec;
+    stats->st_mtim.tv_nsec = source.st_mtim.tv_nsec;
+    stats->st_ctim.tv_sec = source.st_ctim.tv_sec;
+    stats->st_ctim.tv_nsec = source.st_ctim.tv_nsec;
+    // like libuv, there is no birth time in `struct stat` here
+    stats->st_birthtim.tv_sec = source.st_ctim.tv_sec;
+    stats->st_birthtim.tv_nsec = source.st_ctim.tv_nsec;
+    stats->st_flags = 0;
+    stats->st_gen = 0;
+  #endif
+    return 0;
+  }
+#endif
+
+  static JSON::Object getReaddirPlusJSON (const Vector<DirentStats>& entries) {
+    Vector<JSON::Any> data;
+    data.reserve(entries.size());
+
+    for (const auto& entry : entries) {
+      if (entry.err < 0) {
+        data.push_back(JSON::Object::Entries {
+          {"type", entry.type},
+          {"name", entry.name},
+          {"err", JSON::Object::Entries {
+            {"code", entry.err},
+            {"message", String(uv_strerror(entry.err))}
+          }}
+        });
+      } else {
+        data.push_back(JSON::Object::Entries {
+          {"type", entry.type},
+          {"name", entry.name},
+          {"stats", getStatsEntries(&entry.stat)}
+        });
+      }
+    }
+
+    return JSON::Object::Entries {
+      {"source", "fs.readdirPlus"},
+      {"data", data}
+    };
+  }
+
+  // packs `entries` as described by `Core::FS::readdirPlus()`, every
+  // supported target is little endian so values are copied as they are
+  static Post getReaddirPlusPost (const Vector<DirentStats>& entries) {
+    size_t size = 0;
+    for (const auto& entry : entries) {
+      size += Core::FS::READDIR_PLUS_RECORD_SIZE + entry.name.size();
+    }
+
+    auto bytes = BufferPool::allocate(size);
+    auto cursor = bytes;
+    const auto put = [&cursor](auto value) {
+      memcpy(cursor, &value, sizeof(value));
+      cursor += sizeof(value);
+    };
+
+    for (const auto& entry : entries) {
+      const auto ok = entry.err == 0;
+      const auto& stat = entry.stat;
+
+      put((uint16_t) entry.name.size());
+      put((uint8_t) entry.type);
+      put((uint8_t) ok);
+
+      for (const auto value : {
+        stat.st_dev, stat.st_mode, stat.st_nlink, stat.st_uid,
+        stat.st_gid, stat.st_rdev, stat.st_ino, stat.st_size,
+        stat.st_blksize, stat.st_blocks, stat.st_flags, stat.st_gen
+      }) {
+        put((uint64_t) (ok ? value : 0));
+      }
+
+      for (const auto& time : { stat.st_atim, stat.st_mtim, stat.st_ctim, stat.st_birthtim }) {
+        put((int64_t) (ok ? time.tv_sec : 0));
+        put((int64_t) (ok ? time.tv_nsec : 0));
+      }
+
+      memcpy(cursor, entry.name.data(), entry.name.size());
+      cursor += entry.name.size();
+    }
+
+    auto headers = Headers {{
+      {"content-type" ,"application/octet-stream"},
+      {"content-length", (uint64_t) size}
+    }};
+
+    Post post = {0};
+    post.id = SSC::rand64();
+    post.body = bytes;
+    post.length = size;
+    post.headers = headers.str();
+    post.pooled = true;
+    return post;
+  }
+
+  // reads entries on the loop, in `MAX_DIRENTS` chunks, then stats them on
+  // a worker so a large directory doesn't hold up the loop
+  static Async<> readdirPlusAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    size_t nentries,
+    bool binary,
+    Core::Module::Callback cb
+  ) {
+    auto loop = core->getEventLoop(desc->id);
+    auto fs = getFS(loop);
+    auto entries = Vector<DirentStats>();
+
+    if (desc->dirents == nullptr) {
+      desc->dirents = std::make_unique<uv_dirent_t[]>(Core::FS::MAX_DIRENTS);
+    }
+
+    while (entries.size() < nentries) {
+      desc->dir->dirents = desc->dirents.get();
+      desc->dir->nentries = std::min(nentries - entries.size(), Core::FS::MAX_DIRENTS);
+
+      auto result = co_await fs.readdir(desc->dir);
+
+      if (!result.ok()) {
+        co_return cb(seq, getErrorJSON("fs.readdirPlus", desc->id, result.result), Post{});
+      }
+
+      if (result.result == 0) {
+        break;
+      }
+
+      for (auto& entry : result.entries) {
+        entries.push_back(DirentStats { entry.first, std::move(entry.second) });
+      }
+    }
+
+  #if defined(_WIN32)
+    const auto directory = desc->path;
+  #else
+    // the worker stats through its own descriptor, so closing the
+    // directory meanwhile can't hand the number to another file
+    const auto directory = dup(dirfd(desc->dir->dir));
+
+    if (directory < 0) {
+      co_return cb(seq, getErrorJSON("fs.readdirPlus", desc->id, -errno), Post{});
+    }
+  #endif
+
+    core->workers.dispatch(
+      [loop, directory, binary, entries = std::move(entries)]() mutable {
+        for (auto& entry : entries) {
+          entry.err = lstatAt(loop, directory, entry.name, &entry.stat);
+        }
+
+      #if !defined(_WIN32)
+        ::close(directory);
+      #endif
+
+        return binary
+          ? std::make_pair(JSON::Object {}, getReaddirPlusPost(entries))
+          : std::make_pair(getReaddirPlusJSON(entries), Post {});
+      },
+      [seq, cb](std::pair<JSON::Object, Post> result) {
+        cb(seq, result.first, result.second);
+      }
+    );
+  }
+
+  // open, fstat, read and close in a single operation on the loop
+  static Async<> readFileAsync (
+    Core* core,
+    String seq,
+    String path,
+    int flags,
+    Core::Module::Callback cb
+  ) {
+    auto fs = getFS(core->getEventLoop());
+    auto opened = co_await fs.open(path, flags, 0);
+
+    if (!opened.ok()) {
+      co_return cb(seq, getErrorJSON("fs.readFile", opened.result), Post{});
+    }
+
+    const auto fd = (uv_file) opened.result;
+    auto stats = co_await fs.fstat(fd);
+
+    if (!stats.ok()) {
+      co_await fs.close(fd);
+      co_return cb(seq, getErrorJSON("fs.readFile", stats.result), Post{});
+    }
+
+    // files that report no size (procfs and friends) are read in chunks
+    // until EOF, others are read up to the size they had when opened
+    const auto expected = (size_t) stats.stat.st_size;
+    auto bytes = BufferPool::allocate(expected > 0 ? expected : 64 * 1024);
+    auto capacity = BufferPool::capacity(bytes);
+    size_t length = 0;
+
+    while (expected == 0 || length < expected) {
+      if (length == capacity) {
+        auto resized = BufferPool::allocate(capacity * 2);
+        memcpy(resized, bytes, length);
+        BufferPool::release(bytes);
+        bytes = resized;
+        capacity = BufferPool::capacity(bytes);
+      }
+
+      const auto size = std::min(capacity - length, Core::FS::MAX_IO_SIZE);
+      auto buffer = uv_buf_init(bytes + length, (unsigned int) size);
+      auto read = co_await fs.read(fd, buffer, (int64_t) length);
+
+      if (!read.ok()) {
+        BufferPool::release(bytes);
+        co_await fs.close(fd);
+        co_return cb(seq, getErrorJSON("fs.readFile", read.result), Post{});
+      }
+
+      if (read.result == 0) {
+        break;
+      }
+
+      length += read.result;
+    }
+
+    co_await fs.close(fd);
+
+    auto headers = Headers {{
+      {"content-type" ,"application/octet-stream"},
+      {"content-length", (uint64_t) length}
+    }};
+
+    Post post = {0};
+    post.id = SSC::rand64();
+    post.body = bytes;
+    post.length = length;
+    post.headers = headers.str();
+    post.pooled = true;
+
+    cb(seq, JSON::Object{}, post);
+  }
+
+  // with `recursive`, like `mkdir -p`: the whole path is tried first, then
+  // each of its components when an ancestor is missing
+  static Async<> mkdirAsync (
+    Core* core,
+    String seq,
+    String path,
+    int mode,
+    bool recursive,
+    Core::Module::Callback cb
+  ) {
+    auto fs = getFS(core->getEventLoop());
+    auto result = co_await fs.mkdir(path, mode);
+
+    if (recursive && result.result == UV_ENOENT) {
+      const auto target = std::filesystem::path(path);
+      auto current = target.root_path();
+
+      for (const auto& component : target.relative_path()) {
+        current /= component;
+        result = co_await fs.mkdir(current.string(), mode);
+
+        if (!result.ok() && result.result != UV_EEXIST) {
+          break;
+        }
+      }
+    }
+
+    if (recursive && result.result == UV_EEXIST) {
+      result.result = 0;
+    }
+
+    if (!result.ok()) {
+      co_return cb(seq, getErrorJSON("fs.mkdir", result.result), Post{});
+    }
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.mkdir"},
+      {"data", JSON::Object::Entries {
+        {"result", (int64_t) result.result},
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+
+  // open, write everything and close in a single operation on the loop,
+  // `bytes` is owned by the caller until `cb` is called
+  static Async<> writeFileAsync (
+    Core* core,
+    String seq,
+    String path,
+    char* bytes,
+    size_t size,
+    int flags,
+    int mode,
+    Core::Module::Callback cb
+  ) {
+    auto fs = getFS(core->getEventLoop());
+    auto opened = co_await fs.open(path, flags, mode);
+
+    if (!opened.ok()) {
+      co_return cb(seq, getErrorJSON("fs.writeFile", opened.result), Post{});
+    }
+
+    const auto fd = (uv_file) opened.result;
+    // appending writes go to the end of the file with no explicit offset
+    const auto append = (flags & O_APPEND) == O_APPEND;
+    size_t written = 0;
+
+    while (written < size) {
+      const auto length = std::min(size - written, Core::FS::MAX_IO_SIZE);
+      auto buffer = uv_buf_init(bytes + written, (unsigned int) length);
+      auto result = co_await fs.write(fd, buffer, append ? -1 : (int64_t) written);
+
+      // a write that makes no progress would never finish
+      if (result.ok() && result.result == 0) {
+        result.result = UV_EIO;
+      }
+
+      if (!result.ok()) {
+        co_await fs.close(fd);
+        co_return cb(seq, getErrorJSON("fs.writeFile", result.result), Post{});
+      }
+
+      written += result.result;
+    }
+
+    auto closed = co_await fs.close(fd);
+
+    if (!closed.ok()) {
+      co_return cb(seq, getErrorJSON("fs.writeFile", closed.result), Post{});
+    }
+
+    auto json = JSON::Object::Entries {
+      {"source", "fs.writeFile"},
+      {"data", JSON::Object::Entries {
+        {"result", (uint64_t) written}
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+
+	void Core::FS::RequestContext::setBuffer(char* base, uint32_t len) {
+		this->buf.base = base;
+		this->buf.len = len;
+  }
+
+  void Core::FS::RequestContext::freeBuffer() {
+    delete[] static_cast<char*>(this->buf.base);
+    this->buf.base = nullptr;
+    this->buf.len = 0;
+  }
+
+  char* Core::FS::RequestContext::getBuffer () {
+    return this->buf.base;
+  }
+
+  uint32_t Core::FS::RequestContext::getBufferSize () {
+    return this->buf.len;
+  }
+
+  Core::FS::Descriptor::Descriptor (Core *core, uint64_t id) {
+    this->core = core;
+    this->id = id;
+  }
+
+  bool Core::FS::Descriptor::isDirectory () {
+    Lock lock(this->mutex);
+    return this->dir != nullptr;
+  }
+
+  bool Core::FS::Descriptor::isFile () {
+    Lock lock(this->mutex);
+    return this->fd > 0 && this->dir == nullptr;
+  }
+
+  bool Core::FS::Descriptor::isRetained () {
+    return this->retained;
+  }
+
+  bool Core::FS::Descriptor::isStale () {
+    return this->stale;
+  }
+
+  Core::FS::Descriptor * Core::FS::getDescriptor (uint64_t id) {
+    Lock lock(this->mutex);
+    return descriptors.get(id);
+  }
+
+  void Core::FS::removeDescriptor (uint64_t id) {
+    Lock lock(this->mutex);
+    descriptors.remove(id);
+  }
+
+  bool Core::FS::hasDescriptor (uint64_t id) {
+    Lock lock(this->mutex);
+    return descriptors.has(id);
+  }
+
+  MetadataCache* Core::FS::getMetadataCache () {
+    std::call_once(this->metadataCacheFlag, [this]() {
+      static auto userConfig = getUserConfig();
+      auto options = MetadataCache::Options {};
+
+      if (userConfig["core_fs_metadata_cache"] != "true") {
+        return;
+      }
+
+      try {
+        options.capacity = std::stoull(userConfig["core_fs_metadata_cache_size"]);
+      } catch (...) {}
+
+      try {
+        options.ttl = std::stoull(userConfig["core_fs_metadata_cache_ttl"]);
+      } catch (...) {}
+
+      this->metadataCache.reset(new MetadataCache(this->core->getEventLoop(), options));
+    });
+
+    return this->metadataCache.get();
+  }
+
+  void Core::FS::retainOpenDescriptor (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    auto desc = getDescriptor(id);
+
+    if (desc == nullptr) {
+      auto json = JSON::Object::Entries {
+        {"source", "fs.retainOpenDescriptor"},
+        {"err", JSON::Object::Entries {
+          {"id", std::to_string(id)},
+          {"code", "ENOTOPEN"},
+          {"type", "NotFoundError"},
+          {"message", "No file descriptor found with that id"}
+        }}
+      };
+
+      return cb(seq, json, Post{});
+    }
+
+    desc->retained = true;
+    auto json = JSON::Object::Entries {
+      {"source", "fs.retainOpenDescriptor"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(desc->id)}
+      }}
+    };
+
+    cb(seq, json, Post{});
+  }
+
+  void Core::FS::access (
+    const String seq,
+    const String path,
+    int mode,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      accessAsync(this->core, seq, path, mode, cb).start();
+    });
+  }
+
+  void Core::FS::chmod (
+    const String seq,
+    const String path,
+    int mode,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      auto filename = path.c_str();
+      auto loop = &this->core->eventLoop;
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {path}, cb));
+      auto req = &ctx->req;
+      auto err = uv_fs_chmod(loop, req, filename, mode, [](uv_fs_t* req) {
+        auto ctx = (RequestContext *) req->data;
+        auto json = JSON::Object {};
+
+        if (uv_fs_get_result(req) < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.chmod"},
+            {"err", JSON::Object::Entries {
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.chmod"},
+            {"data", JSON::Object::Entries {
+              {"mode", req->flags},
+            }}
+          };
+        }
+
+        ctx->cb(ctx->seq, json, Post {});
+        delete ctx;
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.chmod"},
+          {"err", JSON::Object::Entries {
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete ctx;
+      }
+    });
+  }
+
+	void Core::FS::chown (
+    const String seq,
+    const String path,
+    uv_uid_t uid,
+    uv_gid_t gid,
+    Module::Callback cb
+  ) {
+    core->dispatchEventLoop([=, this]() {
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {path}, cb));
+      auto uv_cb = [](uv_fs_t* req) {
+        auto ctx = static_cast<RequestContext*>(req->data);
+        auto json = JSON::Object{};
+
+        if (uv_fs_get_result(req) < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.chown"},
+            {"err", JSON::Object::Entries {
+              {"code", uv_fs_get_result(req)},
+              {"message", String(uv_strerror(uv_fs_get_result(req)))}
+            }}
+          };
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.chown"},
+            {"data", JSON::Object::Entries {
+              {"mode", req->flags},
+            }}
+          };
+        }
+
+        ctx->cb(ctx->seq, json, Post {});
+        delete ctx;
+      };
+
+      auto err = uv_fs_chown(
+          &core->eventLoop, &ctx->req, path.c_str(), uid, gid, uv_cb);
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.chown"},
+          {"err", JSON::Object::Entries {
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+        ctx->cb(seq, json, Post{});
+        delete ctx;
+      }
+    });
+  }
+
+  void Core::FS::lchown (
+		const String seq,
+    const String path,
+    uv_uid_t uid,
+    uv_gid_t gid,
+    Module::Callback cb
+  ) {
+    core->dispatchEventLoop([=, this]() {
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {path}, cb));
+      auto uv_cb = [](uv_fs_t* req) {
+        auto ctx = static_cast<RequestContext*>(req->data);
         auto json = JSON::Object{};
 
         if (uv_fs_get_result(req) < 0) {
           json = JSON::Object::Entries {
-            {"source", "fs.lchown"},
+            {"source", "fs.lchown"},
+            {"err", JSON::Object::Entries {
+              {"code", uv_fs_get_result(req)},
+              {"message", String(uv_strerror(uv_fs_get_result(req)))}
+            }}
+          };
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.lchown"},
+            {"data", JSON::Object::Entries {
+              {"mode", req->flags},
+            }}
+          };
+        }
+
+        ctx->cb(ctx->seq, json, Post {});
+        delete ctx;
+      };
+
+      auto err = uv_fs_lchown(
+          &core->eventLoop, &ctx->req, path.c_str(), uid, gid, uv_cb);
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.lchown"},
+          {"err", JSON::Object::Entries {
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+        ctx->cb(seq, json, Post{});
+        delete ctx;
+      }
+    });
+  }
+
+  void Core::FS::close (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        return cb(seq, getNotOpenErrorJSON("fs.close", id), Post{});
+      }
+
+      closeAsync(this->core, seq, desc, cb).start();
+    });
+  }
+
+  void Core::FS::open (
+    const String seq,
+    uint64_t id,
+    int index,
+    const String path,
+    int flags,
+    int mode,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      openAsync(this->core, seq, id, index, path, flags, mode, cb).start();
+    });
+  }
+
+  void Core::FS::opendir (
+    const String seq,
+    uint64_t id,
+    int index,
+    const String path,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto filename = path.c_str();
+      auto desc =  new Descriptor(this->core, id);
+      desc->index = index;
+      desc->path = path;
+      auto loop = this->core->getEventLoop(id);
+      auto ctx = new RequestContext(desc, seq, cb);
+      auto req = &ctx->req;
+      auto err = uv_fs_opendir(loop, req, filename, [](uv_fs_t *req) {
+        auto ctx = (RequestContext *) req->data;
+        auto desc = ctx->desc;
+        auto json = JSON::Object {};
+
+        if (uv_fs_get_result(req) < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.opendir"},
+            {"err", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+
+          delete desc;
+        } else {
+          json = JSON::Object::Entries {
+            {"source", "fs.opendir"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)}
+            }}
+          };
+
+          desc->dir = (uv_dir_t *) req->ptr;
+          // insert into `descriptors` map
+          Lock lock(desc->core->fs.mutex);
+          desc->core->fs.descriptors.insert(desc->id, desc);
+        }
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete ctx;
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.opendir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(desc->id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete desc;
+        delete ctx;
+      }
+    });
+  }
+
+  void Core::FS::readdir (
+    const String seq,
+    uint64_t id,
+    size_t nentries,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.close"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"type", "NotFoundError"},
+            {"message", "No directory descriptor found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      if (!desc->isDirectory()) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.close"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"message", "No directory descriptor found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      Lock lock(desc->mutex);
+      auto loop = this->core->getEventLoop(id);
+      auto ctx = new RequestContext(desc, seq, cb);
+      auto req = &ctx->req;
+
+      if (desc->dirents == nullptr) {
+        desc->dirents = std::make_unique<uv_dirent_t[]>(MAX_DIRENTS);
+      }
+
+      desc->dir->dirents = desc->dirents.get();
+      desc->dir->nentries = std::min(nentries, MAX_DIRENTS);
+
+      auto err = uv_fs_readdir(loop, req, desc->dir, [](uv_fs_t *req) {
+        auto ctx = (RequestContext *) req->data;
+        auto desc = ctx->desc;
+        auto json = JSON::Object {};
+
+        if (uv_fs_get_result(req) < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.readdir"},
+            {"err", JSON::Object::Entries {
+              {"id", std::to_string(desc->id)},
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
+            }}
+          };
+        } else {
+          using Dirents = Vector<std::pair<int, String>>;
+          Dirents dirents;
+
+          // copy the entries out of the request so building the response
+          // can happen on a worker thread
+          for (int i = 0; i < req->result; ++i) {
+            dirents.emplace_back(
+              desc->dir->dirents[i].type,
+              desc->dir->dirents[i].name
+            );
+          }
+
+          auto core = desc->core;
+          auto seq = ctx->seq;
+          auto cb = ctx->cb;
+          delete ctx;
+
+          return core->workers.dispatch(
+            [dirents = std::move(dirents)]() {
+              Vector<JSON::Any> entries;
+
+              for (const auto& dirent : dirents) {
+                entries.push_back(JSON::Object::Entries {
+                  {"type", dirent.first},
+                  {"name", dirent.second}
+                });
+              }
+
+              return JSON::Object(JSON::Object::Entries {
+                {"source", "fs.readdir"},
+                {"data", entries}
+              });
+            },
+            [seq, cb](JSON::Object json) {
+              cb(seq, json, Post{});
+            }
+          );
+        }
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete ctx;
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.readdir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(desc->id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete ctx;
+      }
+    });
+  }
+
+  void Core::FS::readdirPlus (
+    const String seq,
+    uint64_t id,
+    size_t nentries,
+    bool binary,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr || !desc->isDirectory()) {
+        return cb(seq, getNotOpenErrorJSON("fs.readdirPlus", id), Post{});
+      }
+
+      const auto count = std::clamp(nentries, (size_t) 1, MAX_READDIR_PLUS_ENTRIES);
+      readdirPlusAsync(this->core, seq, desc, count, binary, cb).start();
+    });
+  }
+
+  void Core::FS::closedir (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.closedir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"type", "NotFoundError"},
+            {"message", "No directory descriptor found with that id"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      if (!desc->isDirectory()) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.closedir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(id)},
+            {"code", "ENOTOPEN"},
+            {"message", "The descriptor found with was not a directory"}
+          }}
+        };
+
+        return cb(seq, json, Post{});
+      }
+
+      auto loop = this->core->getEventLoop(id);
+      auto ctx = new RequestContext(desc, seq, cb);
+      auto req = &ctx->req;
+      auto err = uv_fs_closedir(loop, req, desc->dir, [](uv_fs_t* req) {
+        auto ctx = (RequestContext *) req->data;
+        auto desc = ctx->desc;
+        auto json = JSON::Object {};
+
+        if (uv_fs_get_result(req) < 0) {
+          json = JSON::Object::Entries {
+            {"source", "fs.closedir"},
             {"err", JSON::Object::Entries {
-              {"code", uv_fs_get_result(req)},
-              {"message", String(uv_strerror(uv_fs_get_result(req)))}
+              {"id", std::to_string(desc->id)},
+              {"code", req->result},
+              {"message", String(uv_strerror((int) req->result))}
             }}
           };
         } else {
           json = JSON::Object::Entries {
-            {"source", "fs.lchown"},
+            {"source", "fs.closedir"},
             {"data", JSON::Object::Entries {
-              {"mode", req->flags},
+              {"id", std::to_string(desc->id)},
+              {"fd", desc->fd}
+            }}
+          };
+
+          desc->core->fs.removeDescriptor(desc->id);
+          delete desc;
+        }
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete ctx;
+      });
+
+      if (err < 0) {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.closedir"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(desc->id)},
+            {"code", err},
+            {"message", String(uv_strerror(err))}
+          }}
+        };
+
+        ctx->cb(ctx->seq, json, Post{});
+        delete ctx;
+      }
+    });
+  }
+
+  void Core::FS::closeOpenDescriptor (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    auto desc = getDescriptor(id);
+
+    if (desc == nullptr) {
+      auto json = JSON::Object::Entries {
+        {"source", "fs.closeOpenDescriptor"},
+        {"err", JSON::Object::Entries {
+          {"id", std::to_string(id)},
+          {"code", "ENOTOPEN"},
+          {"type", "NotFoundError"},
+          {"message", "No descriptor found with that id"}
+        }}
+      };
+
+      return cb(seq, json, Post{});
+    }
+
+    if (desc->isDirectory()) {
+      this->closedir(seq, id, cb);
+    } else if (desc->isFile()) {
+      this->close(seq, id, cb);
+    }
+  }
+
+  void Core::FS::closeOpenDescriptors (const String seq, Module::Callback cb) {
+    return this->closeOpenDescriptors(seq, false, cb);
+  }
+
+  void Core::FS::closeOpenDescriptors (
+    const String seq,
+    bool preserveRetained,
+    Module::Callback cb
+  ) {
+    Lock lock(this->mutex);
+
+    auto pending = descriptors.size();
+    int queued = 0;
+    auto json = JSON::Object {};
+    // closing removes from `descriptors`
+    auto ids = descriptors.keys();
+
+    for (auto const id : ids) {
+      auto desc = descriptors.get(id);
+      pending--;
+
+      if (desc == nullptr) {
+        continue;
+      }
+
+      if (preserveRetained && desc->isRetained()) {
+        continue;
+      }
+
+      if (desc->isDirectory()) {
+        queued++;
+        this->closedir(seq, id, [pending, cb](auto seq, auto json, auto post) {
+          if (pending == 0) {
+            cb(seq, json, post);
+          }
+        });
+      } else if (desc->isFile()) {
+        queued++;
+        this->close(seq, id, [pending, cb](auto seq, auto json, auto post) {
+          if (pending == 0) {
+            cb(seq, json, post);
+          }
+        });
+      }
+    }
+
+    if (queued == 0) {
+      cb(seq, json, Post{});
+    }
+  }
+
+  void Core::FS::read (
+    const String seq,
+    uint64_t id,
+    size_t size,
+    size_t offset,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        return cb(seq, getNotOpenErrorJSON("fs.read", id), Post{});
+      }
+
+      readAsync(this->core, seq, desc, size, offset, cb).start();
+    });
+  }
+
+  void Core::FS::readv (
+    const String seq,
+    uint64_t id,
+    const Vector<size_t> sizes,
+    int64_t offset,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        return cb(seq, getNotOpenErrorJSON("fs.readv", id), Post{});
+      }
+
+      readvAsync(this->core, seq, desc, sizes, offset, cb).start();
+    });
+  }
+
+  void Core::FS::watch (
+    const String seq,
+    uint64_t id,
+    const String path,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+    #if defined(__ANDROID__)
+      auto json = JSON::Object::Entries {
+        {"source", "fs.watch"},
+        {"err", JSON::Object::Entries {
+          {"message", "Not supported"}
+        }}
+      };
+
+      cb(seq, json, Post{});
+      return;
+    #else
+      FileSystemWatcher* watcher;
+      {
+        Lock lock(this->mutex);
+        watcher = this->watchers[id];
+      }
+
+      if (watcher == nullptr) {
+        watcher = new FileSystemWatcher(path);
+        const auto started = watcher->start([=, this](
+          const auto& changed,
+          const auto& events,
+          const auto& context
+        ) mutable {
+          JSON::Array::Entries eventNames;
+
+          if (std::find(events.begin(), events.end(), FileSystemWatcher::Event::RENAME) != events.end()) {
+            eventNames.push_back("rename");
+          }
+
+          if (std::find(events.begin(), events.end(), FileSystemWatcher::Event::CHANGE) != events.end()) {
+            eventNames.push_back("change");
+          }
+
+          auto json = JSON::Object::Entries {
+            {"source", "fs.watch"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(id)},
+              {"events",eventNames},
+              {"path", std::filesystem::relative(changed, path).string()}
+            }}
+          };
+
+          cb("-1", json, Post{});
+        });
+
+        if (!started) {
+          auto json = JSON::Object::Entries {
+            {"source", "fs.watch"},
+            {"err", JSON::Object::Entries {
+              {"message", "Failed to start 'fs.Watcher'"}
             }}
           };
+
+          cb(seq, json, Post{});
+          return;
         }
 
-        ctx->cb(ctx->seq, json, Post {});
-        delete ctx;
+        {
+          Lock lock(this->mutex);
+          this->watchers.insert_or_assign(id, watcher);
+        }
+      }
+
+      auto json = JSON::Object::Entries {
+        {"source", "fs.watch"},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(id)}
+        }}
       };
 
-      auto err = uv_fs_lchown(
-          &core->eventLoop, &ctx->req, path.c_str(), uid, gid, uv_cb);
+      cb(seq, json, Post{});
+    #endif
+    });
+  }
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.lchown"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
-        ctx->cb(seq, json, Post{});
-        delete ctx;
+  void Core::FS::write (
+    const String seq,
+    uint64_t id,
+    char *bytes,
+    size_t size,
+    size_t offset,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
+
+      if (desc == nullptr) {
+        return cb(seq, getNotOpenErrorJSON("fs.write", id), Post{});
       }
+
+      writeAsync(this->core, seq, desc, bytes, size, offset, cb).start();
     });
   }
 
-  void Core::FS::close (
+  void Core::FS::writev (
     const String seq,
     uint64_t id,
+    char *bytes,
+    const Vector<size_t> sizes,
+    int64_t offset,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
+    this->core->dispatchEventLoop(id, [=, this]() {
       auto desc = getDescriptor(id);
 
       if (desc == nullptr) {
+        return cb(seq, getNotOpenErrorJSON("fs.writev", id), Post{});
+      }
+
+      writevAsync(this->core, seq, desc, bytes, sizes, offset, cb).start();
+    });
+  }
+
+  void Core::FS::stat (
+    const String seq,
+    const String path,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      statAsync(this->core, seq, path, cb).start();
+    });
+  }
+
+  void Core::FS::readFile (
+    const String seq,
+    const String path,
+    int flags,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      readFileAsync(this->core, seq, path, flags, cb).start();
+    });
+  }
+
+  void Core::FS::writeFile (
+    const String seq,
+    const String path,
+    char *bytes,
+    size_t size,
+    int flags,
+    int mode,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+      writeFileAsync(this->core, seq, path, bytes, size, flags, mode, invalidateMetadataCache(this->core, {path}, cb)).start();
+    });
+  }
+
+  void Core::FS::stopWatch (
+    const String seq,
+    uint64_t id,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop([=, this]() {
+    #if defined(__ANDROID__)
+      auto json = JSON::Object::Entries {
+        {"source", "fs.stopWatch"},
+        {"err", JSON::Object::Entries {
+          {"message", "Not supported"}
+        }}
+      };
+
+      cb(seq, json, Post{});
+      return;
+    #else
+      auto watcher = this->core->fs.watchers[id];
+      if (watcher != nullptr) {
+        watcher->stop();
+        delete watcher;
+        this->core->fs.watchers.erase(id);
         auto json = JSON::Object::Entries {
-          {"source", "fs.close"},
-          {"err", JSON::Object::Entries {
+          {"source", "fs.stopWatch"},
+          {"data", JSON::Object::Entries {
             {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
+          }}
+        };
+        cb(seq, json, Post{});
+      } else {
+        auto json = JSON::Object::Entries {
+          {"source", "fs.stat"},
+          {"err", JSON::Object::Entries {
             {"type", "NotFoundError"},
-            {"message", "No file descriptor found with that id"}
+            {"message", "fs.Watcher does not exist"}
           }}
         };
 
-        return cb(seq, json, Post{});
+        cb(seq, json, Post{});
       }
+    #endif
+    });
+  }
 
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_close(loop, req, desc->fd, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
+  /**
+   * The shared state of one `walk()`. Every directory is read by its own
+   * worker task, the last one to finish completes the walk.
+   */
+  struct Core::FS::Walk {
+    Core* core = nullptr;
+    uint64_t id = 0;
+    String seq;
+    String root;
+    WalkOptions options;
+    Module::Callback cb;
+
+    Atomic<bool> cancelled = false;
+    // directories queued or being read
+    Atomic<size_t> pending = 0;
+    Atomic<uint64_t> entries = 0;
+    Atomic<uint64_t> errors = 0;
+    // `fs.walk` events emitted, only used on the loop
+    uint64_t batches = 0;
+    // the error reading `root`, if any
+    int err = 0;
+
+    Mutex mutex;
+    Vector<JSON::Any> batch;
+    // directories entered through symbolic links, by device and inode
+    std::set<std::pair<uint64_t, uint64_t>> visited;
+  };
+
+  static bool matchWalkGlobs (const Vector<String>& globs, const String& path, const String& name) {
+    for (const auto& glob : globs) {
+      if (matchGlob(glob, glob.find('/') == String::npos ? name : path)) {
+        return true;
+      }
+    }
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.close"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.close"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"fd", desc->fd}
-            }}
-          };
+    return false;
+  }
 
-          desc->core->fs.removeDescriptor(desc->id);
-          delete desc;
-        }
+  static int getDirentType (uint64_t mode) {
+    switch (mode & S_IFMT) {
+      case S_IFREG: return UV_DIRENT_FILE;
+      case S_IFDIR: return UV_DIRENT_DIR;
+      case S_IFLNK: return UV_DIRENT_LINK;
+    #if defined(S_IFIFO)
+      case S_IFIFO: return UV_DIRENT_FIFO;
+    #endif
+    #if defined(S_IFSOCK)
+      case S_IFSOCK: return UV_DIRENT_SOCKET;
+    #endif
+      case S_IFCHR: return UV_DIRENT_CHAR;
+    #if defined(S_IFBLK)
+      case S_IFBLK: return UV_DIRENT_BLOCK;
+    #endif
+      default: return UV_DIRENT_UNKNOWN;
+    }
+  }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
+  // hands a batch of entries to the loop, which emits it ahead of the
+  // final reply queued by the last directory
+  static void emitWalkBatch (std::shared_ptr<Core::FS::Walk> walk, Vector<JSON::Any> batch) {
+    walk->core->dispatchEventLoop([walk, batch = std::move(batch)]() {
+      if (walk->cancelled) {
+        return;
+      }
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.close"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+      auto json = JSON::Object::Entries {
+        {"source", "fs.walk"},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(walk->id)},
+          {"entries", batch}
+        }}
+      };
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+      walk->batches++;
+      walk->cb("-1", json, Post{});
+    });
+  }
+
+  static void finishWalk (std::shared_ptr<Core::FS::Walk> walk) {
+    Vector<JSON::Any> batch;
+
+    {
+      Lock lock(walk->mutex);
+      batch = std::move(walk->batch);
+    }
+
+    if (batch.size() > 0) {
+      emitWalkBatch(walk, std::move(batch));
+    }
+
+    walk->core->dispatchEventLoop([walk]() {
+      {
+        Lock lock(walk->core->fs.mutex);
+        walk->core->fs.walks.erase(walk->id);
+      }
+
+      if (walk->err < 0) {
+        return walk->cb(walk->seq, getErrorJSON("fs.walk", walk->id, walk->err), Post{});
       }
+
+      auto json = JSON::Object::Entries {
+        {"source", "fs.walk"},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(walk->id)},
+          {"entries", walk->entries.load()},
+          {"errors", walk->errors.load()},
+          {"batches", walk->batches},
+          {"cancelled", walk->cancelled.load()}
+        }}
+      };
+
+      walk->cb(walk->seq, json, Post{});
     });
   }
 
-  void Core::FS::open (
-    const String seq,
-    uint64_t id,
-    const String path,
-    int flags,
-    int mode,
-    Module::Callback cb
-  ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto desc = new Descriptor(this->core, id);
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_open(loop, req, filename, flags, mode, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
+  // reads one directory with a synchronous `uv_fs_scandir()` on a worker,
+  // queueing a task for each subdirectory it enters
+  static void walkDirectory (std::shared_ptr<Core::FS::Walk> walk, String relative, int depth) {
+    const auto& options = walk->options;
+    const auto directory = relative.size() > 0 ? walk->root + "/" + relative : walk->root;
+    // synchronous requests don't use the loop
+    const auto loop = walk->core->getEventLoop();
+    uv_fs_t req;
+    uv_dirent_t dirent;
+
+    const auto count = walk->cancelled
+      ? UV_ECANCELED
+      : uv_fs_scandir(loop, &req, directory.c_str(), 0, nullptr);
+
+    if (count < 0 && count != UV_ECANCELED) {
+      if (relative.size() > 0) {
+        walk->errors++;
+      } else {
+        walk->err = count;
+      }
+    }
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.open"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
+    while (count >= 0 && !walk->cancelled && uv_fs_scandir_next(&req, &dirent) != UV_EOF) {
+      const auto name = String(dirent.name);
+      const auto path = relative.size() > 0 ? relative + "/" + name : name;
+      const auto target = directory + "/" + name;
+      auto type = (int) dirent.type;
+      auto follow = options.followSymlinks && type == UV_DIRENT_LINK;
 
-          delete desc;
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.open"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"fd", (int) req->result}
-            }}
-          };
+      if (matchWalkGlobs(options.exclude, path, name)) {
+        continue;
+      }
 
-          desc->fd = (int) req->result;
-          // insert into `descriptors` map
-          Lock lock(desc->core->fs.mutex);
-          desc->core->fs.descriptors.insert_or_assign(desc->id, desc);
+      uv_stat_t stat;
+      auto hasStat = false;
+
+      if (options.withStats || follow || type == UV_DIRENT_UNKNOWN) {
+        uv_fs_t statReq;
+        const auto err = follow
+          ? uv_fs_stat(loop, &statReq, target.c_str(), nullptr)
+          : uv_fs_lstat(loop, &statReq, target.c_str(), nullptr);
+
+        if (err == 0) {
+          stat = statReq.statbuf;
+          hasStat = true;
+          type = getDirentType(stat.st_mode);
+        }
+
+        uv_fs_req_cleanup(&statReq);
+      }
+
+      if (options.include.empty() || matchWalkGlobs(options.include, path, name)) {
+        auto entry = JSON::Object::Entries {
+          {"path", path},
+          {"type", type}
+        };
+
+        if (options.withStats && hasStat) {
+          entry["stats"] = getStatsEntries(&stat);
         }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
+        Vector<JSON::Any> batch;
+
+        {
+          Lock lock(walk->mutex);
+          walk->batch.push_back(entry);
+
+          if (walk->batch.size() >= options.batchSize) {
+            batch = std::move(walk->batch);
+            walk->batch = {};
+          }
+        }
+
+        walk->entries++;
+
+        if (batch.size() > 0) {
+          emitWalkBatch(walk, std::move(batch));
+        }
+      }
+
+      if (type != UV_DIRENT_DIR || (options.depth >= 0 && depth >= options.depth)) {
+        continue;
+      }
+
+      // a link back up the tree would be walked forever
+      if (follow && hasStat) {
+        Lock lock(walk->mutex);
+        if (!walk->visited.emplace(stat.st_dev, stat.st_ino).second) {
+          continue;
+        }
+      }
+
+      walk->pending++;
+      walk->core->workers.dispatch(Task([walk, path, depth]() {
+        walkDirectory(walk, path, depth + 1);
+      }));
+    }
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.open"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    if (count >= 0) {
+      uv_fs_req_cleanup(&req);
+    }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete desc;
-        delete ctx;
-      }
-    });
+    if (--walk->pending == 0) {
+      finishWalk(walk);
+    }
   }
 
-  void Core::FS::opendir (
+  void Core::FS::walk (
     const String seq,
     uint64_t id,
     const String path,
+    const WalkOptions options,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto desc =  new Descriptor(this->core, id);
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_opendir(loop, req, filename, [](uv_fs_t *req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
+    auto walk = std::make_shared<Walk>();
+    walk->core = this->core;
+    walk->id = id;
+    walk->seq = seq;
+    walk->root = path;
+    walk->options = options;
+    walk->options.batchSize = std::max(options.batchSize, (size_t) 1);
+    walk->cb = cb;
+    walk->pending = 1;
+
+    {
+      Lock lock(this->mutex);
+      this->walks.insert_or_assign(id, walk);
+    }
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.opendir"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
+    this->core->workers.dispatch(Task([walk]() {
+      walkDirectory(walk, "", 1);
+    }));
+  }
 
-          delete desc;
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.opendir"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)}
-            }}
-          };
+  struct HashResult {
+    String path;
+    String digest;
+    uint64_t size = 0;
+    int err = 0;
+  };
 
-          desc->dir = (uv_dir_t *) req->ptr;
-          // insert into `descriptors` map
-          Lock lock(desc->core->fs.mutex);
-          desc->core->fs.descriptors.insert_or_assign(desc->id, desc);
-        }
+  // reads `path` with synchronous requests, on a worker
+  static HashResult hashFile (uv_loop_t* loop, const String& path, Hasher::Algorithm algorithm) {
+    static constexpr size_t HASH_READ_SIZE = 1024 * 1024;
+    thread_local auto buffer = std::make_unique<char[]>(HASH_READ_SIZE);
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
+    auto hasher = Hasher(algorithm);
+    auto result = HashResult { path };
+    uv_fs_t req;
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.opendir"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    const auto fd = uv_fs_open(loop, &req, path.c_str(), UV_FS_O_RDONLY, 0, nullptr);
+    uv_fs_req_cleanup(&req);
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete desc;
-        delete ctx;
+    if (fd < 0) {
+      result.err = fd;
+      return result;
+    }
+
+  #if defined(__linux__) && !defined(__ANDROID__)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+  #endif
+
+    while (true) {
+      auto buf = uv_buf_init(buffer.get(), (unsigned int) HASH_READ_SIZE);
+      const auto bytes = uv_fs_read(loop, &req, fd, &buf, 1, -1, nullptr);
+      uv_fs_req_cleanup(&req);
+
+      if (bytes <= 0) {
+        result.err = bytes < 0 ? bytes : 0;
+        break;
       }
-    });
+
+      hasher.update(reinterpret_cast<const unsigned char*>(buffer.get()), bytes);
+      result.size += bytes;
+    }
+
+    uv_fs_close(loop, &req, fd, nullptr);
+    uv_fs_req_cleanup(&req);
+
+    if (result.err == 0) {
+      result.digest = hasher.hexdigest();
+    }
+
+    return result;
   }
 
-  void Core::FS::readdir (
+  static JSON::Object getHashResultJSON (const HashResult& result) {
+    if (result.err < 0) {
+      return JSON::Object::Entries {
+        {"path", result.path},
+        {"err", JSON::Object::Entries {
+          {"code", result.err},
+          {"message", String(uv_strerror(result.err))}
+        }}
+      };
+    }
+
+    return JSON::Object::Entries {
+      {"path", result.path},
+      {"digest", result.digest},
+      {"size", result.size}
+    };
+  }
+
+  void Core::FS::hash (
     const String seq,
-    uint64_t id,
-    size_t nentries,
+    const String path,
+    Hasher::Algorithm algorithm,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto desc = getDescriptor(id);
-
-      if (desc == nullptr) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.close"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"type", "NotFoundError"},
-            {"message", "No directory descriptor found with that id"}
-          }}
-        };
+    auto loop = this->core->getEventLoop();
 
-        return cb(seq, json, Post{});
+    this->core->workers.dispatch([=]() {
+      return hashFile(loop, path, algorithm);
+    }, [=](HashResult result) {
+      if (result.err < 0) {
+        return cb(seq, getErrorJSON("fs.hash", result.err), Post{});
       }
 
-      if (!desc->isDirectory()) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.close"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"message", "No directory descriptor found with that id"}
-          }}
-        };
+      auto json = JSON::Object::Entries {
+        {"source", "fs.hash"},
+        {"data", JSON::Object::Entries {
+          {"algorithm", Hasher::getName(algorithm)},
+          {"digest", result.digest},
+          {"size", result.size}
+        }}
+      };
 
-        return cb(seq, json, Post{});
-      }
+      cb(seq, json, Post{});
+    });
+  }
 
-      Lock lock(desc->mutex);
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
+  void Core::FS::hash (
+    const String seq,
+    const Vector<String> paths,
+    Hasher::Algorithm algorithm,
+    Module::Callback cb
+  ) {
+    // filled in by the `done` callbacks, which run on the loop
+    struct Batch {
+      Vector<JSON::Any> results;
+      size_t pending = 0;
+    };
 
-      desc->dir->dirents = ctx->dirents;
-      desc->dir->nentries = nentries;
+    auto loop = this->core->getEventLoop();
+    auto batch = std::make_shared<Batch>();
+    batch->results.resize(paths.size());
+    batch->pending = paths.size();
 
-      auto err = uv_fs_readdir(loop, req, desc->dir, [](uv_fs_t *req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
+    const auto reply = [=]() {
+      auto json = JSON::Object::Entries {
+        {"source", "fs.hash"},
+        {"data", JSON::Object::Entries {
+          {"algorithm", Hasher::getName(algorithm)},
+          {"results", batch->results}
+        }}
+      };
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.readdir"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          Vector<JSON::Any> entries;
+      cb(seq, json, Post{});
+    };
 
-          for (int i = 0; i < req->result; ++i) {
-            auto entry = JSON::Object::Entries {
-              {"type", desc->dir->dirents[i].type},
-              {"name", desc->dir->dirents[i].name}
-            };
+    if (paths.size() == 0) {
+      return this->core->dispatchEventLoop(reply);
+    }
 
-            entries.push_back(entry);
-          }
+    // a task per path, so the workers hash files in parallel
+    for (size_t i = 0; i < paths.size(); ++i) {
+      this->core->workers.dispatch([=, path = paths[i]]() {
+        return hashFile(loop, path, algorithm);
+      }, [=](HashResult result) {
+        batch->results[i] = getHashResultJSON(result);
 
-          json = JSON::Object::Entries {
-            {"source", "fs.readdir"},
-            {"data", entries}
-          };
+        if (--batch->pending == 0) {
+          reply();
         }
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
       });
+    }
+  }
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.readdir"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+  /**
+   * A chunked response of the bytes of a descriptor. Reads are started in
+   * file order, and complete in any order, so each is sent once the reads
+   * before it were.
+   */
+  struct FileStream {
+    struct Chunk {
+      char* bytes = nullptr;
+      ssize_t result = 0;
+      bool done = false;
+    };
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+    Core* core = nullptr;
+    uint64_t id = 0;
+    std::shared_ptr<std::function<bool(const char*, size_t, bool)>> send;
+    // offset of the next read and of the end of the stream (exclusive)
+    uint64_t position = 0;
+    uint64_t end = 0;
+    size_t chunkSize = 0;
+    size_t window = 0;
+    // reads in flight or done and not sent yet, in file order
+    std::deque<std::shared_ptr<Chunk>> chunks;
+    bool finished = false;
+  };
+
+  static void pumpFileStream (std::shared_ptr<FileStream> stream);
+
+  static Async<> readFileStreamChunkAsync (
+    std::shared_ptr<FileStream> stream,
+    std::shared_ptr<FileStream::Chunk> chunk,
+    uint64_t offset,
+    size_t size
+  ) {
+    auto core = stream->core;
+    auto desc = core->fs.getDescriptor(stream->id);
+
+    if (desc == nullptr) {
+      chunk->result = UV_EBADF;
+    } else {
+      auto buffer = uv_buf_init(chunk->bytes, (unsigned int) size);
+      auto fs = getFS(core->getEventLoop(stream->id));
+      auto result = co_await fs.read(desc->fd, buffer, offset);
+      chunk->result = result.result;
+
+      // the descriptor may have been closed while reading
+      if (result.ok() && (desc = core->fs.getDescriptor(stream->id)) != nullptr) {
+        desc->bytes += result.result;
       }
-    });
+    }
+
+    chunk->done = true;
+    pumpFileStream(stream);
   }
 
-  void Core::FS::closedir (
-    const String seq,
-    uint64_t id,
-    Module::Callback cb
-  ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto desc = getDescriptor(id);
+  // sends the chunks that are done, in order, and tops the reads in flight
+  // up to the window
+  static void pumpFileStream (std::shared_ptr<FileStream> stream) {
+    while (stream->chunks.size() > 0 && stream->chunks.front()->done) {
+      const auto chunk = stream->chunks.front();
+      stream->chunks.pop_front();
+
+      if (!stream->finished) {
+        if (chunk->result <= 0) {
+          // a read error or the file shrank, the client sees a short response
+          stream->finished = true;
+          (*stream->send)(nullptr, 0, true);
+        } else if (!(*stream->send)(chunk->bytes, chunk->result, false)) {
+          // the request was cancelled
+          stream->finished = true;
+        }
+      }
 
-      if (desc == nullptr) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.closedir"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"type", "NotFoundError"},
-            {"message", "No directory descriptor found with that id"}
-          }}
-        };
+      BufferPool::release(chunk->bytes);
+    }
 
-        return cb(seq, json, Post{});
-      }
+    while (
+      !stream->finished &&
+      stream->chunks.size() < stream->window &&
+      stream->position < stream->end
+    ) {
+      const auto size = (size_t) std::min((uint64_t) stream->chunkSize, stream->end - stream->position);
+      auto chunk = std::make_shared<FileStream::Chunk>();
+      // the kernel overwrites what is read, so the buffer is not zero filled
+      chunk->bytes = BufferPool::allocate(size);
+      stream->chunks.push_back(chunk);
+      readFileStreamChunkAsync(stream, chunk, stream->position, size).start();
+      stream->position += size;
+    }
 
-      if (!desc->isDirectory()) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.closedir"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"message", "The descriptor found with was not a directory"}
-          }}
-        };
+    if (!stream->finished && stream->chunks.empty() && stream->position >= stream->end) {
+      stream->finished = true;
+      (*stream->send)(nullptr, 0, true);
+    }
+  }
 
-        return cb(seq, json, Post{});
-      }
+  static Async<> streamAsync (
+    Core* core,
+    String seq,
+    Core::FS::Descriptor* desc,
+    std::shared_ptr<FileStream> stream,
+    int64_t end,
+    Core::Module::Callback cb
+  ) {
+    auto result = co_await getFS(core->getEventLoop(desc->id)).fstat(desc->fd);
 
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_closedir(loop, req, desc->dir, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
+    if (!result.ok()) {
+      co_return cb(seq, getErrorJSON("fs.stream", stream->id, result.result), Post{});
+    }
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.closedir"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.closedir"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"fd", desc->fd}
-            }}
-          };
+    const auto size = (uint64_t) result.stat.st_size;
+    stream->end = end < 0 ? size : std::min((uint64_t) end, size);
+    stream->position = std::min(stream->position, stream->end);
 
-          desc->core->fs.removeDescriptor(desc->id);
-          delete desc;
-        }
+    auto headers = Headers {{
+      {"content-type", "application/octet-stream"},
+      {"x-fs-stream-length", stream->end - stream->position}
+    }};
+
+    Post post;
+    post.id = SSC::rand64();
+    post.headers = headers.str();
+    // replaced by the scheme handler when it replies with a chunked response
+    post.chunk_stream = std::make_shared<std::function<bool(const char*, size_t, bool)>>(
+      [](const char*, size_t, bool) { return false; }
+    );
+
+    stream->send = post.chunk_stream;
+    cb(seq, JSON::Object{}, post);
+    pumpFileStream(stream);
+  }
+
+  void Core::FS::stream (
+    const String seq,
+    uint64_t id,
+    uint64_t offset,
+    int64_t end,
+    size_t chunkSize,
+    size_t window,
+    Module::Callback cb
+  ) {
+    static auto userConfig = getUserConfig();
+
+    if (window == 0) {
+      try {
+        window = std::stoull(userConfig["core_fs_stream_window"]);
+      } catch (...) {
+        window = 4;
+      }
+    }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
+    auto stream = std::make_shared<FileStream>();
+    stream->core = this->core;
+    stream->id = id;
+    stream->position = offset;
+    stream->chunkSize = std::clamp(chunkSize, (size_t) 1024, (size_t) 16 * 1024 * 1024);
+    stream->window = std::clamp(window, (size_t) 1, (size_t) 64);
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.closedir"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+      if (desc == nullptr) {
+        return cb(seq, getNotOpenErrorJSON("fs.stream", id), Post{});
       }
+
+      streamAsync(this->core, seq, desc, stream, end, cb).start();
     });
   }
 
-  void Core::FS::closeOpenDescriptor (
+  void Core::FS::stopWalk (
     const String seq,
     uint64_t id,
     Module::Callback cb
   ) {
-    auto desc = getDescriptor(id);
+    std::shared_ptr<Walk> walk = nullptr;
 
-    if (desc == nullptr) {
+    {
+      Lock lock(this->mutex);
+      if (this->walks.contains(id)) {
+        walk = this->walks.at(id);
+      }
+    }
+
+    if (walk == nullptr) {
       auto json = JSON::Object::Entries {
-        {"source", "fs.closeOpenDescriptor"},
+        {"source", "fs.stopWalk"},
         {"err", JSON::Object::Entries {
           {"id", std::to_string(id)},
-          {"code", "ENOTOPEN"},
           {"type", "NotFoundError"},
-          {"message", "No descriptor found with that id"}
+          {"message", "No walk found with that id"}
         }}
       };
 
       return cb(seq, json, Post{});
     }
 
-    if (desc->isDirectory()) {
-      this->closedir(seq, id, cb);
-    } else if (desc->isFile()) {
-      this->close(seq, id, cb);
-    }
-  }
-
-  void Core::FS::closeOpenDescriptors (const String seq, Module::Callback cb) {
-    return this->closeOpenDescriptors(seq, false, cb);
-  }
+    // queued directories are skipped, the walk replies once the ones being
+    // read stop
+    walk->cancelled = true;
 
-  void Core::FS::closeOpenDescriptors (
-    const String seq,
-    bool preserveRetained,
-    Module::Callback cb
-  ) {
-    Lock lock(this->mutex);
+    auto json = JSON::Object::Entries {
+      {"source", "fs.stopWalk"},
+      {"data", JSON::Object::Entries {
+        {"id", std::to_string(id)}
+      }}
+    };
 
-    auto pending = descriptors.size();
-    int queued = 0;
-    auto json = JSON::Object {};
-    auto ids = Vector<uint64_t> {};
+    cb(seq, json, Post{});
+  }
 
-    for (auto const &tuple : descriptors) {
-      ids.push_back(tuple.first);
+  /**
+   * The state of one `rm()` or `cp()`, which runs on a single worker with
+   * synchronous requests.
+   */
+  struct TreeOperation {
+    Core* core = nullptr;
+    uint64_t id = 0;
+    String seq;
+    String source;
+    Core::Module::Callback cb;
+    // synchronous requests don't use the loop
+    uv_loop_t* loop = nullptr;
+
+    uint64_t entries = 0;
+    uint64_t bytes = 0;
+    uint64_t errors = 0;
+    // `entries` at the last progress event
+    uint64_t reported = 0;
+    // the first error and where it happened
+    int err = 0;
+    String path;
+    Vector<JSON::Any> pending;
+
+    void done (const uv_stat_t& stat) {
+      this->entries++;
+      this->bytes += S_ISREG(stat.st_mode) ? stat.st_size : 0;
+
+      if (this->entries - this->reported >= Core::FS::TREE_PROGRESS_ENTRIES) {
+        this->progress();
+      }
     }
 
-    for (auto const id : ids) {
-      auto desc = descriptors[id];
-      pending--;
-
-      if (desc == nullptr) {
-        descriptors.erase(id);
-        continue;
+    void fail (const String& path, int err) {
+      if (this->errors++ == 0) {
+        this->err = err;
+        this->path = path;
       }
 
-      if (preserveRetained && desc->isRetained()) {
-        continue;
-      }
+      this->pending.push_back(JSON::Object::Entries {
+        {"path", path},
+        {"code", err},
+        {"message", String(uv_strerror(err))}
+      });
 
-      if (desc->isDirectory()) {
-        queued++;
-        this->closedir(seq, id, [pending, cb](auto seq, auto json, auto post) {
-          if (pending == 0) {
-            cb(seq, json, post);
-          }
-        });
-      } else if (desc->isFile()) {
-        queued++;
-        this->close(seq, id, [pending, cb](auto seq, auto json, auto post) {
-          if (pending == 0) {
-            cb(seq, json, post);
-          }
-        });
+      if (this->pending.size() >= Core::FS::TREE_PROGRESS_ENTRIES) {
+        this->progress();
       }
     }
 
-    if (queued == 0) {
-      cb(seq, json, Post{});
-    }
-  }
+    // queued on the loop ahead of the reply queued when the worker is done
+    void progress () {
+      auto json = JSON::Object::Entries {
+        {"source", this->source},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(this->id)},
+          {"entries", this->entries},
+          {"bytes", this->bytes},
+          {"errors", this->pending}
+        }}
+      };
 
-  void Core::FS::read (
-    const String seq,
-    uint64_t id,
-    size_t size,
-    size_t offset,
-    Module::Callback cb
-  ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto desc = getDescriptor(id);
+      this->pending.clear();
+      this->reported = this->entries;
+      this->core->dispatchEventLoop([cb = this->cb, json]() {
+        cb("-1", json, Post{});
+      });
+    }
 
-      if (desc == nullptr) {
+    void reply () {
+      if (this->err < 0) {
         auto json = JSON::Object::Entries {
-          {"source", "fs.read"},
+          {"source", this->source},
           {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"type", "NotFoundError"},
-            {"message", "No file descriptor found with that id"}
+            {"id", std::to_string(this->id)},
+            {"code", this->err},
+            {"path", this->path},
+            {"errors", this->errors},
+            {"message", String(uv_strerror(this->err))}
           }}
         };
 
-        return cb(seq, json, Post{});
+        return this->cb(this->seq, json, Post{});
       }
 
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-      auto bytes = new char[size]{0};
+      auto json = JSON::Object::Entries {
+        {"source", this->source},
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(this->id)},
+          {"entries", this->entries},
+          {"bytes", this->bytes}
+        }}
+      };
 
-      ctx->setBuffer(bytes, size);
+      this->cb(this->seq, json, Post{});
+    }
+  };
+
+  // runs `submit(&req)` as a synchronous request
+  template <typename Submit>
+  static int runSync (Submit submit) {
+    uv_fs_t req;
+    const auto err = submit(&req);
+    uv_fs_req_cleanup(&req);
+    return err;
+  }
 
-      auto err = uv_fs_read(loop, req, desc->fd, &ctx->buf, 1, offset, [](uv_fs_t* req) {
-        auto ctx = static_cast<RequestContext*>(req->data);
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
-        Post post = {0};
+  static int statSync (uv_loop_t* loop, const String& path, uv_stat_t* stat, bool follow) {
+    uv_fs_t req;
+    const auto err = follow
+      ? uv_fs_stat(loop, &req, path.c_str(), nullptr)
+      : uv_fs_lstat(loop, &req, path.c_str(), nullptr);
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.read"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
+    if (err == 0) {
+      *stat = req.statbuf;
+    }
 
-          auto bytes = ctx->getBuffer();
-          if (bytes != nullptr) {
-            delete [] bytes;
-          }
-        } else {
-          auto headers = Headers {{
-            {"content-type" ,"application/octet-stream"},
-            {"content-length", req->result}
-          }};
-
-          post.id = SSC::rand64();
-          post.body = ctx->getBuffer();
-          post.length = (int) req->result;
-          post.headers = headers.str();
-        }
+    uv_fs_req_cleanup(&req);
+    return err;
+  }
 
-        ctx->cb(ctx->seq, json, post);
-        delete ctx;
-      });
+  static int scandirSync (uv_loop_t* loop, const String& path, Vector<String>& names) {
+    uv_fs_t req;
+    uv_dirent_t dirent;
+    const auto err = uv_fs_scandir(loop, &req, path.c_str(), 0, nullptr);
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.read"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    while (err >= 0 && uv_fs_scandir_next(&req, &dirent) != UV_EOF) {
+      names.push_back(dirent.name);
+    }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete [] bytes;
-        delete ctx;
-      }
-    });
+    uv_fs_req_cleanup(&req);
+    return err < 0 ? err : 0;
   }
 
-  void Core::FS::watch (
-    const String seq,
-    uint64_t id,
-    const String path,
-    Module::Callback cb
-  ) {
-    this->core->dispatchEventLoop([=, this]() {
-    #if defined(__ANDROID__)
-      auto json = JSON::Object::Entries {
-        {"source", "fs.watch"},
-        {"err", JSON::Object::Entries {
-          {"message", "Not supported"}
-        }}
-      };
+  static int readlinkSync (uv_loop_t* loop, const String& path, String& target) {
+    uv_fs_t req;
+    const auto err = uv_fs_readlink(loop, &req, path.c_str(), nullptr);
 
-      cb(seq, json, Post{});
-      return;
-    #else
-      FileSystemWatcher* watcher;
-      {
-        Lock lock(this->mutex);
-        watcher = this->watchers[id];
-      }
+    if (err == 0) {
+      target = String((const char*) req.ptr);
+    }
 
-      if (watcher == nullptr) {
-        watcher = new FileSystemWatcher(path);
-        const auto started = watcher->start([=, this](
-          const auto& changed,
-          const auto& events,
-          const auto& context
-        ) mutable {
-          JSON::Array::Entries eventNames;
+    uv_fs_req_cleanup(&req);
+    return err;
+  }
 
-          if (std::find(events.begin(), events.end(), FileSystemWatcher::Event::RENAME) != events.end()) {
-            eventNames.push_back("rename");
-          }
+  // depth first, entries that fail are reported and leave their
+  // directories in place
+  static int removeTree (TreeOperation& op, const String& path, bool recursive, bool force) {
+    const auto loop = op.loop;
+    uv_stat_t stat;
+    auto err = statSync(loop, path, &stat, false);
 
-          if (std::find(events.begin(), events.end(), FileSystemWatcher::Event::CHANGE) != events.end()) {
-            eventNames.push_back("change");
-          }
+    if (err < 0) {
+      return err;
+    }
 
-          auto json = JSON::Object::Entries {
-            {"source", "fs.watch"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(id)},
-              {"events",eventNames},
-              {"path", std::filesystem::relative(changed, path).string()}
-            }}
-          };
+    if (S_ISDIR(stat.st_mode)) {
+      Vector<String> names;
 
-          cb("-1", json, Post{});
-        });
+      if (!recursive) {
+        return UV_EISDIR;
+      }
 
-        if (!started) {
-          auto json = JSON::Object::Entries {
-            {"source", "fs.watch"},
-            {"err", JSON::Object::Entries {
-              {"message", "Failed to start 'fs.Watcher'"}
-            }}
-          };
+      if ((err = scandirSync(loop, path, names)) < 0) {
+        return err;
+      }
 
-          cb(seq, json, Post{});
-          return;
-        }
+      for (const auto& name : names) {
+        const auto child = path + "/" + name;
+        const auto result = removeTree(op, child, true, force);
 
-        {
-          Lock lock(this->mutex);
-          this->watchers.insert_or_assign(id, watcher);
+        if (result < 0 && !(force && result == UV_ENOENT)) {
+          op.fail(child, result);
         }
       }
 
-      auto json = JSON::Object::Entries {
-        {"source", "fs.watch"},
-        {"data", JSON::Object::Entries {
-          {"id", std::to_string(id)}
-        }}
-      };
+      err = runSync([&](uv_fs_t* req) {
+        return uv_fs_rmdir(loop, req, path.c_str(), nullptr);
+      });
+    } else {
+      err = runSync([&](uv_fs_t* req) {
+        return uv_fs_unlink(loop, req, path.c_str(), nullptr);
+      });
+    }
 
-      cb(seq, json, Post{});
-    #endif
-    });
+    if (err == 0) {
+      op.done(stat);
+    }
+
+    return err;
   }
 
-  void Core::FS::write (
-    const String seq,
-    uint64_t id,
-    char *bytes,
-    size_t size,
-    size_t offset,
-    Module::Callback cb
+  static int copyTree (
+    TreeOperation& op,
+    const String& src,
+    const String& dest,
+    const Core::FS::CopyOptions& options
   ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto desc = getDescriptor(id);
+    const auto loop = op.loop;
+    uv_stat_t stat;
+    auto err = statSync(loop, src, &stat, options.dereference);
 
-      if (desc == nullptr) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.write"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"type", "NotFoundError"},
-            {"message", "No file descriptor found with that id"}
-          }}
-        };
+    if (err < 0) {
+      return err;
+    }
 
-        return cb(seq, json, Post{});
+    if (S_ISDIR(stat.st_mode)) {
+      Vector<String> names;
+
+      if (!options.recursive) {
+        return UV_EISDIR;
+      }
+
+      err = runSync([&](uv_fs_t* req) {
+        return uv_fs_mkdir(loop, req, dest.c_str(), stat.st_mode & 0777, nullptr);
+      });
+
+      if (err == UV_EEXIST) {
+        uv_stat_t existing;
+        err = statSync(loop, dest, &existing, true);
+
+        if (err == 0 && !S_ISDIR(existing.st_mode)) {
+          return UV_ENOTDIR;
+        }
+      }
+
+      if (err < 0 || (err = scandirSync(loop, src, names)) < 0) {
+        return err;
+      }
+
+      for (const auto& name : names) {
+        const auto result = copyTree(op, src + "/" + name, dest + "/" + name, options);
+
+        if (result < 0) {
+          op.fail(src + "/" + name, result);
+        }
+      }
+    } else if (S_ISLNK(stat.st_mode)) {
+      String target;
+
+      if ((err = readlinkSync(loop, src, target)) < 0) {
+        return err;
       }
 
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
+      const auto symlink = [&]() {
+        return runSync([&](uv_fs_t* req) {
+          return uv_fs_symlink(loop, req, target.c_str(), dest.c_str(), 0, nullptr);
+        });
+      };
+
+      err = symlink();
 
-      ctx->setBuffer(bytes, size);
-      auto err = uv_fs_write(loop, req, desc->fd, &ctx->buf, 1, offset, [](uv_fs_t* req) {
-        auto ctx = static_cast<RequestContext*>(req->data);
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
+      if (err == UV_EEXIST && options.force) {
+        runSync([&](uv_fs_t* req) {
+          return uv_fs_unlink(loop, req, dest.c_str(), nullptr);
+        });
 
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.write"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.write"},
-            {"data", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"result", req->result}
-            }}
-          };
-        }
+        err = symlink();
+      }
+    } else if (S_ISREG(stat.st_mode)) {
+      // a reflink where supported, otherwise copied in the kernel
+      // (`copy_file_range(2)`, `sendfile(2)`, `copyfile(3)`)
+      const auto flags = UV_FS_COPYFILE_FICLONE | (options.force ? 0 : UV_FS_COPYFILE_EXCL);
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+      err = runSync([&](uv_fs_t* req) {
+        return uv_fs_copyfile(loop, req, src.c_str(), dest.c_str(), flags, nullptr);
       });
+    } else {
+      // pipes, sockets and devices
+      return UV_EINVAL;
+    }
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.write"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(desc->id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    if (err == UV_EEXIST && !options.force && !options.errorOnExist) {
+      return 0;
+    }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      }
-    });
+    if (err == 0) {
+      op.done(stat);
+    }
+
+    return err;
   }
 
-  void Core::FS::stat (
+  void Core::FS::rm (
     const String seq,
+    uint64_t id,
     const String path,
+    bool recursive,
+    bool force,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_stat(loop, req, filename, [](uv_fs_t *req) {
-        auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
-
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.stat"},
-            {"err", JSON::Object::Entries {
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = getStatsJSON("fs.stat", uv_fs_get_statbuf(req));
-        }
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
-
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.stat"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+    auto op = std::make_shared<TreeOperation>();
+    op->core = this->core;
+    op->id = id;
+    op->seq = seq;
+    op->source = "fs.rm";
+    op->cb = invalidateMetadataCache(this->core, {path}, cb);
+    op->loop = this->core->getEventLoop();
+
+    this->core->workers.dispatch([op, path, recursive, force]() {
+      const auto err = removeTree(*op, path, recursive, force);
+
+      if (err < 0 && !(force && err == UV_ENOENT)) {
+        op->fail(path, err);
+      }
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+      if (op->entries > op->reported || op->pending.size() > 0) {
+        op->progress();
       }
+
+      return op;
+    }, [](auto op) {
+      op->reply();
     });
   }
 
-  void Core::FS::stopWatch (
+  void Core::FS::cp (
     const String seq,
     uint64_t id,
+    const String src,
+    const String dest,
+    const CopyOptions options,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
-    #if defined(__ANDROID__)
-      auto json = JSON::Object::Entries {
-        {"source", "fs.stopWatch"},
-        {"err", JSON::Object::Entries {
-          {"message", "Not supported"}
-        }}
-      };
-
-      cb(seq, json, Post{});
-      return;
-    #else
-      auto watcher = this->core->fs.watchers[id];
-      if (watcher != nullptr) {
-        watcher->stop();
-        delete watcher;
-        this->core->fs.watchers.erase(id);
-        auto json = JSON::Object::Entries {
-          {"source", "fs.stopWatch"},
-          {"data", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-          }}
-        };
-        cb(seq, json, Post{});
+    auto op = std::make_shared<TreeOperation>();
+    op->core = this->core;
+    op->id = id;
+    op->seq = seq;
+    op->source = "fs.cp";
+    op->cb = invalidateMetadataCache(this->core, {dest}, cb);
+    op->loop = this->core->getEventLoop();
+
+    this->core->workers.dispatch([op, src, dest, options]() {
+      const auto from = std::filesystem::absolute(src).lexically_normal().string();
+      const auto to = std::filesystem::absolute(dest).lexically_normal().string();
+      auto err = 0;
+
+      // a directory copied into itself would never finish
+      if (options.recursive && (to == from || to.starts_with(from + "/"))) {
+        err = UV_EINVAL;
       } else {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.stat"},
-          {"err", JSON::Object::Entries {
-            {"type", "NotFoundError"},
-            {"message", "fs.Watcher does not exist"}
-          }}
-        };
+        err = copyTree(*op, src, dest, options);
+      }
 
-        cb(seq, json, Post{});
+      if (err < 0) {
+        op->fail(src, err);
       }
-    #endif
+
+      if (op->entries > op->reported || op->pending.size() > 0) {
+        op->progress();
+      }
+
+      return op;
+    }, [](auto op) {
+      op->reply();
     });
   }
 
@@ -1303,61 +2905,31 @@ namespace SSC {
     uint64_t id,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
+    this->core->dispatchEventLoop(id, [=, this]() {
       auto desc = getDescriptor(id);
 
       if (desc == nullptr) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.fstat"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", "ENOTOPEN"},
-            {"type", "NotFoundError"},
-            {"message", "No file descriptor found with that id"}
-          }}
-        };
-
-        return cb(seq, json, Post{});
+        return cb(seq, getNotOpenErrorJSON("fs.fstat", id), Post{});
       }
 
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(desc, seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_fstat(loop, req, desc->fd, [](uv_fs_t *req) {
-        auto ctx = (RequestContext *) req->data;
-        auto desc = ctx->desc;
-        auto json = JSON::Object {};
-
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.fstat"},
-            {"err", JSON::Object::Entries {
-              {"id", std::to_string(desc->id)},
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = getStatsJSON("fs.fstat", uv_fs_get_statbuf(req));
-        }
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
+      fstatAsync(this->core, seq, desc, cb).start();
+    });
+  }
 
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.fstat"},
-          {"err", JSON::Object::Entries {
-            {"id", std::to_string(id)},
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
+  void Core::FS::fsync (
+    const String seq,
+    uint64_t id,
+    bool datasync,
+    Module::Callback cb
+  ) {
+    this->core->dispatchEventLoop(id, [=, this]() {
+      auto desc = getDescriptor(id);
 
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
+      if (desc == nullptr) {
+        return cb(seq, getNotOpenErrorJSON("fs.fsync", id), Post{});
       }
+
+      fsyncAsync(this->core, seq, desc, datasync, cb).start();
     });
   }
 
@@ -1368,11 +2940,9 @@ namespace SSC {
     Lock lock(this->mutex);
     auto entries = Vector<JSON::Any> {};
 
-    for (auto const &tuple : descriptors) {
-      auto desc = tuple.second;
-
-      if (!desc || (desc->isStale() && !desc->isRetained())) {
-        continue;
+    descriptors.forEach([&entries](auto id, auto desc) {
+      if (desc->isStale() && !desc->isRetained()) {
+        return;
       }
 
       auto entry = JSON::Object::Entries {
@@ -1382,7 +2952,7 @@ namespace SSC {
       };
 
       entries.push_back(entry);
-    }
+    });
 
     auto json = JSON::Object::Entries {
       {"source", "fs.getOpenDescriptors"},
@@ -1398,42 +2968,7 @@ namespace SSC {
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
-      auto filename = path.c_str();
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
-      auto req = &ctx->req;
-      auto err = uv_fs_lstat(loop, req, filename, [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
-
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.stat"},
-            {"err", JSON::Object::Entries {
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = getStatsJSON("fs.lstat", uv_fs_get_statbuf(req));
-        }
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      });
-
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.stat"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      }
+      lstatAsync(this->core, seq, path, cb).start();
     });
   }
 
@@ -1444,7 +2979,7 @@ namespace SSC {
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {src, dest}, cb));
       auto uv_cb = [](uv_fs_t* req) {
         auto ctx = static_cast<RequestContext*>(req->data);
         auto json = JSON::Object{};
@@ -1495,7 +3030,7 @@ namespace SSC {
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {dest}, cb));
       auto uv_cb = [](uv_fs_t* req) {
         auto ctx = static_cast<RequestContext*>(req->data);
         auto json = JSON::Object{};
@@ -1546,7 +3081,7 @@ namespace SSC {
     this->core->dispatchEventLoop([=, this]() {
       auto filename = path.c_str();
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {path}, cb));
       auto req = &ctx->req;
       auto err = uv_fs_unlink(loop, req, filename, [](uv_fs_t* req) {
         auto ctx = (RequestContext *) req->data;
@@ -1694,7 +3229,7 @@ namespace SSC {
   ) {
     this->core->dispatchEventLoop([=, this]() {
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {pathA, pathB}, cb));
       auto req = &ctx->req;
       auto src = pathA.c_str();
       auto dst = pathB.c_str();
@@ -1747,7 +3282,7 @@ namespace SSC {
   ) {
     this->core->dispatchEventLoop([=, this]() {
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {pathB}, cb));
       auto req = &ctx->req;
       auto src = pathA.c_str();
       auto dst = pathB.c_str();
@@ -1799,7 +3334,7 @@ namespace SSC {
     this->core->dispatchEventLoop([=, this]() {
       auto filename = path.c_str();
       auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
+      auto ctx = new RequestContext(seq, invalidateMetadataCache(this->core, {path}, cb));
       auto req = &ctx->req;
       auto err = uv_fs_rmdir(loop, req, filename, [](uv_fs_t* req) {
         auto ctx = (RequestContext *) req->data;
@@ -1849,76 +3384,7 @@ namespace SSC {
     Module::Callback cb
   ) {
     this->core->dispatchEventLoop([=, this]() {
-      int err = 0;
-      auto filename = path.c_str();
-      auto loop = &this->core->eventLoop;
-      auto ctx = new RequestContext(seq, cb);
-      auto req = &ctx->req;
-      const auto callback = [](uv_fs_t* req) {
-        auto ctx = (RequestContext *) req->data;
-        auto json = JSON::Object {};
-
-        if (uv_fs_get_result(req) < 0) {
-          json = JSON::Object::Entries {
-            {"source", "fs.mkdir"},
-            {"err", JSON::Object::Entries {
-              {"code", req->result},
-              {"message", String(uv_strerror((int) req->result))}
-            }}
-          };
-        } else {
-          json = JSON::Object::Entries {
-            {"source", "fs.mkdir"},
-            {"data", JSON::Object::Entries {
-              {"result", req->result},
-            }}
-          };
-        }
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      };
-
-      if (!recursive) {
-        err = uv_fs_mkdir(loop, req, filename, mode, callback);
-      } else {
-        const auto sep = String(1, std::filesystem::path::preferred_separator);
-        const auto components = split(path, sep);
-        auto queue = std::queue(std::deque(components.begin(), components.end()));
-        auto currentComponents = Vector<String>();
-        while (queue.size() > 0) {
-          uv_fs_t req;
-          const auto currentComponent = queue.front();
-          queue.pop();
-          currentComponents.push_back(currentComponent);
-          const auto joinedComponents = join(currentComponents, sep);
-          const auto currentPath = joinedComponents.empty() ? sep : joinedComponents;
-          if (queue.size() == 0) {
-            err = uv_fs_mkdir(loop, &ctx->req, currentPath.c_str(), mode, callback);
-          } else {
-            err = uv_fs_mkdir(loop, &req, currentPath.c_str(), mode, nullptr);
-          }
-          if (err == 0 || err == -EEXIST) {
-            err = 0;
-            continue;
-          } else {
-            break;
-          }
-        }
-      }
-
-      if (err < 0) {
-        auto json = JSON::Object::Entries {
-          {"source", "fs.mkdir"},
-          {"err", JSON::Object::Entries {
-            {"code", err},
-            {"message", String(uv_strerror(err))}
-          }}
-        };
-
-        ctx->cb(ctx->seq, json, Post{});
-        delete ctx;
-      }
+      mkdirAsync(this->core, seq, path, mode, recursive, invalidateMetadataCache(this->core, {path}, cb)).start();
     });
   }
 
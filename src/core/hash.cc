@@ -0,0 +1,562 @@
+#include <cstring>
+
+#include "hash.hh"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SSC_HASH_X86_SHA 1
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
+
+namespace SSC {
+  static constexpr uint32_t SHA256_K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+  };
+
+  // also the BLAKE3 IV
+  static constexpr uint32_t SHA256_IV[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+  };
+
+  static constexpr uint32_t SHA1_IV[5] = {
+    0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+  };
+
+  static constexpr uint8_t BLAKE3_PERMUTATION[16] = {
+    2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8
+  };
+
+  static constexpr uint32_t BLAKE3_CHUNK_START = 1 << 0;
+  static constexpr uint32_t BLAKE3_CHUNK_END = 1 << 1;
+  static constexpr uint32_t BLAKE3_PARENT = 1 << 2;
+  static constexpr uint32_t BLAKE3_ROOT = 1 << 3;
+  static constexpr size_t BLAKE3_CHUNK_SIZE = 1024;
+
+  static inline uint32_t rotl (uint32_t value, int bits) {
+    return (value << bits) | (value >> (32 - bits));
+  }
+
+  static inline uint32_t rotr (uint32_t value, int bits) {
+    return (value >> bits) | (value << (32 - bits));
+  }
+
+  static inline uint32_t loadBigEndian (const unsigned char* bytes) {
+    return
+      ((uint32_t) bytes[0] << 24) |
+      ((uint32_t) bytes[1] << 16) |
+      ((uint32_t) bytes[2] << 8) |
+      ((uint32_t) bytes[3]);
+  }
+
+  static inline uint32_t loadLittleEndian (const unsigned char* bytes) {
+    return
+      ((uint32_t) bytes[0]) |
+      ((uint32_t) bytes[1] << 8) |
+      ((uint32_t) bytes[2] << 16) |
+      ((uint32_t) bytes[3] << 24);
+  }
+
+  static void compressSHA256 (uint32_t state[8], const unsigned char* blocks, size_t count) {
+    for (; count > 0; --count, blocks += 64) {
+      uint32_t w[64];
+
+      for (int i = 0; i < 16; ++i) {
+        w[i] = loadBigEndian(blocks + i * 4);
+      }
+
+      for (int i = 16; i < 64; ++i) {
+        const auto s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        const auto s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+      }
+
+      auto a = state[0], b = state[1], c = state[2], d = state[3];
+      auto e = state[4], f = state[5], g = state[6], h = state[7];
+
+      for (int i = 0; i < 64; ++i) {
+        const auto t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) + SHA256_K[i] + w[i];
+        const auto t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+      }
+
+      state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+      state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    }
+  }
+
+  static void compressSHA1 (uint32_t state[5], const unsigned char* blocks, size_t count) {
+    for (; count > 0; --count, blocks += 64) {
+      uint32_t w[80];
+
+      for (int i = 0; i < 16; ++i) {
+        w[i] = loadBigEndian(blocks + i * 4);
+      }
+
+      for (int i = 16; i < 80; ++i) {
+        w[i] = rotl(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+      }
+
+      auto a = state[0], b = state[1], c = state[2], d = state[3], e = state[4];
+
+      for (int i = 0; i < 80; ++i) {
+        uint32_t f = 0;
+        uint32_t k = 0;
+
+        if (i < 20) {
+          f = (b & c) | (~b & d);
+          k = 0x5a827999;
+        } else if (i < 40) {
+          f = b ^ c ^ d;
+          k = 0x6ed9eba1;
+        } else if (i < 60) {
+          f = (b & c) | (b & d) | (c & d);
+          k = 0x8f1bbcdc;
+        } else {
+          f = b ^ c ^ d;
+          k = 0xca62c1d6;
+        }
+
+        const auto t = rotl(a, 5) + f + e + k + w[i];
+        e = d; d = c; c = rotl(b, 30); b = a; a = t;
+      }
+
+      state[0] += a; state[1] += b; state[2] += c; state[3] += d; state[4] += e;
+    }
+  }
+
+#if SSC_HASH_X86_SHA
+  static bool hasSHAExtensions () {
+    static const auto supported = []() {
+      unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+      // leaf 7 `SHA` and leaf 1 `SSSE3` and `SSE4.1`
+      if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) || !(ebx & (1 << 29))) {
+        return false;
+      }
+
+      if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        return false;
+      }
+
+      return (ecx & (1 << 9)) != 0 && (ecx & (1 << 19)) != 0;
+    }();
+
+    return supported;
+  }
+
+  __attribute__((target("sha,sse4.1,ssse3")))
+  static void compressSHA256Extensions (uint32_t state[8], const unsigned char* blocks, size_t count) {
+    const auto mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // the instructions keep the state as `ABEF` and `CDGH`
+    auto tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) &state[0]), 0xb1);
+    auto state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) &state[4]), 0x1b);
+    auto state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    for (; count > 0; --count, blocks += 64) {
+      const auto abef = state0;
+      const auto cdgh = state1;
+      __m128i w[4];
+
+      for (int i = 0; i < 4; ++i) {
+        w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks + i * 16)), mask);
+      }
+
+      // four rounds at a time, `w[i % 4]` holds the words of round `4 * i`
+      for (int i = 0; i < 16; ++i) {
+        auto& words = w[i % 4];
+
+        if (i >= 4) {
+          words = _mm_sha256msg1_epu32(words, w[(i + 1) % 4]);
+          words = _mm_add_epi32(words, _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4));
+          words = _mm_sha256msg2_epu32(words, w[(i + 3) % 4]);
+        }
+
+        const auto wk = _mm_add_epi32(words, _mm_loadu_si128((const __m128i*) &SHA256_K[i * 4]));
+        state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+        state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0e));
+      }
+
+      state0 = _mm_add_epi32(state0, abef);
+      state1 = _mm_add_epi32(state1, cdgh);
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+    _mm_storeu_si128((__m128i*) &state[0], state0);
+    _mm_storeu_si128((__m128i*) &state[4], state1);
+  }
+
+  __attribute__((target("sha,sse4.1,ssse3")))
+  static void compressSHA1Extensions (uint32_t state[5], const unsigned char* blocks, size_t count) {
+    const auto mask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    auto abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) state), 0x1b);
+    auto e = _mm_set_epi32((int) state[4], 0, 0, 0);
+
+    for (; count > 0; --count, blocks += 64) {
+      const auto abcdSaved = abcd;
+      const auto eSaved = e;
+      auto previous = abcd;
+      __m128i w[4];
+
+      for (int i = 0; i < 4; ++i) {
+        w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (blocks + i * 16)), mask);
+      }
+
+      // four rounds at a time, `w[i % 4]` holds the words of round `4 * i`
+      for (int i = 0; i < 20; ++i) {
+        auto& words = w[i % 4];
+
+        if (i >= 4) {
+          words = _mm_sha1msg1_epu32(words, w[(i + 1) % 4]);
+          words = _mm_xor_si128(words, w[(i + 2) % 4]);
+          words = _mm_sha1msg2_epu32(words, w[(i + 3) % 4]);
+        }
+
+        const auto we = i == 0
+          ? _mm_add_epi32(e, words)
+          : _mm_sha1nexte_epu32(previous, words);
+
+        previous = abcd;
+
+        // the round function is an immediate
+        switch (i / 5) {
+          case 0: abcd = _mm_sha1rnds4_epu32(abcd, we, 0); break;
+          case 1: abcd = _mm_sha1rnds4_epu32(abcd, we, 1); break;
+          case 2: abcd = _mm_sha1rnds4_epu32(abcd, we, 2); break;
+          default: abcd = _mm_sha1rnds4_epu32(abcd, we, 3); break;
+        }
+      }
+
+      e = _mm_sha1nexte_epu32(previous, eSaved);
+      abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    _mm_storeu_si128((__m128i*) state, _mm_shuffle_epi32(abcd, 0x1b));
+    state[4] = (uint32_t) _mm_extract_epi32(e, 3);
+  }
+#endif
+
+  static inline void blake3G (uint32_t* state, int a, int b, int c, int d, uint32_t x, uint32_t y) {
+    state[a] = state[a] + state[b] + x;
+    state[d] = rotr(state[d] ^ state[a], 16);
+    state[c] = state[c] + state[d];
+    state[b] = rotr(state[b] ^ state[c], 12);
+    state[a] = state[a] + state[b] + y;
+    state[d] = rotr(state[d] ^ state[a], 8);
+    state[c] = state[c] + state[d];
+    state[b] = rotr(state[b] ^ state[c], 7);
+  }
+
+  // the first 8 words of the output are the chaining value
+  static void blake3Compress (
+    const uint32_t cv[8],
+    const unsigned char block[64],
+    uint64_t counter,
+    uint32_t size,
+    uint32_t flags,
+    uint32_t output[16]
+  ) {
+    uint32_t m[16];
+    uint32_t s[16] = {
+      cv[0], cv[1], cv[2], cv[3], cv[4], cv[5], cv[6], cv[7],
+      SHA256_IV[0], SHA256_IV[1], SHA256_IV[2], SHA256_IV[3],
+      (uint32_t) counter, (uint32_t) (counter >> 32), size, flags
+    };
+
+    for (int i = 0; i < 16; ++i) {
+      m[i] = loadLittleEndian(block + i * 4);
+    }
+
+    for (int round = 0; round < 7; ++round) {
+      blake3G(s, 0, 4, 8, 12, m[0], m[1]);
+      blake3G(s, 1, 5, 9, 13, m[2], m[3]);
+      blake3G(s, 2, 6, 10, 14, m[4], m[5]);
+      blake3G(s, 3, 7, 11, 15, m[6], m[7]);
+      blake3G(s, 0, 5, 10, 15, m[8], m[9]);
+      blake3G(s, 1, 6, 11, 12, m[10], m[11]);
+      blake3G(s, 2, 7, 8, 13, m[12], m[13]);
+      blake3G(s, 3, 4, 9, 14, m[14], m[15]);
+
+      uint32_t permuted[16];
+      for (int i = 0; i < 16; ++i) {
+        permuted[i] = m[BLAKE3_PERMUTATION[i]];
+      }
+
+      memcpy(m, permuted, sizeof(m));
+    }
+
+    for (int i = 0; i < 8; ++i) {
+      output[i] = s[i] ^ s[i + 8];
+      output[i + 8] = s[i + 8] ^ cv[i];
+    }
+  }
+
+  static void blake3Parent (const uint32_t left[8], const uint32_t right[8], uint32_t flags, uint32_t cv[8]) {
+    unsigned char block[64];
+    uint32_t output[16];
+
+    for (int i = 0; i < 8; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        block[i * 4 + j] = (unsigned char) (left[i] >> (8 * j));
+        block[32 + i * 4 + j] = (unsigned char) (right[i] >> (8 * j));
+      }
+    }
+
+    blake3Compress(SHA256_IV, block, 0, 64, BLAKE3_PARENT | flags, output);
+    memcpy(cv, output, 32);
+  }
+
+  bool Hasher::parse (const String& name, Algorithm& algorithm) {
+    auto normalized = String();
+
+    for (const auto c : name) {
+      if (c != '-') {
+        normalized += (char) std::tolower((unsigned char) c);
+      }
+    }
+
+    if (normalized == "sha1") {
+      algorithm = Algorithm::SHA1;
+    } else if (normalized == "sha256") {
+      algorithm = Algorithm::SHA256;
+    } else if (normalized == "blake3") {
+      algorithm = Algorithm::BLAKE3;
+    } else {
+      return false;
+    }
+
+    return true;
+  }
+
+  String Hasher::getName (Algorithm algorithm) {
+    switch (algorithm) {
+      case Algorithm::SHA1: return "sha1";
+      case Algorithm::SHA256: return "sha256";
+      case Algorithm::BLAKE3: return "blake3";
+    }
+
+    return "";
+  }
+
+  size_t Hasher::getDigestSize (Algorithm algorithm) {
+    return algorithm == Algorithm::SHA1 ? 20 : 32;
+  }
+
+  bool Hasher::isAccelerated (Algorithm algorithm) {
+  #if SSC_HASH_X86_SHA
+    return algorithm != Algorithm::BLAKE3 && hasSHAExtensions();
+  #else
+    return false;
+  #endif
+  }
+
+  Hasher::Hasher (Algorithm algorithm) {
+    this->algorithm = algorithm;
+
+    if (algorithm == Algorithm::SHA1) {
+      memcpy(this->state, SHA1_IV, sizeof(SHA1_IV));
+    } else {
+      memcpy(this->state, SHA256_IV, sizeof(SHA256_IV));
+    }
+
+    memcpy(this->chunk.cv, SHA256_IV, sizeof(SHA256_IV));
+  }
+
+  void Hasher::compress (const unsigned char* blocks, size_t count) {
+    if (this->algorithm == Algorithm::SHA1) {
+    #if SSC_HASH_X86_SHA
+      if (hasSHAExtensions()) {
+        return compressSHA1Extensions(this->state, blocks, count);
+      }
+    #endif
+      return compressSHA1(this->state, blocks, count);
+    }
+
+  #if SSC_HASH_X86_SHA
+    if (hasSHAExtensions()) {
+      return compressSHA256Extensions(this->state, blocks, count);
+    }
+  #endif
+
+    compressSHA256(this->state, blocks, count);
+  }
+
+  void Hasher::update (const String& string) {
+    this->update(reinterpret_cast<const unsigned char*>(string.data()), string.size());
+  }
+
+  void Hasher::update (const unsigned char* bytes, size_t size) {
+    if (this->algorithm == Algorithm::BLAKE3) {
+      return this->updateBlake3(bytes, size);
+    }
+
+    this->size += size;
+
+    if (this->blockSize > 0) {
+      const auto take = std::min(size, sizeof(this->block) - this->blockSize);
+      memcpy(this->block + this->blockSize, bytes, take);
+      this->blockSize += take;
+      bytes += take;
+      size -= take;
+
+      if (this->blockSize < sizeof(this->block)) {
+        return;
+      }
+
+      this->compress(this->block, 1);
+      this->blockSize = 0;
+    }
+
+    // whole blocks straight from the input
+    if (size >= 64) {
+      this->compress(bytes, size / 64);
+      bytes += size - size % 64;
+      size %= 64;
+    }
+
+    memcpy(this->block, bytes, size);
+    this->blockSize = size;
+  }
+
+  String Hasher::digest () {
+    if (this->algorithm == Algorithm::BLAKE3) {
+      return this->digestBlake3();
+    }
+
+    const auto bits = this->size * 8;
+    unsigned char padding[72] = { 0x80 };
+    // up to the last 8 bytes of a block, then the size in bits
+    const auto length = (this->blockSize < 56 ? 56 : 120) - this->blockSize;
+
+    for (int i = 0; i < 8; ++i) {
+      padding[length + i] = (unsigned char) (bits >> (56 - i * 8));
+    }
+
+    this->update(padding, length + 8);
+
+    auto digest = String(Hasher::getDigestSize(this->algorithm), '\0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+      digest[i] = (char) (this->state[i / 4] >> (24 - (i % 4) * 8));
+    }
+
+    return digest;
+  }
+
+  String Hasher::hexdigest () {
+    static constexpr char digits[] = "0123456789abcdef";
+    const auto digest = this->digest();
+    auto hex = String();
+
+    hex.reserve(digest.size() * 2);
+    for (const auto byte : digest) {
+      hex += digits[(unsigned char) byte >> 4];
+      hex += digits[(unsigned char) byte & 0xf];
+    }
+
+    return hex;
+  }
+
+  void Hasher::updateBlake3 (const unsigned char* bytes, size_t size) {
+    auto& chunk = this->chunk;
+
+    while (size > 0) {
+      // a full chunk is only finished once more input follows, the last
+      // chunk is finished as the root by `digest()`
+      if (chunk.blocksCompressed * 64 + chunk.blockSize == BLAKE3_CHUNK_SIZE) {
+        uint32_t output[16];
+        uint32_t cv[8];
+
+        blake3Compress(chunk.cv, chunk.block, chunk.counter, 64, BLAKE3_CHUNK_END, output);
+        memcpy(cv, output, sizeof(cv));
+
+        // merge the completed subtrees, one per trailing zero bit of the
+        // number of chunks
+        auto chunks = chunk.counter + 1;
+        while ((chunks & 1) == 0) {
+          blake3Parent(this->stack[--this->stackSize], cv, 0, cv);
+          chunks >>= 1;
+        }
+
+        memcpy(this->stack[this->stackSize++], cv, sizeof(cv));
+
+        const auto counter = chunk.counter + 1;
+        chunk = Blake3Chunk {};
+        memcpy(chunk.cv, SHA256_IV, sizeof(SHA256_IV));
+        chunk.counter = counter;
+      }
+
+      if (chunk.blockSize == 64) {
+        uint32_t output[16];
+        const auto flags = chunk.blocksCompressed == 0 ? BLAKE3_CHUNK_START : 0;
+        blake3Compress(chunk.cv, chunk.block, chunk.counter, 64, flags, output);
+        memcpy(chunk.cv, output, sizeof(chunk.cv));
+        chunk.blocksCompressed++;
+        chunk.blockSize = 0;
+      }
+
+      const auto available = BLAKE3_CHUNK_SIZE - chunk.blocksCompressed * 64 - chunk.blockSize;
+      const auto take = std::min({ size, (size_t) 64 - chunk.blockSize, available });
+      memcpy(chunk.block + chunk.blockSize, bytes, take);
+      chunk.blockSize += take;
+      bytes += take;
+      size -= take;
+    }
+  }
+
+  String Hasher::digestBlake3 () {
+    auto& chunk = this->chunk;
+    uint32_t cv[8];
+    uint32_t output[16];
+    unsigned char block[64];
+
+    memset(chunk.block + chunk.blockSize, 0, 64 - chunk.blockSize);
+
+    // the output of the last chunk, which is the root without parents
+    memcpy(cv, chunk.cv, sizeof(cv));
+    memcpy(block, chunk.block, sizeof(block));
+    auto counter = chunk.counter;
+    auto size = (uint32_t) chunk.blockSize;
+    auto flags = BLAKE3_CHUNK_END | (chunk.blocksCompressed == 0 ? BLAKE3_CHUNK_START : 0);
+
+    while (this->stackSize > 0) {
+      uint32_t right[8];
+      blake3Compress(cv, block, counter, size, flags, output);
+      memcpy(right, output, sizeof(right));
+
+      const auto left = this->stack[--this->stackSize];
+      for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 4; ++j) {
+          block[i * 4 + j] = (unsigned char) (left[i] >> (8 * j));
+          block[32 + i * 4 + j] = (unsigned char) (right[i] >> (8 * j));
+        }
+      }
+
+      memcpy(cv, SHA256_IV, sizeof(cv));
+      counter = 0;
+      size = 64;
+      flags = BLAKE3_PARENT;
+    }
+
+    blake3Compress(cv, block, counter, size, flags | BLAKE3_ROOT, output);
+
+    auto digest = String(32, '\0');
+    for (size_t i = 0; i < digest.size(); ++i) {
+      digest[i] = (char) (output[i / 4] >> ((i % 4) * 8));
+    }
+
+    return digest;
+  }
+}
@@ -0,0 +1,74 @@
+#ifndef SSC_CORE_HASH_H
+#define SSC_CORE_HASH_H
+
+#include "types.hh"
+
+namespace SSC {
+  /**
+   * An incremental SHA-1, SHA-256 or BLAKE3 (256 bit output) hasher.
+   * SHA-1 and SHA-256 blocks are compressed with the x86 SHA extensions
+   * when the CPU has them, and with portable code otherwise. A hasher is
+   * not thread safe, use one per thread.
+   */
+  class Hasher {
+    public:
+      enum class Algorithm {
+        SHA1,
+        SHA256,
+        BLAKE3
+      };
+
+      static constexpr size_t MAX_DIGEST_SIZE = 32;
+
+      /**
+       * Parses `sha1`, `sha256` or `blake3` (case insensitive, with an
+       * optional `-`) into `algorithm`, returning `false` for other names.
+       */
+      static bool parse (const String& name, Algorithm& algorithm);
+      static String getName (Algorithm algorithm);
+      static size_t getDigestSize (Algorithm algorithm);
+
+      // `true` if blocks are compressed with CPU instructions
+      static bool isAccelerated (Algorithm algorithm);
+
+      Hasher (Algorithm algorithm);
+
+      void update (const unsigned char* bytes, size_t size);
+      void update (const String& string);
+
+      /**
+       * The digest of everything given to `update()`. The hasher must not
+       * be updated after.
+       */
+      String digest ();
+      String hexdigest ();
+
+    private:
+      struct Blake3Chunk {
+        uint32_t cv[8];
+        uint64_t counter = 0;
+        unsigned char block[64];
+        size_t blockSize = 0;
+        size_t blocksCompressed = 0;
+      };
+
+      Algorithm algorithm;
+
+      // SHA-1 and SHA-256
+      uint32_t state[8];
+      unsigned char block[64];
+      size_t blockSize = 0;
+      uint64_t size = 0;
+
+      // BLAKE3, a chunk and the chaining values of the subtrees before it
+      Blake3Chunk chunk;
+      uint32_t stack[54][8];
+      size_t stackSize = 0;
+
+      void compress (const unsigned char* blocks, size_t count);
+      void updateBlake3 (const unsigned char* bytes, size_t size);
+      String digestBlake3 ();
+  };
+}
+
+#endif
@@ -0,0 +1,328 @@
+#include "metadata_cache.hh"
+
+namespace SSC {
+  static uint64_t now () {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  static String getKey (MetadataCache::Kind kind, int mode, const String& path) {
+    auto key = String(1, (char) kind);
+
+    if (kind == MetadataCache::Kind::Access) {
+      key += std::to_string(mode);
+    }
+
+    return key + ":" + path;
+  }
+
+  String MetadataCache::normalize (const String& path) {
+    auto normalized = std::filesystem::path(path).lexically_normal();
+
+    if (!normalized.has_filename() && normalized != normalized.root_path()) {
+      normalized = normalized.parent_path();
+    }
+
+    const auto string = normalized.string();
+    return string.size() > 0 ? string : ".";
+  }
+
+  String MetadataCache::getDirectory (const String& path) {
+    const auto directory = std::filesystem::path(path).parent_path().string();
+    return directory.size() > 0 ? directory : ".";
+  }
+
+  MetadataCache::MetadataCache (uv_loop_t* loop, const Options& options) {
+    this->loop = loop;
+    this->options = options;
+  }
+
+  MetadataCache::~MetadataCache () {
+  #if !defined(__ANDROID__)
+    Vector<String> directories;
+
+    {
+      Lock lock(this->watchersMutex);
+      for (const auto& entry : this->watchers) {
+        directories.push_back(entry.first);
+      }
+    }
+
+    for (const auto& directory : directories) {
+      this->unwatch(directory);
+    }
+  #endif
+  }
+
+  MetadataCache::Shard& MetadataCache::getShard (const String& key) {
+    return this->shards[std::hash<String>{}(key) % SHARDS];
+  }
+
+  bool MetadataCache::get (
+    Kind kind,
+    const String& path,
+    int mode,
+    Entry& entry,
+    uint64_t& ticket
+  ) {
+    const auto normalized = MetadataCache::normalize(path);
+    const auto key = getKey(kind, mode, normalized);
+    auto& shard = this->getShard(key);
+
+    {
+      Lock lock(shard.mutex);
+      const auto it = shard.values.find(key);
+
+      if (it != shard.values.end()) {
+        if (it->second.expires == 0 || it->second.expires > now()) {
+          // move to the front of the shard's LRU list
+          shard.order.splice(shard.order.begin(), shard.order, it->second.position);
+          entry = it->second.entry;
+          this->hits++;
+          return true;
+        }
+
+        this->erase(shard, key);
+        this->expirations++;
+      }
+    }
+
+    this->misses++;
+    ticket = UNCACHEABLE;
+
+  #if !defined(__ANDROID__)
+    // watched before the caller asks the file system, so a change after
+    // this point invalidates the result
+    if (this->options.watch && !this->watch(MetadataCache::getDirectory(normalized))) {
+      return false;
+    }
+  #else
+    if (this->options.watch) {
+      return false;
+    }
+  #endif
+
+    ticket = this->epoch;
+    return false;
+  }
+
+  void MetadataCache::put (
+    Kind kind,
+    const String& path,
+    int mode,
+    const Entry& entry,
+    uint64_t ticket
+  ) {
+    if (ticket == UNCACHEABLE || ticket != this->epoch) {
+      return;
+    }
+
+    if (entry.result < 0 && entry.result != UV_ENOENT && entry.result != UV_ENOTDIR) {
+      return;
+    }
+
+    const auto normalized = MetadataCache::normalize(path);
+    const auto directory = MetadataCache::getDirectory(normalized);
+    const auto key = getKey(kind, mode, normalized);
+    const auto capacity = std::max(this->options.capacity / SHARDS, (size_t) 1);
+    auto& shard = this->getShard(key);
+
+    Lock lock(shard.mutex);
+
+    // an invalidation may have happened while waiting for the lock
+    if (ticket != this->epoch) {
+      return;
+    }
+
+    this->erase(shard, key);
+
+    while (shard.values.size() >= capacity) {
+      const auto last = shard.order.back();
+      this->erase(shard, last);
+      this->evictions++;
+    }
+
+    shard.order.push_front(key);
+    shard.directories[directory].insert(key);
+    shard.values.insert_or_assign(key, Value {
+      entry,
+      this->options.ttl > 0 ? now() + this->options.ttl : 0,
+      directory,
+      shard.order.begin()
+    });
+
+    this->stores++;
+  }
+
+  void MetadataCache::erase (Shard& shard, const String& key) {
+    const auto it = shard.values.find(key);
+    if (it == shard.values.end()) {
+      return;
+    }
+
+    const auto directory = shard.directories.find(it->second.directory);
+    if (directory != shard.directories.end()) {
+      directory->second.erase(key);
+      if (directory->second.empty()) {
+        shard.directories.erase(directory);
+      }
+    }
+
+    shard.order.erase(it->second.position);
+    shard.values.erase(it);
+  }
+
+  void MetadataCache::invalidate (const String& path) {
+    const auto normalized = MetadataCache::normalize(path);
+    const auto directory = MetadataCache::getDirectory(normalized);
+
+    // entries of the directory `path` is in, which include `path`, entries
+    // in `path` if it's a directory, and the directory's own entries, as a
+    // change of its entries changes its times
+    this->invalidateDirectory(directory);
+    this->invalidateDirectory(normalized);
+    this->invalidateEntries(directory);
+  }
+
+  void MetadataCache::invalidateDirectory (const String& directory) {
+    this->epoch++;
+    this->invalidations++;
+
+    for (auto& shard : this->shards) {
+      Lock lock(shard.mutex);
+      const auto it = shard.directories.find(directory);
+
+      if (it != shard.directories.end()) {
+        const auto keys = Vector<String>(it->second.begin(), it->second.end());
+        for (const auto& key : keys) {
+          this->erase(shard, key);
+        }
+      }
+    }
+  }
+
+  void MetadataCache::invalidateEntries (const String& path) {
+    this->epoch++;
+
+    auto keys = Vector<String> {
+      getKey(Kind::Stat, 0, path),
+      getKey(Kind::LStat, 0, path)
+    };
+
+    // `F_OK`, and any combination of `R_OK`, `W_OK` and `X_OK`
+    for (int mode = 0; mode < 8; ++mode) {
+      keys.push_back(getKey(Kind::Access, mode, path));
+    }
+
+    for (const auto& key : keys) {
+      auto& shard = this->getShard(key);
+      Lock lock(shard.mutex);
+      this->erase(shard, key);
+    }
+  }
+
+  void MetadataCache::clear () {
+    this->epoch++;
+
+    for (auto& shard : this->shards) {
+      Lock lock(shard.mutex);
+      shard.order.clear();
+      shard.values.clear();
+      shard.directories.clear();
+    }
+  }
+
+  MetadataCache::Stats MetadataCache::stats () {
+    Stats stats;
+    stats.hits = this->hits;
+    stats.misses = this->misses;
+    stats.stores = this->stores;
+    stats.invalidations = this->invalidations;
+    stats.evictions = this->evictions;
+    stats.expirations = this->expirations;
+
+    for (auto& shard : this->shards) {
+      Lock lock(shard.mutex);
+      stats.size += shard.values.size();
+    }
+
+  #if !defined(__ANDROID__)
+    Lock lock(this->watchersMutex);
+    stats.watched = this->watchers.size();
+  #endif
+
+    return stats;
+  }
+
+#if !defined(__ANDROID__)
+  bool MetadataCache::watch (const String& directory) {
+    Lock lock(this->watchersMutex);
+
+    if (this->watchers.contains(directory)) {
+      return true;
+    }
+
+    if (this->watchers.size() >= this->options.maxWatchedDirectories) {
+      return false;
+    }
+
+    std::error_code error;
+    if (!std::filesystem::is_directory(directory, error)) {
+      return false;
+    }
+
+    auto watcher = new FileSystemWatcher(directory);
+    // run on the cache's loop instead of a thread of its own
+    watcher->loop = this->loop;
+    watcher->options.debounce = 0;
+    watcher->options.includeRemoved = true;
+  #if defined(__linux__)
+    // a recursive watch adds an inotify watch for every directory in the
+    // tree, the directories in it are watched on their own when needed
+    watcher->options.recursive = false;
+  #endif
+    watcher->start([this, directory](auto, auto, auto) {
+      // the directory may have been replaced, it is watched again by the
+      // next miss
+      this->invalidateDirectory(directory);
+      this->invalidateEntries(directory);
+      this->unwatch(directory);
+    });
+
+    this->watchers.insert_or_assign(directory, watcher);
+
+    // out of watches (`fs.inotify.max_user_watches`) or not watchable
+    if (!uv_is_active(reinterpret_cast<uv_handle_t*>(&watcher->handles[directory]))) {
+      this->unwatch(directory);
+      return false;
+    }
+
+    return true;
+  }
+
+  void MetadataCache::unwatch (const String& directory) {
+    FileSystemWatcher* watcher = nullptr;
+
+    {
+      Lock lock(this->watchersMutex);
+      const auto it = this->watchers.find(directory);
+      if (it == this->watchers.end()) {
+        return;
+      }
+
+      watcher = it->second;
+      this->watchers.erase(it);
+    }
+
+    watcher->stop();
+
+    // freed once libuv is done with the handle
+    for (auto& entry : watcher->handles) {
+      uv_close(reinterpret_cast<uv_handle_t*>(&entry.second), [](uv_handle_t* handle) {
+        auto context = reinterpret_cast<FileSystemWatcher::Context*>(handle->data);
+        delete context->watcher;
+      });
+    }
+  }
+#endif
+}
@@ -0,0 +1,148 @@
+#ifndef SSC_CORE_METADATA_CACHE_H
+#define SSC_CORE_METADATA_CACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "platform.hh"
+#include "types.hh"
+
+#if !defined(__ANDROID__)
+#include "file_system_watcher.hh"
+#endif
+
+namespace SSC {
+  /**
+   * A bounded cache of `stat(2)`, `lstat(2)` and `access(2)` results keyed
+   * by path, including "not found" results. Entries are spread across
+   * `SHARDS` least recently used lists by a hash of their key and are
+   * grouped by the directory that contains them.
+   *
+   * A lookup that misses starts watching the directory of the path, before
+   * the caller asks the file system, with a `FileSystemWatcher` on the
+   * loop. Any event in a watched directory drops every entry in it and the
+   * watcher, which is started again by the next miss. A result is only
+   * stored if nothing was invalidated since its lookup, so a change racing
+   * a `stat(2)` is never cached. Changes to an ancestor of a directory are
+   * not observed, `ttl` bounds how long such an entry can be stale.
+   *
+   * Stores and invalidation may happen on any thread. Lookups start
+   * watchers, so they must happen on the loop thread unless `watch` is off.
+   */
+  class MetadataCache {
+    public:
+      static constexpr size_t SHARDS = 16;
+
+      enum class Kind : char {
+        Stat = 's',
+        LStat = 'l',
+        Access = 'a'
+      };
+
+      struct Options {
+        // entries across all shards
+        size_t capacity = 4096;
+        // milliseconds an entry is used for, `0` for no limit
+        uint64_t ttl = 1000;
+        // directories watched at once, misses in others are not cached
+        size_t maxWatchedDirectories = 1024;
+        // without watchers entries are only invalidated by `ttl` and
+        // `invalidate()`
+        bool watch = true;
+      };
+
+      struct Entry {
+        // `0` or a (negative) libuv error
+        int result = 0;
+        uv_stat_t stat;
+      };
+
+      struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        uint64_t invalidations = 0;
+        uint64_t evictions = 0;
+        uint64_t expirations = 0;
+        size_t size = 0;
+        size_t watched = 0;
+      };
+
+      // returned by a miss whose result must not be stored
+      static constexpr uint64_t UNCACHEABLE = 0;
+
+      MetadataCache (uv_loop_t* loop, const Options& options);
+      MetadataCache (const MetadataCache&) = delete;
+      ~MetadataCache ();
+
+      /**
+       * Looks up the entry for `path`, `mode` is only used by `Access`.
+       * Returns `true` and fills `entry` on a hit. On a miss `ticket` is
+       * set to the value to give to `put()` with the result.
+       */
+      bool get (Kind kind, const String& path, int mode, Entry& entry, uint64_t& ticket);
+
+      /**
+       * Stores the result of a lookup that missed. Errors other than
+       * `UV_ENOENT` and `UV_ENOTDIR` are not cached.
+       */
+      void put (Kind kind, const String& path, int mode, const Entry& entry, uint64_t ticket);
+
+      /**
+       * Drops entries a change to `path` may affect: the entries of its
+       * directory and its own entries if it is a directory.
+       */
+      void invalidate (const String& path);
+      void clear ();
+      Stats stats ();
+
+      // `path` without `.`, `..` or trailing separators
+      static String normalize (const String& path);
+      static String getDirectory (const String& path);
+
+    private:
+      struct Value {
+        Entry entry;
+        uint64_t expires = 0;
+        String directory;
+        std::list<String>::iterator position;
+      };
+
+      struct Shard {
+        Mutex mutex;
+        // most recently used first
+        std::list<String> order;
+        std::unordered_map<String, Value> values;
+        std::unordered_map<String, std::unordered_set<String>> directories;
+      };
+
+      uv_loop_t* loop = nullptr;
+      Options options;
+      Shard shards[SHARDS];
+      // bumped by every invalidation
+      Atomic<uint64_t> epoch = 1;
+
+      Atomic<uint64_t> hits = 0;
+      Atomic<uint64_t> misses = 0;
+      Atomic<uint64_t> stores = 0;
+      Atomic<uint64_t> invalidations = 0;
+      Atomic<uint64_t> evictions = 0;
+      Atomic<uint64_t> expirations = 0;
+
+    #if !defined(__ANDROID__)
+      Mutex watchersMutex;
+      std::map<String, FileSystemWatcher*> watchers;
+
+      bool watch (const String& directory);
+      void unwatch (const String& directory);
+    #endif
+
+      Shard& getShard (const String& key);
+      void invalidateDirectory (const String& directory);
+      void invalidateEntries (const String& path);
+      void erase (Shard& shard, const String& key);
+  };
+}
+
+#endif
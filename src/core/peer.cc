@@ -2,27 +2,31 @@
 
 namespace SSC {
   void Core::resumeAllPeers () {
-    dispatchEventLoop([=, this]() {
-      Lock lock(this->peersMutex);
-      for (auto const &tuple : this->peers) {
-        auto peer = tuple.second;
+    Lock lock(this->peersMutex);
+    for (auto const &tuple : this->peers) {
+      auto peerId = tuple.first;
+      // peers are only touched on the loop (shard) that owns them
+      dispatchEventLoop(peerId, [=, this]() {
+        auto peer = this->getPeer(peerId);
         if (peer != nullptr && (peer->isBound() || peer->isConnected())) {
           peer->resume();
         }
-      }
-    });
+      });
+    }
   }
 
   void Core::pauseAllPeers () {
-    dispatchEventLoop([=, this]() {
-      Lock lock(this->peersMutex);
-      for (auto const &tuple : this->peers) {
-        auto peer = tuple.second;
+    Lock lock(this->peersMutex);
+    for (auto const &tuple : this->peers) {
+      auto peerId = tuple.first;
+      // peers are only touched on the loop (shard) that owns them
+      dispatchEventLoop(peerId, [=, this]() {
+        auto peer = this->getPeer(peerId);
         if (peer != nullptr && (peer->isBound() || peer->isConnected())) {
           peer->pause();
         }
-      }
-    });
+      });
+    }
   }
 
   bool Core::hasPeer (uint64_t peerId) {
@@ -196,7 +200,7 @@ namespace SSC {
 
   int Peer::init () {
     Lock lock(this->mutex);
-    auto loop = this->core->getEventLoop();
+    auto loop = this->core->getEventLoop(this->id);
     int err = 0;
 
     memset(&this->handle, 0, sizeof(this->handle));
@@ -0,0 +1,336 @@
+#ifndef SSC_CORE_POOL_H
+#define SSC_CORE_POOL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+#include "types.hh"
+
+namespace SSC {
+  namespace detail {
+    // before each `ThreadLocalBlockPool` block, its class while in use and
+    // the next spare block while in a free-list
+    union PoolBlockHeader {
+      size_t index;
+      PoolBlockHeader* next;
+      // keeps blocks aligned for any type
+      std::max_align_t alignment;
+    };
+  }
+
+  /**
+   * Per-thread free-lists of blocks in `CLASSES` size classes that are
+   * `CLASS_SIZE` bytes apart. Blocks are meant to be allocated and freed on
+   * the event loop thread that owns them, like coroutine frames and libuv
+   * request contexts, so they are recycled without locking or touching the
+   * global allocator. A block's header records its class, so it is released
+   * without its size. Sizes over the largest class use the global allocator
+   * and are not counted. Each thread keeps at most `MAX_FREE_BLOCKS` spare
+   * blocks per class. Pools with the same classes are kept apart by `Tag`.
+   */
+  template <
+    size_t CLASS_SIZE,
+    size_t CLASSES,
+    size_t MAX_FREE_BLOCKS,
+    typename Tag = void
+  >
+  class ThreadLocalBlockPool {
+    public:
+      // counters of the calling thread
+      struct Stats {
+        // blocks taken from the global allocator
+        uint64_t allocated = 0;
+        // allocations served from a free-list
+        uint64_t reused = 0;
+        // blocks given back to a free-list or the global allocator
+        uint64_t released = 0;
+        // blocks currently held by the free-lists
+        uint64_t pooled = 0;
+      };
+
+      static void* allocate (size_t size) {
+        const auto index = ThreadLocalBlockPool::index(size + sizeof(Header));
+
+        if (index >= CLASSES) {
+          auto header = static_cast<Header*>(::operator new(size + sizeof(Header)));
+          header->index = index;
+          return header + 1;
+        }
+
+        auto& pool = ThreadLocalBlockPool::current();
+        auto& list = pool.lists[index];
+        Header* header = nullptr;
+
+        if (list.head != nullptr) {
+          header = list.head;
+          list.head = header->next;
+          list.size--;
+          pool.counters.reused++;
+          pool.counters.pooled--;
+        } else {
+          header = static_cast<Header*>(::operator new((index + 1) * CLASS_SIZE));
+          pool.counters.allocated++;
+        }
+
+        header->index = index;
+        return header + 1;
+      }
+
+      static void release (void* pointer) {
+        if (pointer == nullptr) {
+          return;
+        }
+
+        auto header = static_cast<Header*>(pointer) - 1;
+        const auto index = header->index;
+
+        if (index >= CLASSES) {
+          ::operator delete(header);
+          return;
+        }
+
+        auto& pool = ThreadLocalBlockPool::current();
+        auto& list = pool.lists[index];
+        pool.counters.released++;
+
+        if (list.size >= MAX_FREE_BLOCKS) {
+          ::operator delete(header);
+          return;
+        }
+
+        header->next = list.head;
+        list.head = header;
+        list.size++;
+        pool.counters.pooled++;
+      }
+
+      static Stats stats () {
+        return ThreadLocalBlockPool::current().counters;
+      }
+
+      ~ThreadLocalBlockPool () {
+        for (auto& list : this->lists) {
+          while (list.head != nullptr) {
+            auto next = list.head->next;
+            ::operator delete(list.head);
+            list.head = next;
+          }
+        }
+      }
+
+    private:
+      using Header = detail::PoolBlockHeader;
+
+      struct FreeList {
+        Header* head = nullptr;
+        size_t size = 0;
+      };
+
+      FreeList lists[CLASSES];
+      Stats counters;
+
+      static size_t index (size_t size) {
+        return (size + CLASS_SIZE - 1) / CLASS_SIZE - 1;
+      }
+
+      static ThreadLocalBlockPool& current () {
+        static thread_local ThreadLocalBlockPool pool;
+        return pool;
+      }
+  };
+
+  /**
+   * A `ThreadLocalBlockPool` with a single class of blocks that fit a `T`,
+   * for objects that are allocated and freed on the same event loop thread.
+   * Derived types that are larger than `T` bypass the pool.
+   *
+   * Use it from `T` with:
+   *
+   *   static void* operator new (size_t size) { return Pool::allocate(size); }
+   *   static void operator delete (void* p) { Pool::release(p); }
+   */
+  template <typename T, size_t MAX_FREE_BLOCKS = 256>
+  class ThreadLocalPool : public ThreadLocalBlockPool<
+    (sizeof(T) + sizeof(detail::PoolBlockHeader) + alignof(std::max_align_t) - 1)
+      / alignof(std::max_align_t) * alignof(std::max_align_t),
+    1,
+    MAX_FREE_BLOCKS,
+    T
+  > {
+    public:
+      // the size is accepted for `operator delete (void*, size_t)`, the
+      // block header records it
+      static void release (void* pointer, size_t size = sizeof(T)) {
+        ThreadLocalPool::ThreadLocalBlockPool::release(pointer);
+      }
+  };
+
+  /**
+   * A process wide pool of size-classed byte buffers for `Post` bodies and
+   * other large I/O buffers. Buffers are never zero filled, callers are
+   * expected to overwrite them, like `uv_fs_read()` does. Classes double
+   * from `MIN_CLASS_SIZE` to `MAX_CLASS_SIZE`, larger buffers are exact
+   * sized and never pooled. At most `MAX_POOLED_BYTES` are held spare.
+   *
+   * Buffers are reference counted so a response path can `retain()` a
+   * body and hand it to the platform (a `GInputStream`, an `NSData`)
+   * instead of copying it. Every `allocate()` and `retain()` is paired with
+   * a `release()`, which may happen on any thread.
+   */
+  class BufferPool {
+    public:
+      static constexpr size_t MIN_CLASS_SIZE = 4 * 1024;
+      static constexpr size_t CLASSES = 15;
+      static constexpr size_t MAX_CLASS_SIZE = MIN_CLASS_SIZE << (CLASSES - 1);
+      static constexpr size_t MAX_POOLED_BYTES = 64 * 1024 * 1024;
+
+      struct Stats {
+        // buffers taken from the global allocator
+        uint64_t allocated = 0;
+        // allocations served from a free-list
+        uint64_t reused = 0;
+        // buffers whose last reference was released
+        uint64_t released = 0;
+        // bytes currently held by free-lists
+        uint64_t pooled = 0;
+      };
+
+      static char* allocate (size_t size) {
+        auto& pool = BufferPool::shared();
+        const auto index = BufferPool::index(size);
+        Header* header = nullptr;
+
+        if (index < CLASSES) {
+          auto& list = pool.lists[index];
+          std::lock_guard<std::mutex> lock(list.mutex);
+          if (list.head != nullptr) {
+            header = list.head;
+            list.head = header->next;
+            pool.counters.reused++;
+            pool.counters.pooled -= BufferPool::classSize(index);
+          }
+        }
+
+        if (header == nullptr) {
+          const auto capacity = index < CLASSES ? BufferPool::classSize(index) : size;
+          header = static_cast<Header*>(::operator new(sizeof(Header) + capacity));
+          pool.counters.allocated++;
+        }
+
+        header->index = (uint32_t) index;
+        header->capacity = index < CLASSES ? BufferPool::classSize(index) : size;
+        header->references.store(1, std::memory_order_relaxed);
+        return reinterpret_cast<char*>(header + 1);
+      }
+
+      /**
+       * Adds a reference to a buffer from `allocate()`.
+       */
+      static void retain (const char* pointer) {
+        if (pointer != nullptr) {
+          BufferPool::header(pointer)->references.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+
+      /**
+       * Drops a reference to a buffer from `allocate()`, the last one
+       * returns it to its free-list.
+       */
+      static void release (const char* pointer) {
+        if (pointer == nullptr) {
+          return;
+        }
+
+        auto header = BufferPool::header(pointer);
+
+        if (header->references.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+          return;
+        }
+
+        auto& pool = BufferPool::shared();
+        const auto index = header->index;
+        pool.counters.released++;
+
+        if (index < CLASSES) {
+          const auto size = BufferPool::classSize(index);
+          auto& list = pool.lists[index];
+          std::lock_guard<std::mutex> lock(list.mutex);
+
+          if (pool.counters.pooled + size <= MAX_POOLED_BYTES) {
+            header->next = list.head;
+            list.head = header;
+            pool.counters.pooled += size;
+            return;
+          }
+        }
+
+        ::operator delete(header);
+      }
+
+      /**
+       * The usable size of a buffer from `allocate()`, which may be larger
+       * than the size asked for.
+       */
+      static size_t capacity (const char* pointer) {
+        return BufferPool::header(pointer)->capacity;
+      }
+
+      static Stats stats () {
+        auto& counters = BufferPool::shared().counters;
+        return Stats {
+          counters.allocated.load(std::memory_order_relaxed),
+          counters.reused.load(std::memory_order_relaxed),
+          counters.released.load(std::memory_order_relaxed),
+          counters.pooled.load(std::memory_order_relaxed)
+        };
+      }
+
+    private:
+      struct alignas(std::max_align_t) Header {
+        Atomic<uint32_t> references;
+        uint32_t index;
+        size_t capacity;
+        Header* next;
+      };
+
+      struct FreeList {
+        std::mutex mutex;
+        Header* head = nullptr;
+      };
+
+      struct Counters {
+        Atomic<uint64_t> allocated = 0;
+        Atomic<uint64_t> reused = 0;
+        Atomic<uint64_t> released = 0;
+        Atomic<uint64_t> pooled = 0;
+      };
+
+      FreeList lists[CLASSES];
+      Counters counters;
+
+      static size_t classSize (size_t index) {
+        return MIN_CLASS_SIZE << index;
+      }
+
+      static size_t index (size_t size) {
+        size_t index = 0;
+        while (index < CLASSES && BufferPool::classSize(index) < size) {
+          index++;
+        }
+        return index;
+      }
+
+      static Header* header (const char* pointer) {
+        return reinterpret_cast<Header*>(const_cast<char*>(pointer)) - 1;
+      }
+
+      static BufferPool& shared () {
+        // never destroyed, bodies may be released while the process exits
+        static auto pool = new BufferPool();
+        return *pool;
+      }
+  };
+}
+
+#endif
@@ -0,0 +1,359 @@
+#ifndef SSC_CORE_QUEUE_H
+#define SSC_CORE_QUEUE_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "types.hh"
+
+namespace SSC {
+  /**
+   * A move-only, type erased `void()` callable. Callables that fit in
+   * `Task::INLINE_SIZE` bytes are stored inline so the common dispatch
+   * lambdas (a few captured pointers, strings and callbacks) do not allocate.
+   */
+  class Task {
+    public:
+      static constexpr size_t INLINE_SIZE = 128;
+
+      Task () = default;
+      Task (std::nullptr_t) {}
+
+      template <
+        typename F,
+        typename = std::enable_if_t<!std::is_same_v<std::decay_t<F>, Task>>
+      > Task (F&& callback) {
+        using Callable = std::decay_t<F>;
+
+        if constexpr (std::is_same_v<Callable, std::function<void()>>) {
+          if (callback == nullptr) return;
+        }
+
+        if constexpr (
+          sizeof(Callable) <= INLINE_SIZE &&
+          alignof(Callable) <= alignof(std::max_align_t) &&
+          std::is_nothrow_move_constructible_v<Callable>
+        ) {
+          new (&this->storage) Callable(std::forward<F>(callback));
+          this->operations = &InlineOperations<Callable>::table;
+        } else {
+          auto pointer = new Callable(std::forward<F>(callback));
+          new (&this->storage) Callable*(pointer);
+          this->operations = &HeapOperations<Callable>::table;
+        }
+      }
+
+      Task (Task&& task) noexcept {
+        this->take(task);
+      }
+
+      Task& operator = (Task&& task) noexcept {
+        if (this != &task) {
+          this->reset();
+          this->take(task);
+        }
+
+        return *this;
+      }
+
+      Task (const Task&) = delete;
+      Task& operator = (const Task&) = delete;
+
+      ~Task () {
+        this->reset();
+      }
+
+      explicit operator bool () const {
+        return this->operations != nullptr;
+      }
+
+      void operator () () {
+        if (this->operations != nullptr) {
+          this->operations->invoke(&this->storage);
+        }
+      }
+
+      void reset () {
+        if (this->operations != nullptr) {
+          this->operations->destroy(&this->storage);
+          this->operations = nullptr;
+        }
+      }
+
+    private:
+      struct Operations {
+        void (*invoke)(void*);
+        void (*move)(void*, void*);
+        void (*destroy)(void*);
+      };
+
+      template <typename Callable> struct InlineOperations {
+        static constexpr Operations table = {
+          [](void* storage) {
+            (*static_cast<Callable*>(storage))();
+          },
+          [](void* from, void* to) {
+            new (to) Callable(std::move(*static_cast<Callable*>(from)));
+            static_cast<Callable*>(from)->~Callable();
+          },
+          [](void* storage) {
+            static_cast<Callable*>(storage)->~Callable();
+          }
+        };
+      };
+
+      template <typename Callable> struct HeapOperations {
+        static constexpr Operations table = {
+          [](void* storage) {
+            (**static_cast<Callable**>(storage))();
+          },
+          [](void* from, void* to) {
+            new (to) Callable*(*static_cast<Callable**>(from));
+          },
+          [](void* storage) {
+            delete *static_cast<Callable**>(storage);
+          }
+        };
+      };
+
+      void take (Task& task) {
+        if (task.operations != nullptr) {
+          task.operations->move(&task.storage, &this->storage);
+          this->operations = task.operations;
+          task.operations = nullptr;
+        }
+      }
+
+      alignas(std::max_align_t) unsigned char storage[INLINE_SIZE];
+      const Operations* operations = nullptr;
+  };
+
+  /**
+   * A bounded, lock-free, multiple producer, single consumer queue.
+   * Slots are sequenced (Vyukov style) so producers only contend on a
+   * single atomic counter and never wait on the consumer. `push()` returns
+   * `false` when the queue is full. `pop()` must only be called from one
+   * thread at a time.
+   */
+  template <typename T, size_t Capacity> class MPSCQueue {
+    static_assert(Capacity >= 2, "MPSCQueue capacity must be at least 2");
+    static_assert(
+      (Capacity & (Capacity - 1)) == 0,
+      "MPSCQueue capacity must be a power of 2"
+    );
+
+    public:
+      MPSCQueue () {
+        for (size_t i = 0; i < Capacity; ++i) {
+          this->slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+      }
+
+      MPSCQueue (const MPSCQueue&) = delete;
+      MPSCQueue& operator = (const MPSCQueue&) = delete;
+
+      bool push (T&& value) {
+        auto position = this->tail.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+
+        while (true) {
+          slot = &this->slots[position & (Capacity - 1)];
+          const auto sequence = slot->sequence.load(std::memory_order_acquire);
+          const auto delta = (intptr_t) sequence - (intptr_t) position;
+
+          if (delta == 0) {
+            if (this->tail.compare_exchange_weak(
+              position,
+              position + 1,
+              std::memory_order_relaxed
+            )) {
+              break;
+            }
+          } else if (delta < 0) {
+            return false;
+          } else {
+            position = this->tail.load(std::memory_order_relaxed);
+          }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+
+      bool pop (T& value) {
+        auto& slot = this->slots[this->head & (Capacity - 1)];
+        const auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence != this->head + 1) {
+          return false;
+        }
+
+        value = std::move(slot.value);
+        slot.sequence.store(this->head + Capacity, std::memory_order_release);
+        this->head++;
+        return true;
+      }
+
+      bool empty () const {
+        return this->head == this->tail.load(std::memory_order_acquire);
+      }
+
+      size_t capacity () const {
+        return Capacity;
+      }
+
+    private:
+      struct Slot {
+        Atomic<size_t> sequence;
+        T value;
+      };
+
+      Slot slots[Capacity];
+      alignas(64) Atomic<size_t> tail = 0;
+      alignas(64) size_t head = 0;
+  };
+
+  /**
+   * A dispatch queue of `Task` callbacks. Producers on any thread `push()`
+   * into a lock-free ring, falling back to a mutex guarded overflow list
+   * when the ring is full so dispatch never blocks or fails. The consumer
+   * thread calls `drain()` which runs callbacks without holding any lock
+   * while a callback executes, so callbacks may safely dispatch more work.
+   * Order is preserved for tasks pushed from the same thread.
+   */
+  class DispatchQueue {
+    public:
+      static constexpr size_t CAPACITY = 1024;
+      static constexpr size_t BATCH_SIZE = 64;
+
+      using Clock = std::chrono::steady_clock;
+
+      DispatchQueue () = default;
+      DispatchQueue (const DispatchQueue&) = delete;
+      DispatchQueue& operator = (const DispatchQueue&) = delete;
+
+      void push (Task task) {
+        if (!task) {
+          return;
+        }
+
+        this->pending.fetch_add(1, std::memory_order_relaxed);
+
+        if (!this->overflowing.load(std::memory_order_acquire)) {
+          if (this->ring.push(std::move(task))) {
+            return;
+          }
+        }
+
+        std::lock_guard<std::mutex> lock(this->overflowMutex);
+        this->overflow.push_back(std::move(task));
+        this->overflowing.store(true, std::memory_order_release);
+      }
+
+      /**
+       * Runs up to `limit` queued tasks on the calling (consumer) thread and
+       * returns the number of tasks run. Tasks queued while draining are run
+       * too, until `limit` is reached.
+       */
+      size_t drain (size_t limit = CAPACITY) {
+        return this->drain(limit, Clock::time_point::max());
+      }
+
+      /**
+       * Like `drain()`, but stops once `budget` has elapsed so a consumer
+       * sharing its thread with other work, like the GTK main loop, stays
+       * responsive. At least one task is run. Tasks that did not fit in the
+       * budget are run first by the next drain.
+       */
+      size_t drain (Clock::duration budget, size_t limit = CAPACITY) {
+        return this->drain(limit, Clock::now() + budget);
+      }
+
+      /**
+       * `true` if there is nothing left to `drain()`. Only meaningful on
+       * the consumer thread.
+       */
+      bool empty () const {
+        return (
+          this->deferred.size() == 0 &&
+          this->ring.empty() &&
+          !this->overflowing.load(std::memory_order_acquire)
+        );
+      }
+
+      /**
+       * The approximate number of tasks queued or running, for diagnostics.
+       */
+      size_t size () const {
+        return this->pending.load(std::memory_order_relaxed);
+      }
+
+    private:
+      size_t drain (size_t limit, Clock::time_point deadline) {
+        const bool bounded = deadline != Clock::time_point::max();
+        size_t total = 0;
+        size_t settled = 0;
+        Task task;
+
+        while (total < limit) {
+          if (bounded && total > 0 && Clock::now() >= deadline) {
+            break;
+          }
+
+          // tasks moved out of the overflow always run before the ring, they
+          // were queued before anything pushed since the overflow was taken
+          if (this->deferred.size() > 0) {
+            task = std::move(this->deferred.front());
+            this->deferred.pop_front();
+          } else if (!this->ring.pop(task)) {
+            if (!this->overflowing.load(std::memory_order_acquire)) {
+              break;
+            }
+
+            // a producer claimed a slot before the overflow began but has
+            // not published it yet, it must run before anything in the overflow
+            if (!this->ring.empty()) {
+              std::this_thread::yield();
+              continue;
+            }
+
+            std::lock_guard<std::mutex> lock(this->overflowMutex);
+            for (auto& overflowed : this->overflow) {
+              this->deferred.push_back(std::move(overflowed));
+            }
+
+            this->overflow.clear();
+            this->overflowing.store(false, std::memory_order_release);
+            continue;
+          }
+
+          task();
+          task.reset();
+          total++;
+
+          if (++settled == BATCH_SIZE) {
+            this->pending.fetch_sub(settled, std::memory_order_relaxed);
+            settled = 0;
+          }
+        }
+
+        this->pending.fetch_sub(settled, std::memory_order_relaxed);
+        return total;
+      }
+
+      MPSCQueue<Task, CAPACITY> ring;
+      Atomic<bool> overflowing = false;
+      Atomic<size_t> pending = 0;
+      std::mutex overflowMutex;
+      Vector<Task> overflow;
+      // consumer owned, see `drain()`
+      std::deque<Task> deferred;
+  };
+}
+
+#endif
@@ -151,4 +151,172 @@ namespace SSC {
   Vector<String> parseStringList (const String& string) {
     return parseStringList(string, { ' ', ',' });
   }
+
+  // matches a `[...]` class at `pattern` against `character`, `end` is set
+  // past the class. Returns `false` with `end` unset if the class is open.
+  static bool matchGlobClass (const char* pattern, const char* patternEnd, char character, const char*& end, bool& matched) {
+    auto cursor = pattern + 1;
+    const auto negated = cursor < patternEnd && (*cursor == '!' || *cursor == '^');
+    matched = false;
+
+    if (negated) {
+      cursor++;
+    }
+
+    for (auto first = true; cursor < patternEnd && (first || *cursor != ']'); first = false) {
+      auto low = *cursor++;
+
+      if (low == '\\' && cursor < patternEnd) {
+        low = *cursor++;
+      }
+
+      auto high = low;
+
+      if (cursor + 1 < patternEnd && *cursor == '-' && cursor[1] != ']') {
+        high = cursor[1];
+        cursor += 2;
+      }
+
+      if (character >= low && character <= high) {
+        matched = true;
+      }
+    }
+
+    if (cursor >= patternEnd) {
+      return false;
+    }
+
+    end = cursor + 1;
+    matched = matched != negated;
+    return true;
+  }
+
+  static bool matchGlob (const char* pattern, const char* patternEnd, const char* path, const char* pathEnd) {
+    while (pattern < patternEnd) {
+      if (*pattern == '*') {
+        if (pattern + 1 < patternEnd && pattern[1] == '*') {
+          pattern += 2;
+
+          // `a/**/b` also matches `a/b`
+          if (pattern < patternEnd && *pattern == '/' && matchGlob(pattern + 1, patternEnd, path, pathEnd)) {
+            return true;
+          }
+
+          for (auto cursor = path; cursor <= pathEnd; ++cursor) {
+            if (matchGlob(pattern, patternEnd, cursor, pathEnd)) {
+              return true;
+            }
+          }
+
+          return false;
+        }
+
+        pattern++;
+
+        for (auto cursor = path; ; ++cursor) {
+          if (matchGlob(pattern, patternEnd, cursor, pathEnd)) {
+            return true;
+          }
+
+          if (cursor == pathEnd || *cursor == '/') {
+            return false;
+          }
+        }
+      }
+
+      if (path == pathEnd) {
+        return false;
+      }
+
+      if (*pattern == '?') {
+        if (*path == '/') {
+          return false;
+        }
+      } else if (*pattern == '[') {
+        const char* end = nullptr;
+        bool matched = false;
+
+        if (matchGlobClass(pattern, patternEnd, *path, end, matched)) {
+          if (!matched || *path == '/') {
+            return false;
+          }
+
+          pattern = end;
+          path++;
+          continue;
+        }
+
+        // an unterminated class is a literal `[`
+        if (*path != '[') {
+          return false;
+        }
+      } else {
+        if (*pattern == '\\' && pattern + 1 < patternEnd) {
+          pattern++;
+        }
+
+        if (*pattern != *path) {
+          return false;
+        }
+      }
+
+      pattern++;
+      path++;
+    }
+
+    return path == pathEnd;
+  }
+
+  // expands the first `{a,b}` group of `pattern`, recursively
+  static void expandGlobBraces (const String& pattern, Vector<String>& patterns) {
+    size_t open = String::npos;
+    size_t depth = 0;
+    auto alternatives = Vector<String>();
+
+    for (size_t i = 0, start = 0; i < pattern.size(); ++i) {
+      const auto character = pattern[i];
+
+      if (character == '\\') {
+        i++;
+      } else if (character == '{') {
+        if (depth++ == 0) {
+          open = i;
+          start = i + 1;
+        }
+      } else if (character == ',' && depth == 1) {
+        alternatives.push_back(pattern.substr(start, i - start));
+        start = i + 1;
+      } else if (character == '}' && depth > 0 && --depth == 0) {
+        alternatives.push_back(pattern.substr(start, i - start));
+
+        const auto prefix = pattern.substr(0, open);
+        const auto suffix = pattern.substr(i + 1);
+
+        for (const auto& alternative : alternatives) {
+          expandGlobBraces(prefix + alternative + suffix, patterns);
+        }
+
+        return;
+      }
+    }
+
+    patterns.push_back(pattern);
+  }
+
+  bool matchGlob (const String& pattern, const String& path) {
+    if (pattern.find('{') != String::npos) {
+      auto patterns = Vector<String>();
+      expandGlobBraces(pattern, patterns);
+
+      for (const auto& expanded : patterns) {
+        if (matchGlob(expanded.data(), expanded.data() + expanded.size(), path.data(), path.data() + path.size())) {
+          return true;
+        }
+      }
+
+      return false;
+    }
+
+    return matchGlob(pattern.data(), pattern.data() + pattern.size(), path.data(), path.data() + path.size());
+  }
 }
@@ -33,6 +33,16 @@ namespace SSC {
   Vector<String> parseStringList (const String& string, const Vector<char>& separators);
   Vector<String> parseStringList (const String& string, const char separator);
   Vector<String> parseStringList (const String& string);
+
+  // matching
+
+  /**
+   * Matches a `/` separated `path` against a glob `pattern`. `*` and `?`
+   * match within a path segment, `**` matches across segments, `[a-z]` and
+   * `[!a]` match a character class, `{a,b}` matches either alternative and
+   * `\` escapes the next character.
+   */
+  bool matchGlob (const String& pattern, const String& path);
 }
 
 #endif
@@ -0,0 +1,160 @@
+#include "core.hh"
+
+namespace SSC {
+  static uint64_t now () {
+    using namespace std::chrono;
+    return duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count();
+  }
+
+  static uint64_t ticks (uint64_t ms) {
+    return (ms + Core::Timers::RESOLUTION - 1) / Core::Timers::RESOLUTION;
+  }
+
+  Core::Timers::~Timers () {
+    Lock lock(this->mutex);
+    if (this->didInit) {
+      uv_timer_stop(&this->handle);
+    }
+  }
+
+  Core::Timers::ID Core::Timers::setTimeout (
+    uint64_t timeout,
+    const Callback& callback
+  ) {
+    return this->schedule(timeout, 0, callback);
+  }
+
+  Core::Timers::ID Core::Timers::setInterval (
+    uint64_t interval,
+    const Callback& callback
+  ) {
+    return this->schedule(interval, std::max(interval, RESOLUTION), callback);
+  }
+
+  bool Core::Timers::clearTimeout (ID id) {
+    Lock lock(this->mutex);
+    // the `uv_timer_t` is stopped lazily the next time it fires
+    return this->wheel.cancel(id);
+  }
+
+  bool Core::Timers::clearInterval (ID id) {
+    return this->clearTimeout(id);
+  }
+
+  bool Core::Timers::has (ID id) {
+    Lock lock(this->mutex);
+    return this->wheel.has(id);
+  }
+
+  size_t Core::Timers::size () {
+    Lock lock(this->mutex);
+    return this->wheel.size();
+  }
+
+  void Core::Timers::start () {
+    Lock lock(this->mutex);
+    if (this->running) {
+      return;
+    }
+
+    this->running = true;
+    this->core->dispatchEventLoop([this]() {
+      this->advance();
+    });
+  }
+
+  void Core::Timers::stop () {
+    Lock lock(this->mutex);
+    if (!this->running) {
+      return;
+    }
+
+    this->running = false;
+    this->core->dispatchEventLoop([this]() {
+      this->arm();
+    });
+  }
+
+  Core::Timers::ID Core::Timers::schedule (
+    uint64_t timeout,
+    uint64_t interval,
+    const Callback& callback
+  ) {
+    Lock lock(this->mutex);
+    const auto id = monotonic64();
+    const auto current = now() / RESOLUTION;
+
+    // avoid stepping through ticks where nothing was scheduled
+    this->wheel.reset(current);
+
+    const auto expires = std::max(current, this->wheel.now()) + ticks(timeout);
+    this->wheel.schedule(id, expires, ticks(interval), callback);
+
+    // only wake the loop when this timer is due before the armed deadline
+    if (this->running && (this->armed == 0 || expires < this->armed)) {
+      this->armed = expires;
+      this->core->dispatchEventLoop([this]() {
+        this->arm();
+      });
+    }
+
+    return id;
+  }
+
+  void Core::Timers::advance () {
+    Vector<TimingWheel::Expired> expired;
+
+    {
+      Lock lock(this->mutex);
+      if (!this->running) {
+        return;
+      }
+
+      this->wheel.advance(now() / RESOLUTION, expired);
+    }
+
+    for (const auto& timer : expired) {
+      Callback callback = nullptr;
+
+      {
+        Lock lock(this->mutex);
+        // an earlier callback may have cleared this timer
+        callback = this->wheel.take(timer.id);
+      }
+
+      if (callback != nullptr) {
+        callback();
+      }
+    }
+
+    this->arm();
+  }
+
+  void Core::Timers::arm () {
+    Lock lock(this->mutex);
+
+    if (!this->didInit) {
+      uv_timer_init(this->core->getEventLoop(), &this->handle);
+      this->handle.data = (void *) this;
+      this->didInit = true;
+    }
+
+    const auto next = this->wheel.next();
+
+    if (!this->running || next == 0) {
+      uv_timer_stop(&this->handle);
+      this->armed = 0;
+      return;
+    }
+
+    const auto deadline = next * RESOLUTION;
+    const auto current = now();
+    const auto timeout = deadline > current ? deadline - current : 0;
+
+    this->armed = next;
+    uv_timer_start(&this->handle, [](uv_timer_t *handle) {
+      auto timers = reinterpret_cast<Core::Timers *>(handle->data);
+      timers->advance();
+    }, timeout, 0);
+  }
+}
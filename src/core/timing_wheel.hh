@@ -0,0 +1,247 @@
+#ifndef SSC_CORE_TIMING_WHEEL_H
+#define SSC_CORE_TIMING_WHEEL_H
+
+#include <unordered_map>
+
+#include "types.hh"
+
+namespace SSC {
+  /**
+   * A hierarchical timing wheel keyed by abstract "ticks". Timers are kept
+   * in one of `LEVELS` wheels of `SLOTS` intrusive lists, where each level
+   * covers `SLOTS` times the range of the previous one, and are cascaded
+   * down as time advances. Scheduling and cancelling are O(1). Timers that
+   * expire in the same tick fire together. This class is not thread safe.
+   */
+  class TimingWheel {
+    public:
+      using ID = uint64_t;
+      using Callback = std::function<void()>;
+
+      static constexpr uint64_t LEVELS = 4;
+      static constexpr uint64_t SLOT_BITS = 6;
+      static constexpr uint64_t SLOTS = 1 << SLOT_BITS;
+      static constexpr uint64_t SLOT_MASK = SLOTS - 1;
+      static constexpr uint64_t MAX_DELTA = (uint64_t) 1 << (SLOT_BITS * LEVELS);
+
+      struct Expired {
+        ID id;
+        bool repeating;
+      };
+
+      TimingWheel (uint64_t tick = 0) : tick(tick) {}
+      TimingWheel (const TimingWheel&) = delete;
+      TimingWheel& operator = (const TimingWheel&) = delete;
+
+      ~TimingWheel () {
+        for (auto& entry : this->timers) {
+          delete entry.second;
+        }
+      }
+
+      /**
+       * Schedules `callback` to expire at `expires` (in ticks), repeating
+       * every `interval` ticks if `interval` is not `0`. Deadlines at or
+       * before the current tick expire on the next tick.
+       */
+      ID schedule (ID id, uint64_t expires, uint64_t interval, const Callback& callback) {
+        auto timer = new Timer();
+        timer->id = id;
+        timer->expires = std::max(expires, this->tick + 1);
+        timer->interval = interval;
+        timer->callback = callback;
+        this->timers.insert_or_assign(id, timer);
+        this->insert(timer);
+        return id;
+      }
+
+      bool cancel (ID id) {
+        const auto it = this->timers.find(id);
+        if (it == this->timers.end()) {
+          return false;
+        }
+
+        this->unlink(it->second);
+        delete it->second;
+        this->timers.erase(it);
+        return true;
+      }
+
+      bool has (ID id) const {
+        return this->timers.contains(id);
+      }
+
+      size_t size () const {
+        return this->timers.size();
+      }
+
+      bool empty () const {
+        return this->timers.empty();
+      }
+
+      uint64_t now () const {
+        return this->tick;
+      }
+
+      /**
+       * Moves the wheel to `tick` without expiring anything. Only valid
+       * while the wheel is empty, to avoid stepping through idle time.
+       */
+      void reset (uint64_t tick) {
+        if (this->timers.empty()) {
+          this->tick = tick;
+        }
+      }
+
+      /**
+       * Advances the wheel to `target`, appending expired timers in expiry
+       * order to `expired`. Repeating timers are rescheduled, others are
+       * left pending (unlinked) until `take()` or `cancel()` is called.
+       */
+      void advance (uint64_t target, Vector<Expired>& expired) {
+        while (this->tick < target) {
+          this->tick++;
+
+          for (uint64_t level = 1; level < LEVELS; ++level) {
+            const auto shift = SLOT_BITS * level;
+            if ((this->tick & ((1ull << shift) - 1)) != 0) {
+              break;
+            }
+
+            this->cascade(level, (this->tick >> shift) & SLOT_MASK);
+          }
+
+          auto& slot = this->wheel[0][this->tick & SLOT_MASK];
+          while (slot != nullptr) {
+            auto timer = slot;
+            this->unlink(timer);
+            expired.push_back({ timer->id, timer->interval > 0 });
+
+            if (timer->interval > 0) {
+              timer->expires = this->tick + timer->interval;
+              this->insert(timer);
+            }
+          }
+        }
+      }
+
+      /**
+       * Returns the callback for an expired timer, removing it if it does
+       * not repeat. Returns an empty callback if it was cancelled.
+       */
+      Callback take (ID id) {
+        const auto it = this->timers.find(id);
+        if (it == this->timers.end()) {
+          return nullptr;
+        }
+
+        auto timer = it->second;
+        if (timer->interval > 0) {
+          return timer->callback;
+        }
+
+        auto callback = std::move(timer->callback);
+        delete timer;
+        this->timers.erase(it);
+        return callback;
+      }
+
+      /**
+       * The next tick at which `advance()` has work to do, either expiring
+       * timers or cascading a higher level. `0` if the wheel is empty.
+       */
+      uint64_t next () const {
+        if (this->timers.empty()) {
+          return 0;
+        }
+
+        const auto boundary = (this->tick | SLOT_MASK) + 1;
+        for (auto tick = this->tick + 1; tick < boundary; ++tick) {
+          if (this->wheel[0][tick & SLOT_MASK] != nullptr) {
+            return tick;
+          }
+        }
+
+        return boundary;
+      }
+
+    private:
+      struct Timer {
+        ID id = 0;
+        uint64_t expires = 0;
+        uint64_t interval = 0;
+        Callback callback = nullptr;
+        Timer* prev = nullptr;
+        Timer* next = nullptr;
+        Timer** slot = nullptr;
+      };
+
+      uint64_t tick = 0;
+      Timer* wheel[LEVELS][SLOTS] = {{ nullptr }};
+      std::unordered_map<ID, Timer*> timers;
+
+      void insert (Timer* timer) {
+        auto delta = timer->expires - this->tick;
+        auto expires = timer->expires;
+
+        // deadlines beyond the top level are parked in its furthest slot
+        // and placed again when that slot is cascaded
+        if (delta >= MAX_DELTA) {
+          delta = MAX_DELTA - 1;
+          expires = this->tick + delta;
+        }
+
+        uint64_t level = 0;
+        while (level < LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1)))) {
+          level++;
+        }
+
+        const auto index = (expires >> (SLOT_BITS * level)) & SLOT_MASK;
+        auto& head = this->wheel[level][index];
+
+        timer->slot = &head;
+        timer->prev = nullptr;
+        timer->next = head;
+
+        if (head != nullptr) {
+          head->prev = timer;
+        }
+
+        head = timer;
+      }
+
+      void unlink (Timer* timer) {
+        if (timer->slot == nullptr) {
+          return;
+        }
+
+        if (timer->prev != nullptr) {
+          timer->prev->next = timer->next;
+        } else {
+          *timer->slot = timer->next;
+        }
+
+        if (timer->next != nullptr) {
+          timer->next->prev = timer->prev;
+        }
+
+        timer->slot = nullptr;
+        timer->prev = nullptr;
+        timer->next = nullptr;
+      }
+
+      void cascade (uint64_t level, uint64_t index) {
+        auto timer = this->wheel[level][index];
+        this->wheel[level][index] = nullptr;
+
+        while (timer != nullptr) {
+          auto next = timer->next;
+          timer->slot = nullptr;
+          this->insert(timer);
+          timer = next;
+        }
+      }
+  };
+}
+
+#endif
@@ -3,11 +3,15 @@
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <shared_mutex>
 #include <sstream>
 #include <string>
 #include <thread>
@@ -97,7 +97,7 @@ namespace SSC {
     UDP::BindOptions options,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
+    this->core->dispatchEventLoop(peerId, [=, this]() {
       if (this->core->hasPeer(peerId)) {
         if (this->core->getPeer(peerId)->isBound()) {
           auto json = ERR_SOCKET_ALREADY_BOUND("udp.bind", peerId);
@@ -155,7 +155,7 @@ namespace SSC {
     UDP::ConnectOptions options,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
+    this->core->dispatchEventLoop(peerId, [=, this]() {
       auto peer = this->core->createPeer(PEER_TYPE_UDP, peerId);
 
       if (peer->isConnected()) {
@@ -210,7 +210,7 @@ namespace SSC {
     uint64_t peerId,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
+    this->core->dispatchEventLoop(peerId, [=, this]() {
       if (!this->core->hasPeer(peerId)) {
         auto json = ERR_SOCKET_DGRAM_NOT_CONNECTED("udp.disconnect", peerId);
         return cb(seq, json, Post{});
@@ -350,7 +350,7 @@ namespace SSC {
     UDP::SendOptions options,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this] {
+    this->core->dispatchEventLoop(peerId, [=, this] {
       auto peer = this->core->createPeer(PEER_TYPE_UDP, peerId, options.ephemeral);
       auto size = options.size; // @TODO(jwerle): validate MTU
       auto port = options.port;
@@ -383,110 +383,112 @@ namespace SSC {
   }
 
   void Core::UDP::readStart (String seq, uint64_t peerId, Module::Callback cb) {
-    if (!this->core->hasPeer(peerId)) {
-      auto json = ERR_SOCKET_DGRAM_NOT_RUNNING("udp.readStart", peerId);
-      return cb(seq, json, Post{});
-    }
-
-    auto peer = this->core->getPeer(peerId);
-
-    if (peer->isClosed()) {
-      auto json = ERR_SOCKET_DGRAM_CLOSED("udp.readStart", peerId);
-      return cb(seq, json, Post{});
-    }
+    this->core->dispatchEventLoop(peerId, [=, this] {
+      if (!this->core->hasPeer(peerId)) {
+        auto json = ERR_SOCKET_DGRAM_NOT_RUNNING("udp.readStart", peerId);
+        return cb(seq, json, Post{});
+      }
 
-    if (peer->isClosing()) {
-      auto json = ERR_SOCKET_DGRAM_CLOSING("udp.readStart", peerId);
-      return cb(seq, json, Post{});
-    }
+      auto peer = this->core->getPeer(peerId);
 
-    if (peer->hasState(PEER_STATE_UDP_RECV_STARTED)) {
-      auto json = JSON::Object::Entries {
-        {"source", "udp.readStart"},
-        {"err", JSON::Object::Entries {
-          {"id", std::to_string(peerId)},
-          {"message", "Socket is already receiving"}
-        }}
-      };
+      if (peer->isClosed()) {
+        auto json = ERR_SOCKET_DGRAM_CLOSED("udp.readStart", peerId);
+        return cb(seq, json, Post{});
+      }
 
-      return cb(seq, json, Post{});
-    }
+      if (peer->isClosing()) {
+        auto json = ERR_SOCKET_DGRAM_CLOSING("udp.readStart", peerId);
+        return cb(seq, json, Post{});
+      }
 
-    if (peer->isActive()) {
-      auto json = JSON::Object::Entries {
-        {"source", "udp.readStart"},
-        {"data", JSON::Object::Entries {
-          {"id", std::to_string(peerId)}
-        }}
-      };
+      if (peer->hasState(PEER_STATE_UDP_RECV_STARTED)) {
+        auto json = JSON::Object::Entries {
+          {"source", "udp.readStart"},
+          {"err", JSON::Object::Entries {
+            {"id", std::to_string(peerId)},
+            {"message", "Socket is already receiving"}
+          }}
+        };
 
-      return cb(seq, json, Post{});
-    }
+        return cb(seq, json, Post{});
+      }
 
-    auto err = peer->recvstart([=](auto nread, auto buf, auto addr) {
-      if (nread == UV_EOF) {
+      if (peer->isActive()) {
         auto json = JSON::Object::Entries {
           {"source", "udp.readStart"},
           {"data", JSON::Object::Entries {
-            {"id", std::to_string(peerId)},
-            {"EOF", true}
+            {"id", std::to_string(peerId)}
           }}
         };
 
-        cb("-1", json, Post{});
-      } else if (nread > 0) {
-        char address[17] = {0};
-        Post post;
-        int port;
+        return cb(seq, json, Post{});
+      }
 
-        parseAddress((struct sockaddr *) addr, &port, address);
+      auto err = peer->recvstart([=](auto nread, auto buf, auto addr) {
+        if (nread == UV_EOF) {
+          auto json = JSON::Object::Entries {
+            {"source", "udp.readStart"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(peerId)},
+              {"EOF", true}
+            }}
+          };
 
-        auto headers = Headers {{
-          {"content-type" ,"application/octet-stream"},
-          {"content-length", nread}
-        }};
+          cb("-1", json, Post{});
+        } else if (nread > 0) {
+          char address[17] = {0};
+          Post post;
+          int port;
 
-        post.id = rand64();
-        post.body = buf->base;
-        post.length = (int) nread;
-        post.headers = headers.str();
+          parseAddress((struct sockaddr *) addr, &port, address);
+
+          auto headers = Headers {{
+            {"content-type" ,"application/octet-stream"},
+            {"content-length", nread}
+          }};
+
+          post.id = rand64();
+          post.body = buf->base;
+          post.length = (int) nread;
+          post.headers = headers.str();
+
+          auto json = JSON::Object::Entries {
+            {"source", "udp.readStart"},
+            {"data", JSON::Object::Entries {
+              {"id", std::to_string(peerId)},
+              {"port", port},
+              {"bytes", std::to_string(post.length)},
+              {"address", address}
+            }}
+          };
+
+          cb("-1", json, post);
+        }
+      });
 
+      // `UV_EALREADY || UV_EBUSY` could mean there might be
+      // active IO on the underlying handle
+      if (err < 0 && err != UV_EALREADY && err != UV_EBUSY) {
         auto json = JSON::Object::Entries {
           {"source", "udp.readStart"},
-          {"data", JSON::Object::Entries {
+          {"err", JSON::Object::Entries {
             {"id", std::to_string(peerId)},
-            {"port", port},
-            {"bytes", std::to_string(post.length)},
-            {"address", address}
+            {"message", String(uv_strerror(err))}
           }}
         };
 
-        cb("-1", json, post);
+        return cb(seq, json, Post{});
       }
-    });
 
-    // `UV_EALREADY || UV_EBUSY` could mean there might be
-    // active IO on the underlying handle
-    if (err < 0 && err != UV_EALREADY && err != UV_EBUSY) {
       auto json = JSON::Object::Entries {
         {"source", "udp.readStart"},
-        {"err", JSON::Object::Entries {
-          {"id", std::to_string(peerId)},
-          {"message", String(uv_strerror(err))}
+        {"data", JSON::Object::Entries {
+          {"id", std::to_string(peerId)}
         }}
       };
 
-      return cb(seq, json, Post{});
-    }
-
-    auto json = JSON::Object::Entries {
-      {"source", "udp.readStart"},
-      {"data", JSON::Object::Entries {
-        {"id", std::to_string(peerId)}
-      }}
-    };
-
-    cb(seq, json, Post {});
+      cb(seq, json, Post {});
+    });
   }
 
   void Core::UDP::readStop (
@@ -494,7 +496,7 @@ namespace SSC {
     uint64_t peerId,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this] {
+    this->core->dispatchEventLoop(peerId, [=, this] {
       if (!this->core->hasPeer(peerId)) {
         auto json = ERR_SOCKET_DGRAM_NOT_RUNNING("udp.readStop", peerId);
         return cb(seq, json, Post{});
@@ -554,7 +556,7 @@ namespace SSC {
     uint64_t peerId,
     Module::Callback cb
   ) {
-    this->core->dispatchEventLoop([=, this]() {
+    this->core->dispatchEventLoop(peerId, [=, this]() {
       if (!this->core->hasPeer(peerId)) {
         auto json = ERR_SOCKET_DGRAM_NOT_RUNNING("udp.close", peerId);
         return cb(seq, json, Post{});
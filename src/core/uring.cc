@@ -0,0 +1,639 @@
+#include "core.hh"
+
+#if SSC_IO_URING
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+namespace SSC {
+  // `uv_buf_t` is laid out as a `struct iovec` on unix, so vectored
+  // operations hand libuv's buffers to the kernel as they are
+  static_assert(sizeof(uv_buf_t) == sizeof(struct iovec));
+
+  static int enter (int fd, unsigned int count) {
+    return (int) syscall(__NR_io_uring_enter, fd, count, 0, 0, nullptr, 0);
+  }
+
+  static int setup (unsigned int entries, io_uring_params* params) {
+    return (int) syscall(__NR_io_uring_setup, entries, params);
+  }
+
+  static int registerRing (int fd, unsigned int opcode, void* arg, unsigned int count) {
+    return (int) syscall(__NR_io_uring_register, fd, opcode, arg, count);
+  }
+
+  static unsigned int load (unsigned int* pointer) {
+    return std::atomic_ref<unsigned int>(*pointer).load(std::memory_order_acquire);
+  }
+
+  static void store (unsigned int* pointer, unsigned int value) {
+    std::atomic_ref<unsigned int>(*pointer).store(value, std::memory_order_release);
+  }
+
+  template <typename T>
+  static T* offset (void* base, uint32_t offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+  }
+
+  // mirrors `uv__fs_statx()` in libuv
+  static void toStatBuffer (const struct statx* source, uv_stat_t* stat) {
+    stat->st_dev = makedev(source->stx_dev_major, source->stx_dev_minor);
+    stat->st_mode = source->stx_mode;
+    stat->st_nlink = source->stx_nlink;
+    stat->st_uid = source->stx_uid;
+    stat->st_gid = source->stx_gid;
+    stat->st_rdev = makedev(source->stx_rdev_major, source->stx_rdev_minor);
+    stat->st_ino = source->stx_ino;
+    stat->st_size = source->stx_size;
+    stat->st_blksize = source->stx_blksize;
+    stat->st_blocks = source->stx_blocks;
+    stat->st_atim.tv_sec = source->stx_atime.tv_sec;
+    stat->st_atim.tv_nsec = source->stx_atime.tv_nsec;
+    stat->st_mtim.tv_sec = source->stx_mtime.tv_sec;
+    stat->st_mtim.tv_nsec = source->stx_mtime.tv_nsec;
+    stat->st_ctim.tv_sec = source->stx_ctime.tv_sec;
+    stat->st_ctim.tv_nsec = source->stx_ctime.tv_nsec;
+    stat->st_birthtim.tv_sec = source->stx_btime.tv_sec;
+    stat->st_birthtim.tv_nsec = source->stx_btime.tv_nsec;
+    stat->st_flags = 0;
+    stat->st_gen = 0;
+  }
+
+  /**
+   * The shared submission and completion rings and the submission entries
+   * mapped from the ring descriptor.
+   */
+  struct IOUring::Ring {
+    void* sq = MAP_FAILED;
+    void* cq = MAP_FAILED;
+    size_t sqSize = 0;
+    size_t cqSize = 0;
+
+    io_uring_sqe* sqes = (io_uring_sqe*) MAP_FAILED;
+    size_t sqesSize = 0;
+
+    unsigned int* sqHead = nullptr;
+    unsigned int* sqTail = nullptr;
+    unsigned int* sqArray = nullptr;
+    unsigned int sqMask = 0;
+    unsigned int sqEntries = 0;
+
+    unsigned int* cqHead = nullptr;
+    unsigned int* cqTail = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    unsigned int cqMask = 0;
+    unsigned int cqEntries = 0;
+
+    // the submission tail, published to the kernel by `flush()`
+    unsigned int tail = 0;
+
+    ~Ring () {
+      if (this->sqes != MAP_FAILED) {
+        munmap(this->sqes, this->sqesSize);
+      }
+
+      if (this->cq != MAP_FAILED && this->cq != this->sq) {
+        munmap(this->cq, this->cqSize);
+      }
+
+      if (this->sq != MAP_FAILED) {
+        munmap(this->sq, this->sqSize);
+      }
+    }
+  };
+
+  /**
+   * One queued operation, its `user_data`. Operations are recycled through
+   * a per-thread free-list like `Core::FS::RequestContext`.
+   */
+  struct IOUring::Operation {
+    using Pool = ThreadLocalPool<Operation>;
+
+    uv_fs_t* req = nullptr;
+    uv_fs_cb cb = nullptr;
+    struct statx stat;
+
+    static void* operator new (size_t size) {
+      return Pool::allocate(size);
+    }
+
+    static void operator delete (void* pointer, size_t size) {
+      Pool::release(pointer, size);
+    }
+  };
+
+  IOUring::IOUring (uv_loop_t* loop) : loop(loop) {}
+
+  IOUring::~IOUring () {
+    if (this->eventFD >= 0) {
+      ::close(this->eventFD);
+    }
+
+    if (this->fd >= 0) {
+      ::close(this->fd);
+    }
+  }
+
+  // rings live as long as the loops they belong to, they are freed with
+  // `release()` when a loop is closed
+  static std::map<uv_loop_t*, IOUring*> rings;
+  static Mutex ringsMutex;
+
+  IOUring* IOUring::get (uv_loop_t* loop) {
+    Lock lock(ringsMutex);
+
+    if (rings.contains(loop)) {
+      return rings.at(loop);
+    }
+
+    auto uring = new IOUring(loop);
+
+    if (!uring->init()) {
+      delete uring;
+      uring = nullptr;
+    }
+
+    rings.insert_or_assign(loop, uring);
+    return uring;
+  }
+
+  void IOUring::release (uv_loop_t* loop) {
+    IOUring* uring = nullptr;
+
+    {
+      Lock lock(ringsMutex);
+      const auto it = rings.find(loop);
+
+      if (it != rings.end()) {
+        uring = it->second;
+        rings.erase(it);
+      }
+    }
+
+    if (uring == nullptr) {
+      return;
+    }
+
+    uring->stop();
+    // runs the close callbacks of the ring's handles
+    uv_run(loop, UV_RUN_NOWAIT);
+    delete uring;
+  }
+
+  bool IOUring::init (unsigned int entries) {
+    if (this->ready) {
+      return true;
+    }
+
+    io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    this->fd = setup(entries, &params);
+
+    if (this->fd < 0) {
+      return false;
+    }
+
+    // completions are never dropped, submitted data is copied by the
+    // kernel at submission and `-1` reads and writes at the file position
+    static constexpr auto features = (
+      IORING_FEAT_NODROP |
+      IORING_FEAT_SUBMIT_STABLE |
+      IORING_FEAT_RW_CUR_POS
+    );
+
+    if ((params.features & features) != features) {
+      return false;
+    }
+
+    auto ring = std::make_unique<Ring>();
+    const auto single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+    ring->sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    ring->cqSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+    if (single) {
+      ring->sqSize = ring->cqSize = std::max(ring->sqSize, ring->cqSize);
+    }
+
+    ring->sq = mmap(
+      nullptr,
+      ring->sqSize,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      this->fd,
+      IORING_OFF_SQ_RING
+    );
+
+    if (ring->sq == MAP_FAILED) {
+      return false;
+    }
+
+    ring->cq = single ? ring->sq : mmap(
+      nullptr,
+      ring->cqSize,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      this->fd,
+      IORING_OFF_CQ_RING
+    );
+
+    if (ring->cq == MAP_FAILED) {
+      return false;
+    }
+
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = (io_uring_sqe*) mmap(
+      nullptr,
+      ring->sqesSize,
+      PROT_READ | PROT_WRITE,
+      MAP_SHARED | MAP_POPULATE,
+      this->fd,
+      IORING_OFF_SQES
+    );
+
+    if (ring->sqes == MAP_FAILED) {
+      return false;
+    }
+
+    ring->sqHead = offset<unsigned int>(ring->sq, params.sq_off.head);
+    ring->sqTail = offset<unsigned int>(ring->sq, params.sq_off.tail);
+    ring->sqArray = offset<unsigned int>(ring->sq, params.sq_off.array);
+    ring->sqMask = *offset<unsigned int>(ring->sq, params.sq_off.ring_mask);
+    ring->sqEntries = *offset<unsigned int>(ring->sq, params.sq_off.ring_entries);
+    ring->tail = *ring->sqTail;
+
+    ring->cqHead = offset<unsigned int>(ring->cq, params.cq_off.head);
+    ring->cqTail = offset<unsigned int>(ring->cq, params.cq_off.tail);
+    ring->cqes = offset<io_uring_cqe>(ring->cq, params.cq_off.cqes);
+    ring->cqMask = *offset<unsigned int>(ring->cq, params.cq_off.ring_mask);
+    ring->cqEntries = *offset<unsigned int>(ring->cq, params.cq_off.ring_entries);
+
+    this->ring = std::move(ring);
+
+    // every operation `UVFS` may submit must be supported, otherwise the
+    // loop keeps using libuv for all of them
+    static constexpr uint8_t operations[] = {
+      IORING_OP_OPENAT,
+      IORING_OP_CLOSE,
+      IORING_OP_READ,
+      IORING_OP_WRITE,
+      IORING_OP_READV,
+      IORING_OP_WRITEV,
+      IORING_OP_STATX,
+      IORING_OP_FSYNC
+    };
+
+    const auto probeSize = sizeof(io_uring_probe) + 256 * sizeof(io_uring_probe_op);
+    auto probe = std::unique_ptr<char[]>(new char[probeSize]{0});
+    auto probed = reinterpret_cast<io_uring_probe*>(probe.get());
+
+    if (registerRing(this->fd, IORING_REGISTER_PROBE, probed, 256) < 0) {
+      return false;
+    }
+
+    for (const auto operation : operations) {
+      if (
+        operation > probed->last_op ||
+        (probed->ops[operation].flags & IO_URING_OP_SUPPORTED) == 0
+      ) {
+        return false;
+      }
+    }
+
+    this->eventFD = ::eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+
+    if (this->eventFD < 0) {
+      return false;
+    }
+
+    if (registerRing(this->fd, IORING_REGISTER_EVENTFD, &this->eventFD, 1) < 0) {
+      return false;
+    }
+
+    this->poll.data = (void *) this;
+    this->idle.data = (void *) this;
+
+    if (uv_poll_init(this->loop, &this->poll, this->eventFD) < 0) {
+      return false;
+    }
+
+    uv_idle_init(this->loop, &this->idle);
+    uv_poll_start(&this->poll, UV_READABLE, [](uv_poll_t* handle, int status, int events) {
+      auto uring = reinterpret_cast<IOUring*>(handle->data);
+      uint64_t count = 0;
+      // resets the counter, completions posted after this signal again
+      while (::read(uring->eventFD, &count, sizeof(count)) < 0 && errno == EINTR);
+      uring->reap();
+    });
+
+    // the loop is only kept alive while operations are in flight
+    uv_unref((uv_handle_t*) &this->poll);
+    this->ready = true;
+    return true;
+  }
+
+  void IOUring::stop () {
+    if (!this->ready) {
+      return;
+    }
+
+    this->ready = false;
+    uv_poll_stop(&this->poll);
+    uv_idle_stop(&this->idle);
+    uv_close((uv_handle_t*) &this->poll, nullptr);
+    uv_close((uv_handle_t*) &this->idle, nullptr);
+  }
+
+  bool IOUring::isReady () const {
+    return this->ready;
+  }
+
+  size_t IOUring::getPendingCount () const {
+    return this->inflight;
+  }
+
+  IOUring::Stats IOUring::stats () const {
+    return this->counters;
+  }
+
+  io_uring_sqe* IOUring::prepare (uv_fs_t* req, uv_fs_type type, uv_fs_cb cb) {
+    if (!this->ready || this->inflight >= this->ring->cqEntries) {
+      this->counters.refused++;
+      return nullptr;
+    }
+
+    auto ring = this->ring.get();
+
+    if (ring->tail - load(ring->sqHead) >= ring->sqEntries) {
+      this->flush();
+
+      if (ring->tail - load(ring->sqHead) >= ring->sqEntries) {
+        this->counters.refused++;
+        return nullptr;
+      }
+    }
+
+    // the request is completed as if libuv had run it, so the getters and
+    // `uv_fs_req_cleanup()` work on it as usual
+    const auto data = req->data;
+    memset(req, 0, sizeof(uv_fs_t));
+    req->data = data;
+    req->type = UV_FS;
+    req->loop = this->loop;
+    req->fs_type = type;
+    req->cb = cb;
+
+    auto operation = new Operation();
+    operation->req = req;
+    operation->cb = cb;
+
+    const auto index = ring->tail & ring->sqMask;
+    auto sqe = &ring->sqes[index];
+    memset(sqe, 0, sizeof(io_uring_sqe));
+    sqe->user_data = (uint64_t) (uintptr_t) operation;
+    ring->sqArray[index] = index;
+    ring->tail++;
+
+    this->pending++;
+    this->inflight++;
+    this->update();
+    return sqe;
+  }
+
+  void IOUring::flush () {
+    if (this->pending == 0) {
+      return;
+    }
+
+    store(this->ring->sqTail, this->ring->tail);
+    const auto submitted = enter(this->fd, this->pending);
+    this->counters.enters++;
+
+    // `EAGAIN`, `EBUSY` and `EINTR` are retried on the next iteration
+    if (submitted > 0) {
+      this->pending -= submitted;
+      this->counters.submitted += submitted;
+    }
+
+    this->update();
+  }
+
+  void IOUring::reap () {
+    auto ring = this->ring.get();
+    auto head = *ring->cqHead;
+
+    while (head != load(ring->cqTail)) {
+      const auto cqe = &ring->cqes[head & ring->cqMask];
+      auto operation = reinterpret_cast<Operation*>((uintptr_t) cqe->user_data);
+      const auto result = cqe->res;
+
+      store(ring->cqHead, ++head);
+      this->inflight--;
+      this->counters.completed++;
+
+      auto req = operation->req;
+      auto cb = operation->cb;
+      req->result = result;
+
+      if (result >= 0) {
+        switch (req->fs_type) {
+          case UV_FS_STAT:
+          case UV_FS_LSTAT:
+          case UV_FS_FSTAT:
+            toStatBuffer(&operation->stat, &req->statbuf);
+            req->ptr = &req->statbuf;
+            break;
+          default:
+            break;
+        }
+      }
+
+      delete operation;
+      cb(req);
+    }
+
+    this->update();
+  }
+
+  void IOUring::update () {
+    if (!this->ready) {
+      return;
+    }
+
+    // queued operations are submitted in the idle phase, which also keeps
+    // the loop from blocking in poll while they wait
+    if (this->pending > 0) {
+      uv_idle_start(&this->idle, [](uv_idle_t* handle) {
+        auto uring = reinterpret_cast<IOUring*>(handle->data);
+        uring->flush();
+        // cached reads and writes usually complete during the submission
+        uring->reap();
+      });
+    } else {
+      uv_idle_stop(&this->idle);
+    }
+
+    if (this->inflight > 0) {
+      uv_ref((uv_handle_t*) &this->poll);
+    } else {
+      uv_unref((uv_handle_t*) &this->poll);
+    }
+  }
+
+  int IOUring::open (uv_fs_t* req, const char* path, int flags, int mode, uv_fs_cb cb) {
+    auto sqe = this->prepare(req, UV_FS_OPEN, cb);
+
+    if (sqe == nullptr) {
+      return UV_ENOSYS;
+    }
+
+    sqe->opcode = IORING_OP_OPENAT;
+    sqe->fd = AT_FDCWD;
+    sqe->addr = (uint64_t) (uintptr_t) path;
+    sqe->len = (uint32_t) mode;
+    // like `uv_fs_open()`, descriptors are not inherited by children
+    sqe->open_flags = (uint32_t) (flags | O_CLOEXEC);
+    return 0;
+  }
+
+  int IOUring::close (uv_fs_t* req, uv_file fd, uv_fs_cb cb) {
+    auto sqe = this->prepare(req, UV_FS_CLOSE, cb);
+
+    if (sqe == nullptr) {
+      return UV_ENOSYS;
+    }
+
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = fd;
+    return 0;
+  }
+
+  int IOUring::read (
+    uv_fs_t* req,
+    uv_file fd,
+    const uv_buf_t buffers[],
+    unsigned int count,
+    int64_t offset,
+    uv_fs_cb cb
+  ) {
+    auto sqe = this->prepare(req, UV_FS_READ, cb);
+
+    if (sqe == nullptr) {
+      return UV_ENOSYS;
+    }
+
+    sqe->fd = fd;
+    // a negative offset reads from the file position, like `read(2)`
+    sqe->off = offset < 0 ? (uint64_t) -1 : (uint64_t) offset;
+
+    if (count == 1) {
+      sqe->opcode = IORING_OP_READ;
+      sqe->addr = (uint64_t) (uintptr_t) buffers[0].base;
+      sqe->len = (uint32_t) buffers[0].len;
+    } else {
+      sqe->opcode = IORING_OP_READV;
+      sqe->addr = (uint64_t) (uintptr_t) buffers;
+      sqe->len = count;
+    }
+
+    return 0;
+  }
+
+  int IOUring::write (
+    uv_fs_t* req,
+    uv_file fd,
+    const uv_buf_t buffers[],
+    unsigned int count,
+    int64_t offset,
+    uv_fs_cb cb
+  ) {
+    auto sqe = this->prepare(req, UV_FS_WRITE, cb);
+
+    if (sqe == nullptr) {
+      return UV_ENOSYS;
+    }
+
+    sqe->fd = fd;
+    sqe->off = offset < 0 ? (uint64_t) -1 : (uint64_t) offset;
+
+    if (count == 1) {
+      sqe->opcode = IORING_OP_WRITE;
+      sqe->addr = (uint64_t) (uintptr_t) buffers[0].base;
+      sqe->len = (uint32_t) buffers[0].len;
+    } else {
+      sqe->opcode = IORING_OP_WRITEV;
+      sqe->addr = (uint64_t) (uintptr_t) buffers;
+      sqe->len = count;
+    }
+
+    return 0;
+  }
+
+  int IOUring::statx (
+    uv_fs_t* req,
+    uv_fs_type type,
+    int dirfd,
+    const char* path,
+    int flags,
+    uv_fs_cb cb
+  ) {
+    auto sqe = this->prepare(req, type, cb);
+
+    if (sqe == nullptr) {
+      return UV_ENOSYS;
+    }
+
+    auto operation = reinterpret_cast<Operation*>((uintptr_t) sqe->user_data);
+    sqe->opcode = IORING_OP_STATX;
+    sqe->fd = dirfd;
+    sqe->addr = (uint64_t) (uintptr_t) path;
+    sqe->len = STATX_BASIC_STATS | STATX_BTIME;
+    sqe->off = (uint64_t) (uintptr_t) &operation->stat;
+    sqe->statx_flags = (uint32_t) flags;
+    return 0;
+  }
+
+  int IOUring::stat (uv_fs_t* req, const char* path, uv_fs_cb cb) {
+    return this->statx(req, UV_FS_STAT, AT_FDCWD, path, AT_STATX_SYNC_AS_STAT, cb);
+  }
+
+  int IOUring::lstat (uv_fs_t* req, const char* path, uv_fs_cb cb) {
+    return this->statx(req, UV_FS_LSTAT, AT_FDCWD, path, AT_SYMLINK_NOFOLLOW, cb);
+  }
+
+  int IOUring::fstat (uv_fs_t* req, uv_file fd, uv_fs_cb cb) {
+    return this->statx(req, UV_FS_FSTAT, fd, "", AT_EMPTY_PATH, cb);
+  }
+
+  int IOUring::fsync (uv_fs_t* req, uv_file fd, uv_fs_cb cb) {
+    auto sqe = this->prepare(req, UV_FS_FSYNC, cb);
+
+    if (sqe == nullptr) {
+      return UV_ENOSYS;
+    }
+
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd;
+    return 0;
+  }
+
+  int IOUring::fdatasync (uv_fs_t* req, uv_file fd, uv_fs_cb cb) {
+    auto sqe = this->prepare(req, UV_FS_FDATASYNC, cb);
+
+    if (sqe == nullptr) {
+      return UV_ENOSYS;
+    }
+
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd;
+    sqe->fsync_flags = IORING_FSYNC_DATASYNC;
+    return 0;
+  }
+}
+#endif
@@ -0,0 +1,129 @@
+#ifndef SSC_CORE_URING_H
+#define SSC_CORE_URING_H
+
+#include "platform.hh"
+#include "types.hh"
+
+#if defined(__linux__) && !defined(__ANDROID__) && __has_include(<linux/io_uring.h>)
+#define SSC_IO_URING 1
+#else
+#define SSC_IO_URING 0
+#endif
+
+#if SSC_IO_URING
+struct io_uring_sqe;
+
+namespace SSC {
+  /**
+   * An `io_uring(7)` instance bound to a libuv loop. Operations mirror the
+   * `uv_fs_*` functions they replace and complete the same `uv_fs_t` with
+   * the same callback, so `UVFS` can use either. Submissions are queued and
+   * handed to the kernel with one `io_uring_enter(2)` per loop iteration,
+   * completions are signaled through an `eventfd(2)` polled by the loop.
+   *
+   * Operations return `UV_ENOSYS` when the ring can't take them (no ring,
+   * too many in flight), callers are expected to fall back to libuv. All
+   * methods must be called on the loop thread.
+   */
+  class IOUring {
+    public:
+      static constexpr unsigned int ENTRIES = 256;
+
+      struct Stats {
+        // operations handed to the kernel
+        uint64_t submitted = 0;
+        // operations whose completion was delivered
+        uint64_t completed = 0;
+        // `io_uring_enter(2)` calls made to submit
+        uint64_t enters = 0;
+        // operations refused because the ring was full
+        uint64_t refused = 0;
+      };
+
+      IOUring (uv_loop_t* loop);
+      IOUring (const IOUring&) = delete;
+      ~IOUring ();
+
+      /**
+       * The ring for `loop`, created on first use from the loop thread.
+       * Returns `nullptr` if the kernel or a seccomp policy doesn't allow
+       * `io_uring` or lacks an operation used here.
+       */
+      static IOUring* get (uv_loop_t* loop);
+
+      /**
+       * Stops and frees the ring of `loop`, if any, so a loop created later
+       * at the same address gets its own. Call it from the thread closing
+       * `loop`, once it no longer runs elsewhere, before `uv_loop_close()`.
+       */
+      static void release (uv_loop_t* loop);
+
+      /**
+       * Sets up the ring and starts polling its `eventfd` on the loop.
+       */
+      bool init (unsigned int entries = ENTRIES);
+
+      /**
+       * Stops polling, the ring is unmapped by the destructor once the
+       * loop has closed the handles.
+       */
+      void stop ();
+      bool isReady () const;
+      size_t getPendingCount () const;
+      Stats stats () const;
+
+      /**
+       * Submits queued operations now instead of at the next iteration.
+       */
+      void flush ();
+
+      int open (uv_fs_t* req, const char* path, int flags, int mode, uv_fs_cb cb);
+      int close (uv_fs_t* req, uv_file fd, uv_fs_cb cb);
+      int read (
+        uv_fs_t* req,
+        uv_file fd,
+        const uv_buf_t buffers[],
+        unsigned int count,
+        int64_t offset,
+        uv_fs_cb cb
+      );
+      int write (
+        uv_fs_t* req,
+        uv_file fd,
+        const uv_buf_t buffers[],
+        unsigned int count,
+        int64_t offset,
+        uv_fs_cb cb
+      );
+      int stat (uv_fs_t* req, const char* path, uv_fs_cb cb);
+      int lstat (uv_fs_t* req, const char* path, uv_fs_cb cb);
+      int fstat (uv_fs_t* req, uv_file fd, uv_fs_cb cb);
+      int fsync (uv_fs_t* req, uv_file fd, uv_fs_cb cb);
+      int fdatasync (uv_fs_t* req, uv_file fd, uv_fs_cb cb);
+
+    private:
+      struct Operation;
+      struct Ring;
+
+      uv_loop_t* loop = nullptr;
+      uv_poll_t poll;
+      uv_idle_t idle;
+      std::unique_ptr<Ring> ring;
+      int fd = -1;
+      int eventFD = -1;
+      bool ready = false;
+      // queued but not yet submitted
+      unsigned int pending = 0;
+      // submitted or queued, waiting for a completion
+      unsigned int inflight = 0;
+      Stats counters;
+
+      io_uring_sqe* prepare (uv_fs_t* req, uv_fs_type type, uv_fs_cb cb);
+      int statx (uv_fs_t* req, uv_fs_type type, int dirfd, const char* path, int flags, uv_fs_cb cb);
+      void reap ();
+      void update ();
+  };
+}
+#endif
+
+#endif
@@ -0,0 +1,232 @@
+#include "core.hh"
+
+namespace SSC {
+  // the pool and index of the worker running on the current thread, used to
+  // push work dispatched from a worker onto its own deque
+  static thread_local Core::Workers* currentWorkers = nullptr;
+  static thread_local size_t currentWorkerIndex = 0;
+
+  Core::Workers::~Workers () {
+    this->stop();
+  }
+
+  void Core::Workers::start (size_t count) {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    if (this->running) {
+      return;
+    }
+
+    if (count == 0) {
+      static auto userConfig = getUserConfig();
+      try {
+        count = std::stoul(userConfig["core_workers"]);
+      } catch (...) {
+        count = 0;
+      }
+    }
+
+    if (count == 0) {
+      count = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    {
+      // a previous `stop()` drained the queues and joined their threads
+      // before releasing `mutex`
+      std::unique_lock<std::shared_mutex> state(this->state);
+      this->queues.clear();
+
+      for (size_t i = 0; i < count; ++i) {
+        this->queues.push_back(std::make_unique<Worker>());
+      }
+
+      this->running = true;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      this->threads.emplace_back(&Workers::run, this, i);
+    }
+  }
+
+  void Core::Workers::stop () {
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    {
+      std::unique_lock<std::shared_mutex> state(this->state);
+      if (!this->running) {
+        return;
+      }
+
+      // dispatches from other threads wait in `start()` from here on
+      this->running = false;
+    }
+
+    for (auto& worker : this->queues) {
+      {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+      }
+
+      worker->condition.notify_all();
+    }
+
+    for (auto& thread : this->threads) {
+      if (thread.joinable()) {
+        thread.join();
+      }
+    }
+
+    this->threads.clear();
+  }
+
+  bool Core::Workers::isRunning () {
+    return this->running;
+  }
+
+  size_t Core::Workers::size () {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->threads.size();
+  }
+
+  void Core::Workers::dispatch (Task task) {
+    if (!task) {
+      return;
+    }
+
+    while (true) {
+      std::shared_lock<std::shared_mutex> state(this->state);
+
+      // a worker keeps pushing onto its own deque while the pool stops, as
+      // it drains that before it exits
+      if (!this->running && currentWorkers != this) {
+        state.unlock();
+        this->start();
+        continue;
+      }
+
+      const auto index = currentWorkers == this
+        ? currentWorkerIndex
+        : this->next.fetch_add(1, std::memory_order_relaxed) % this->queues.size();
+
+      auto& worker = *this->queues[index];
+      bool isSleeping = false;
+
+      {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+        isSleeping = worker.isSleeping;
+        this->queued++;
+      }
+
+      this->submitted++;
+
+      // wake the worker, or while it is busy, another one to steal the task
+      if (isSleeping) {
+        worker.condition.notify_one();
+      } else if (this->sleeping > 0) {
+        this->wake(index);
+      }
+
+      return;
+    }
+  }
+
+  void Core::Workers::wake (size_t index) {
+    const auto count = this->queues.size();
+
+    for (size_t i = 1; i < count; ++i) {
+      auto& worker = *this->queues[(index + i) % count];
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      if (worker.isSleeping) {
+        lock.unlock();
+        worker.condition.notify_one();
+        return;
+      }
+    }
+  }
+
+  bool Core::Workers::pop (size_t index, Task& task) {
+    const auto count = this->queues.size();
+
+    // own work, newest first
+    {
+      auto& worker = *this->queues[index];
+      std::lock_guard<std::mutex> lock(worker.mutex);
+      if (worker.tasks.size() > 0) {
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        this->queued--;
+        return true;
+      }
+    }
+
+    // steal the oldest work from the others
+    for (size_t i = 1; i < count; ++i) {
+      auto& victim = *this->queues[(index + i) % count];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (victim.tasks.size() > 0) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        this->queued--;
+        this->stolen++;
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  void Core::Workers::run (size_t index) {
+    auto& worker = *this->queues[index];
+    Task task;
+
+    currentWorkers = this;
+    currentWorkerIndex = index;
+
+    while (true) {
+      if (this->pop(index, task)) {
+        this->active++;
+        task();
+        task.reset();
+        this->active--;
+        worker.completed++;
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(worker.mutex);
+
+      // queued work is drained before the pool stops
+      if (!this->running && this->queued == 0) {
+        break;
+      }
+
+      // `dispatch()` counts a task as queued before it reads `sleeping`,
+      // so either it wakes a sleeping worker or the worker sees the task
+      worker.isSleeping = true;
+      this->sleeping++;
+      worker.condition.wait(lock, [this, &worker]() {
+        return worker.tasks.size() > 0 || this->queued > 0 || !this->running;
+      });
+      this->sleeping--;
+      worker.isSleeping = false;
+    }
+
+    currentWorkers = nullptr;
+  }
+
+  Core::Workers::Stats Core::Workers::stats () {
+    std::lock_guard<std::mutex> lock(this->mutex);
+    Stats stats;
+
+    stats.threads = this->threads.size();
+    stats.queued = this->queued;
+    stats.active = this->active;
+    stats.submitted = this->submitted;
+    stats.stolen = this->stolen;
+
+    for (const auto& worker : this->queues) {
+      stats.completed += worker->completed;
+    }
+
+    return stats;
+  }
+}
@@ -50,6 +50,78 @@ bool sapi_context_dispatch (
   });
 }
 
+uint64_t sapi_context_set_timeout (
+  sapi_context_t* ctx,
+  uint64_t timeout,
+  const void* data,
+  sapi_context_dispatch_callback callback
+) {
+  if (ctx == nullptr || callback == nullptr) return 0;
+  if (ctx->router == nullptr) return 0;
+  if (ctx->router->bridge == nullptr) return 0;
+  if (ctx->router->bridge->core == nullptr) return 0;
+
+  if (!ctx->isAllowed("context_set_timeout")) {
+    sapi_debug(ctx, "'context_set_timeout' is not allowed.");
+    return 0;
+  }
+
+  auto core = ctx->router->bridge->core;
+  auto id = core->timers.setTimeout(timeout, [=]() {
+    callback(ctx, data);
+  });
+
+  // cleared when the context is released, so it never calls into freed state
+  ctx->memory.push([core, id]() {
+    core->timers.clearTimeout(id);
+  });
+
+  return id;
+}
+
+uint64_t sapi_context_set_interval (
+  sapi_context_t* ctx,
+  uint64_t interval,
+  const void* data,
+  sapi_context_dispatch_callback callback
+) {
+  if (ctx == nullptr || callback == nullptr) return 0;
+  if (ctx->router == nullptr) return 0;
+  if (ctx->router->bridge == nullptr) return 0;
+  if (ctx->router->bridge->core == nullptr) return 0;
+
+  if (!ctx->isAllowed("context_set_interval")) {
+    sapi_debug(ctx, "'context_set_interval' is not allowed.");
+    return 0;
+  }
+
+  auto core = ctx->router->bridge->core;
+  auto id = core->timers.setInterval(interval, [=]() {
+    callback(ctx, data);
+  });
+
+  // cleared on release, like timeouts
+  ctx->memory.push([core, id]() {
+    core->timers.clearInterval(id);
+  });
+
+  return id;
+}
+
+bool sapi_context_clear_timeout (sapi_context_t* ctx, uint64_t id) {
+  if (ctx == nullptr) return false;
+  if (ctx->router == nullptr) return false;
+  if (ctx->router->bridge == nullptr) return false;
+  if (ctx->router->bridge->core == nullptr) return false;
+
+  if (!ctx->isAllowed("context_clear_timeout")) {
+    sapi_debug(ctx, "'context_clear_timeout' is not allowed.");
+    return false;
+  }
+
+  return ctx->router->bridge->core->timers.clearTimeout(id);
+}
+
 void sapi_context_retain (sapi_context_t* ctx) {
   if (ctx == nullptr) return;
   if (!ctx->isAllowed("context_retain")) {
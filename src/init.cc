@@ -4,18 +4,45 @@
 #include "core/ini.hh"
 
 #if defined(__cplusplus)
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+
+#include "user-config-bytes.hh" // NOLINT
+
 // These rely on project-specific, compile-time variables.
 namespace SSC {
   bool isDebugEnabled () {
     return DEBUG == 1;
   }
 
-  const Map getUserConfig () {
-    #include "user-config-bytes.hh" // NOLINT
-    return INI::parse(std::string(
-      (const char*) __ssc_config_bytes,
-      sizeof(__ssc_config_bytes)
-    ));
+  const Map& getUserConfig () {
+    // built once from the pre-parsed, sorted table emitted by `ssc build`
+    static const Map userConfig = []() {
+      Map config;
+      for (size_t i = 0; i < __ssc_config_size; ++i) {
+        config.emplace_hint(
+          config.end(),
+          String(__ssc_config_keys[i]),
+          String(__ssc_config_values[i])
+        );
+      }
+      return config;
+    }();
+
+    return userConfig;
+  }
+
+  const String getUserConfigValue (const String& key) {
+    const auto begin = std::begin(__ssc_config_keys);
+    const auto end = std::end(__ssc_config_keys);
+    const auto it = std::lower_bound(begin, end, std::string_view(key));
+
+    if (it != end && *it == key) {
+      return String(__ssc_config_values[it - begin]);
+    }
+
+    return "";
   }
 
   const char* getDevHost () {
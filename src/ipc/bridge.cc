@@ -13,7 +13,7 @@
 #define IPC_BINARY_CONTENT_TYPE "application/octet-stream"
 #define IPC_JSON_CONTENT_TYPE "text/json"
 
-extern const SSC::Map SSC::getUserConfig ();
+extern const SSC::Map& SSC::getUserConfig ();
 extern bool SSC::isDebugEnabled ();
 
 using namespace SSC;
@@ -113,12 +113,21 @@ static String getcwd () {
   }                                                                            \
                                                                                \
   if (!router->core->hasPostBody(result.post.body)) {                          \
-    if (result.post.body != nullptr) {                                         \
-      delete [] result.post.body;                                              \
-    }                                                                          \
+    freePostBody(result.post);                                                 \
   }                                                                            \
 }
 
+// parses a comma separated list of segment sizes, like `sizes=16,1024,8`
+static Vector<size_t> parseSegmentSizes (const String& value) {
+  Vector<size_t> sizes;
+
+  for (const auto& size : split(value, ',')) {
+    sizes.push_back(std::stoull(trim(size)));
+  }
+
+  return sizes;
+}
+
 static void initRouterTable (Router *router) {
   static auto userConfig = SSC::getUserConfig();
 #if defined(__APPLE__)
@@ -226,6 +235,33 @@ static void initRouterTable (Router *router) {
     reply(Result { message.seq, message });
   });
 
+  /**
+   * Returns core event loop metrics: utilization, iterations, dispatch queue
+   * depth, dispatch latency and loop lag. Sampling starts on the first call.
+   */
+  router->map("diagnostics.loop", [](auto message, auto router, auto reply) {
+    router->core->diagnostics.loop(message.seq, RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply));
+  });
+
+  /**
+   * Returns open file and directory descriptor metrics: the number open and
+   * awaiting collection, bytes read and written through them and their ages
+   * in milliseconds.
+   */
+  router->map("diagnostics.descriptors", [](auto message, auto router, auto reply) {
+    router->core->diagnostics.descriptors(message.seq, RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply));
+  });
+
+  /**
+   * Returns `fs.stat`, `fs.lstat` and `fs.access` metadata cache counters:
+   * hits, misses, stores, invalidations, evictions, expirations, the number
+   * of entries and of watched directories. `enabled` is `false` unless
+   * `[core] fs_metadata_cache` is set.
+   */
+  router->map("diagnostics.metadataCache", [](auto message, auto router, auto reply) {
+    router->core->diagnostics.metadataCache(message.seq, RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply));
+  });
+
   /**
    * Look up an IP address by `hostname`.
    * @param hostname Host name to lookup
@@ -691,6 +727,78 @@ static void initRouterTable (Router *router) {
     router->core->fs.fstat(message.seq, id, RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply));
   });
 
+  /**
+   * Flushes an open file descriptor to its storage device.
+   * @param id
+   * @param datasync
+   * @see fsync(2)
+   * @see fdatasync(2)
+   */
+  router->map("fs.fsync", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+
+    router->core->fs.fsync(
+      message.seq,
+      id,
+      message.get("datasync") == "true",
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
+  /**
+   * Hashes the contents of a file, or of each of many files in parallel,
+   * natively and replies with the hex digest.
+   * @param path
+   * @param paths Newline separated paths to hash instead of `path`
+   * @param algorithm `sha256` (default), `sha1` or `blake3`
+   */
+  router->map("fs.hash", [](auto message, auto router, auto reply) {
+    auto algorithm = Hasher::Algorithm::SHA256;
+
+    if (!Hasher::parse(message.get("algorithm", "sha256"), algorithm)) {
+      return reply(Result::Err { message, JSON::Object::Entries {
+        {"message", "Invalid 'algorithm' given in parameters"}
+      }});
+    }
+
+    if (message.has("paths")) {
+      Vector<String> paths;
+
+      for (const auto& path : split(message.get("paths"), '\n')) {
+        if (path.size() > 0) {
+          paths.push_back(path);
+        }
+      }
+
+      return router->core->fs.hash(
+        message.seq,
+        paths,
+        algorithm,
+        RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+      );
+    }
+
+    if (!message.has("path")) {
+      return reply(Result::Err { message, JSON::Object::Entries {
+        {"message", "Expecting 'path' or 'paths' in parameters"}
+      }});
+    }
+
+    router->core->fs.hash(
+      message.seq,
+      message.get("path"),
+      algorithm,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
   /**
    * Returns all open file or directory descriptors.
    */
@@ -748,6 +856,74 @@ static void initRouterTable (Router *router) {
   });
 
 
+  /**
+   * Removes `path`, with `recursive` the directories in it and their
+   * entries. Progress and errors are emitted as events for `id`.
+   * @param id
+   * @param path
+   * @param recursive
+   * @param force Ignore `path` not existing
+   * @see unlink(2)
+   * @see rmdir(2)
+   */
+  router->map("fs.rm", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "path"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+
+    router->core->fs.rm(
+      message.seq,
+      id,
+      message.get("path"),
+      message.get("recursive") == "true",
+      message.get("force") == "true",
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
+  /**
+   * Copies `src` to `dest`, with `recursive` the directories in it and
+   * their entries. Files are cloned where the file system supports it.
+   * Progress and errors are emitted as events for `id`.
+   * @param id
+   * @param src
+   * @param dest
+   * @param recursive
+   * @param force Overwrite existing files
+   * @param errorOnExist Fail on existing files when not `force`
+   * @param dereference Follow symbolic links
+   */
+  router->map("fs.cp", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "src", "dest"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+
+    auto options = Core::FS::CopyOptions {};
+    options.recursive = message.get("recursive") == "true";
+    options.force = message.get("force") != "false";
+    options.errorOnExist = message.get("errorOnExist") == "true";
+    options.dereference = message.get("dereference") == "true";
+
+    router->core->fs.cp(
+      message.seq,
+      id,
+      message.get("src"),
+      message.get("dest"),
+      options,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
   /**
    * Opens a file descriptor at `path` for `id` with `flags` and `mode`
    * @param id
@@ -778,6 +954,7 @@ static void initRouterTable (Router *router) {
     router->core->fs.open(
       message.seq,
       id,
+      message.index,
       message.get("path"),
       flags,
       mode,
@@ -804,6 +981,7 @@ static void initRouterTable (Router *router) {
     router->core->fs.opendir(
       message.seq,
       id,
+      message.index,
       message.get("path"),
       RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
     );
@@ -839,6 +1017,62 @@ static void initRouterTable (Router *router) {
     );
   });
 
+  /**
+   * Reads the entire file at `path` in one round trip. The file is opened,
+   * stat'd, read and closed on the event loop.
+   * @param path
+   * @param flags (default: O_RDONLY)
+   */
+  router->map("fs.readFile", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"path"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    int flags = 0;
+    REQUIRE_AND_GET_MESSAGE_VALUE(flags, "flags", std::stoi, std::to_string(O_RDONLY));
+
+    router->core->fs.readFile(
+      message.seq,
+      message.get("path"),
+      flags,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
+  /**
+   * Reads into segments of `sizes` bytes from descriptor `id` at `offset`
+   * with a single vectored read. The response body holds the segments back
+   * to back, up to the number of bytes read.
+   * @param id
+   * @param sizes comma separated segment sizes
+   * @param offset
+   * @see preadv(2)
+   */
+  router->map("fs.readv", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "sizes", "offset"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    int64_t offset = 0;
+    Vector<size_t> sizes;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(offset, "offset", std::stoll);
+    REQUIRE_AND_GET_MESSAGE_VALUE(sizes, "sizes", parseSegmentSizes);
+
+    router->core->fs.readv(
+      message.seq,
+      id,
+      sizes,
+      offset,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
   /**
    * Reads next `entries` of from the underlying directory descriptor.
    * @param id
@@ -864,6 +1098,34 @@ static void initRouterTable (Router *router) {
     );
   });
 
+  /**
+   * Reads next `entries` of from the underlying directory descriptor with
+   * the stats of each entry, in one response.
+   * @param id
+   * @param entries (default: 256, at most 8192)
+   * @param encoding `json` (default) or `binary` for a packed post body
+   */
+  router->map("fs.readdirPlus", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    int entries = 0;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(entries, "entries", std::stoi, "256");
+
+    router->core->fs.readdirPlus(
+      message.seq,
+      id,
+      entries,
+      message.get("encoding") == "binary",
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
 	/**
    * Read value of a symbolic link at 'path'
    * @param path
@@ -982,6 +1244,76 @@ static void initRouterTable (Router *router) {
     );
   });
 
+#if defined(__APPLE__)
+  /**
+   * Streams the bytes of a file descriptor as a single chunked response.
+   * Only scheme handlers with chunked responses (Apple platforms) support
+   * it, the route is not registered elsewhere and reads use `fs.read`.
+   * @param id
+   * @param offset
+   * @param end Exclusive, `-1` for the end of the file
+   * @param highWaterMark Bytes per chunk
+   * @param window Reads in flight ahead of the response
+   */
+  router->map("fs.stream", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    if (!message.isHTTP) {
+      return reply(Result::Err { message, JSON::Object::Entries {
+        {"message", "IPC method 'fs.stream' must be invoked with HTTP"}
+      }});
+    }
+
+    uint64_t id;
+    uint64_t offset;
+    int64_t end;
+    size_t highWaterMark;
+    size_t window;
+
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(offset, "offset", std::stoull, "0");
+    REQUIRE_AND_GET_MESSAGE_VALUE(end, "end", std::stoll, "-1");
+    REQUIRE_AND_GET_MESSAGE_VALUE(highWaterMark, "highWaterMark", std::stoull, "65536");
+    REQUIRE_AND_GET_MESSAGE_VALUE(window, "window", std::stoull, "0");
+
+    router->core->fs.stream(
+      message.seq,
+      id,
+      offset,
+      end,
+      highWaterMark,
+      window,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+#endif
+
+  /**
+   * Stops a walk started with `fs.walk`. The walk replies once the
+   * directories being read are done.
+   * @param id The id given to `fs.walk`
+   */
+  router->map("fs.stopWalk", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+
+    router->core->fs.stopWalk(
+      message.seq,
+      id,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
   /**
    * Stops a already started watcher
    */
@@ -1022,6 +1354,86 @@ static void initRouterTable (Router *router) {
     );
   });
 
+  /**
+   * Walks the directory tree at `path`, reading directories in parallel.
+   * Entries are emitted in batches as `fs.walk` events with the walk `id`,
+   * the reply carries the totals and the number of events once every
+   * directory has been read.
+   * @param id A unique id for the walk, used to stop it
+   * @param path The directory to walk
+   * @param include Newline separated globs entries must match
+   * @param exclude Newline separated globs of entries to skip
+   * @param depth The maximum depth to descend, `-1` for no limit
+   * @param followSymlinks Descend into symbolic links to directories
+   * @param withStats Include the `lstat(2)` (or `stat(2)`) of each entry
+   * @param batchSize The number of entries per event
+   */
+  router->map("fs.walk", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "path"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    int depth = -1;
+    size_t batchSize = 256;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(depth, "depth", std::stoi, "-1");
+    REQUIRE_AND_GET_MESSAGE_VALUE(batchSize, "batchSize", std::stoull, "256");
+
+    auto options = Core::FS::WalkOptions {};
+    options.depth = depth;
+    options.batchSize = batchSize;
+    options.followSymlinks = message.get("followSymlinks") == "true";
+    options.withStats = message.get("withStats") == "true";
+
+    for (const auto& glob : split(message.get("include"), '\n')) {
+      if (glob.size() > 0) options.include.push_back(glob);
+    }
+
+    for (const auto& glob : split(message.get("exclude"), '\n')) {
+      if (glob.size() > 0) options.exclude.push_back(glob);
+    }
+
+    struct Cancellation {
+      Core* core;
+      uint64_t id;
+      Atomic<bool> finished = false;
+    };
+
+    auto cancel = message.cancel;
+    // shared with the cancellation handler, which may run on another
+    // thread while the walk finishes
+    auto cancellation = std::shared_ptr<Cancellation>(new Cancellation { router->core, id });
+
+    // a cancelled request (the page went away) stops the walk
+    if (cancel != nullptr) {
+      cancel->state = cancellation;
+      cancel->data = cancellation.get();
+      cancel->handler = [](void* data) {
+        auto cancellation = reinterpret_cast<Cancellation*>(data);
+        if (!cancellation->finished) {
+          cancellation->core->fs.stopWalk("", cancellation->id, [](auto, auto, auto) {});
+        }
+      };
+    }
+
+    router->core->fs.walk(
+      message.seq,
+      id,
+      message.get("path"),
+      options,
+      [message, reply, cancellation](auto seq, auto json, auto post) {
+        if (seq != "-1") {
+          cancellation->finished = true;
+        }
+
+        reply(Result { seq, message, json, post });
+      }
+    );
+  });
+
   /**
    * TODO
    */
@@ -1078,6 +1490,89 @@ static void initRouterTable (Router *router) {
     );
   });
 
+  /**
+   * Writes the message buffer, split into segments of `sizes` bytes, to
+   * descriptor `id` at `offset` with a single vectored write.
+   * @param id
+   * @param sizes comma separated segment sizes, adding up to the buffer size
+   * @param offset
+   * @see pwritev(2)
+   */
+  router->map("fs.writev", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"id", "sizes", "offset"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    if (message.buffer.bytes == nullptr || message.buffer.size == 0) {
+      auto err = JSON::Object::Entries {{ "message", "Missing buffer in message" }};
+      return reply(Result::Err { message, err });
+    }
+
+    uint64_t id;
+    int64_t offset = 0;
+    Vector<size_t> sizes;
+    REQUIRE_AND_GET_MESSAGE_VALUE(id, "id", std::stoull);
+    REQUIRE_AND_GET_MESSAGE_VALUE(offset, "offset", std::stoll);
+    REQUIRE_AND_GET_MESSAGE_VALUE(sizes, "sizes", parseSegmentSizes);
+
+    size_t size = 0;
+    for (const auto segment : sizes) {
+      size += segment;
+    }
+
+    if (size != message.buffer.size) {
+      auto err = JSON::Object::Entries {{ "message", "Segment sizes do not match buffer size" }};
+      return reply(Result::Err { message, err });
+    }
+
+    router->core->fs.writev(
+      message.seq,
+      id,
+      message.buffer.bytes,
+      sizes,
+      offset,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
+  /**
+   * Writes the message buffer to the file at `path` in one round trip. The
+   * file is opened, written and closed on the event loop. An empty buffer
+   * creates or truncates the file, depending on `flags`.
+   * @param path
+   * @param flags (default: O_WRONLY | O_CREAT | O_TRUNC)
+   * @param mode (default: 0666)
+   */
+  router->map("fs.writeFile", [](auto message, auto router, auto reply) {
+    auto err = validateMessageParameters(message, {"path"});
+
+    if (err.type != JSON::Type::Null) {
+      return reply(Result::Err { message, err });
+    }
+
+    int flags = 0;
+    int mode = 0;
+    REQUIRE_AND_GET_MESSAGE_VALUE(
+      flags,
+      "flags",
+      std::stoi,
+      std::to_string(O_WRONLY | O_CREAT | O_TRUNC)
+    );
+    REQUIRE_AND_GET_MESSAGE_VALUE(mode, "mode", std::stoi, "438");
+
+    router->core->fs.writeFile(
+      message.seq,
+      message.get("path"),
+      message.buffer.bytes,
+      message.buffer.bytes != nullptr ? message.buffer.size : 0,
+      flags,
+      mode,
+      RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
+    );
+  });
+
 #if defined(__APPLE__)
   router->map("geolocation.getCurrentPosition", [](auto message, auto router, auto reply) {
     if (!router->locationObserver) {
@@ -1877,7 +2372,8 @@ static void initRouterTable (Router *router) {
   /**
    * Handles platform events.
    * @param value The event name [domcontentloaded]
-   * @param data Optional data associated with the platform event.
+   * @param data Optional data associated with the platform event, for
+   * `domcontentloaded` the milliseconds since the page started loading
    */
   router->map("platform.event", [](auto message, auto router, auto reply) {
     auto err = validateMessageParameters(message, {"value"});
@@ -1890,6 +2386,7 @@ static void initRouterTable (Router *router) {
 
     router->core->platform.event(
       message.seq,
+      message.index,
       message.value,
       message.get("data"),
       RESULT_CALLBACK_FROM_CORE_CALLBACK(message, reply)
@@ -2271,6 +2768,56 @@ static void initRouterTable (Router *router) {
   });
 }
 
+#if defined(__linux__) && !defined(__ANDROID__)
+// finishes an `ipc://` scheme request with `data`, which must be allocated
+// with `new[]`, or retained from `BufferPool` when `isPooled` is `true`, and
+// is owned (and freed) by the response stream
+static void finishSchemeRequest (
+  WebKitURISchemeRequest* request,
+  char* data,
+  size_t size,
+  const Headers& headers,
+  bool isBinary,
+  bool isPooled
+) {
+  // `data` is freed when the stream is finalized
+  auto stream = g_memory_input_stream_new_from_data(
+    data,
+    size,
+    isPooled
+      ? (GDestroyNotify) [](gpointer data) {
+          BufferPool::release(static_cast<char *>(data));
+        }
+      : (GDestroyNotify) [](gpointer data) {
+          delete [] static_cast<char *>(data);
+        }
+  );
+  auto responseHeaders = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
+  auto response = webkit_uri_scheme_response_new(stream, size);
+
+  for (const auto& header : headers.entries) {
+    soup_message_headers_append(responseHeaders, header.key.c_str(), header.value.c_str());
+  }
+
+  if (isBinary) {
+    webkit_uri_scheme_response_set_content_type(response, IPC_BINARY_CONTENT_TYPE);
+  } else {
+    webkit_uri_scheme_response_set_content_type(response, IPC_JSON_CONTENT_TYPE);
+  }
+
+  webkit_uri_scheme_request_finish_with_response(request, response);
+  g_input_stream_close_async(stream, 0, nullptr, +[](
+    GObject* object,
+    GAsyncResult* asyncResult,
+    gpointer userData
+  ) {
+    auto stream = (GInputStream*) object;
+    g_input_stream_close_finish(stream, asyncResult, nullptr);
+    g_object_unref(stream);
+  }, nullptr);
+}
+#endif
+
 static void registerSchemeHandler (Router *router) {
 #if defined(__linux__) && !defined(__ANDROID__)
   // prevent this function from registering the `ipc://`
@@ -2291,48 +2838,40 @@ static void registerSchemeHandler (Router *router) {
       auto json = result.str();
       auto size = result.post.body != nullptr ? result.post.length : json.size();
       auto body = result.post.body != nullptr ? result.post.body : json.c_str();
+      auto headers = result.headers;
+      auto isBinary = result.post.body != nullptr;
+      auto isPooled = isBinary && result.post.pooled;
 
       char* data = nullptr;
 
-      if (size > 0) {
-        data = new char[size]{0};
+      // pooled bodies are shared with the response stream instead of copied
+      if (isPooled) {
+        BufferPool::retain(result.post.body);
+        data = result.post.body;
+      } else if (size > 0) {
+        data = new char[size];
         memcpy(data, body, size);
       }
 
-      auto stream = g_memory_input_stream_new_from_data(data, size, nullptr);
-      auto headers = soup_message_headers_new(SOUP_MESSAGE_HEADERS_RESPONSE);
-      auto response = webkit_uri_scheme_response_new(stream, size);
-
-      for (const auto& header : result.headers.entries) {
-        soup_message_headers_append(headers, header.key.c_str(), header.value.c_str());
-      }
-
-      if (result.post.body) {
-        webkit_uri_scheme_response_set_content_type(response, IPC_BINARY_CONTENT_TYPE);
-      } else {
-        webkit_uri_scheme_response_set_content_type(response, IPC_JSON_CONTENT_TYPE);
-      }
+      // results may arrive on the core event loop thread (see
+      // `[linux] event_loop_thread`), so the response is finished on the
+      // GTK main thread, which is a direct call when already on it
+      auto finish = new std::function<void()>([=]() {
+        finishSchemeRequest(request, data, size, headers, isBinary, isPooled);
+      });
 
-      webkit_uri_scheme_request_finish_with_response(request, response);
-      g_input_stream_close_async(stream, 0, nullptr, +[](
-        GObject* object,
-        GAsyncResult* asyncResult,
-        gpointer userData
-      ) {
-        auto stream = (GInputStream*) object;
-        g_input_stream_close_finish(stream, asyncResult, nullptr);
-        g_object_unref(stream);
-        g_idle_add_full(
-          G_PRIORITY_DEFAULT_IDLE,
-          (GSourceFunc) [](gpointer userData) {
-            return G_SOURCE_REMOVE;
-          },
-          userData,
-           [](gpointer userData) {
-            delete [] static_cast<char *>(userData);
-          }
-        );
-      }, data);
+      g_main_context_invoke_full(
+        nullptr,
+        G_PRIORITY_HIGH_IDLE,
+        [](gpointer userData) -> gboolean {
+          (*static_cast<std::function<void()>*>(userData))();
+          return G_SOURCE_REMOVE;
+        },
+        finish,
+        [](gpointer userData) {
+          delete static_cast<std::function<void()>*>(userData);
+        }
+      );
     });
 
     if (!invoked) {
@@ -3008,7 +3547,23 @@ static void registerSchemeHandler (Router *router) {
         headers[@"content-type"] = @"application/json";
       }
       headers[@"content-length"] = @(size).stringValue;
-      data = [NSData dataWithBytes: body length: size];
+
+      // pooled bodies are shared with the response instead of copied
+      if (result.post.body != nullptr && result.post.pooled) {
+        BufferPool::retain(result.post.body);
+        data = [[NSData alloc]
+          initWithBytesNoCopy: (void*) body
+                       length: size
+                  deallocator: ^(void* bytes, NSUInteger length) {
+                    BufferPool::release(static_cast<const char*>(bytes));
+                  }
+        ];
+      #if !__has_feature(objc_arc)
+        [data autorelease];
+      #endif
+      } else {
+        data = [NSData dataWithBytes: body length: size];
+      }
     }
 
     auto response = [[NSHTTPURLResponse alloc]
@@ -3475,6 +4030,8 @@ namespace SSC::IPC {
   #if !defined(__ANDROID__) && (defined(_WIN32) || defined(__linux__) || (defined(__APPLE__) && !TARGET_OS_IPHONE && !TARGET_IPHONE_SIMULATOR))
     if (isDebugEnabled() && userConfig["webview_watch"] == "true") {
       this->fileSystemWatcher = new FileSystemWatcher(getcwd());
+      // a save that touches many files reloads once
+      this->fileSystemWatcher->options.coalesce = true;
       this->fileSystemWatcher->start([=, this](
         const auto& path,
         const auto& events,
@@ -3841,7 +4398,7 @@ namespace SSC::IPC {
     }
 
     auto& listeners = this->listeners.at(name);
-    auto token = rand64();
+    auto token = monotonic64();
     listeners.push_back(MessageCallbackListenerContext { token , callback });
     return token;
   }
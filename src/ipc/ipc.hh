@@ -139,6 +139,9 @@ namespace SSC::IPC {
   struct MessageCancellation {
     void (*handler)(void*) = nullptr;
     void *data = nullptr;
+    // owns `data` when it is shared with the request, the handler can be
+    // called from another thread while the request finishes
+    std::shared_ptr<void> state = nullptr;
   };
 
   class Message {
@@ -1,2 +1,5 @@
 // import './diagnostics/channels.js'
+import './diagnostics/descriptors.js'
+import './diagnostics/loop.js'
+import './diagnostics/metadata-cache.js'
 import './diagnostics/window.js'
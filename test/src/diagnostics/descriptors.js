@@ -0,0 +1,31 @@
+import { Buffer } from 'socket:buffer'
+import fs from 'socket:fs/promises'
+import ipc from 'socket:ipc'
+import os from 'socket:os'
+import path from 'socket:path'
+import test from 'socket:test'
+
+test('diagnostics - descriptors - ipc', async (t) => {
+  const before = await ipc.send('diagnostics.descriptors')
+  t.ifError(before.err, 'diagnostics.descriptors does not fail')
+  t.equal(typeof before.data.count, 'number', 'data.count is a number')
+  t.equal(typeof before.data.stale, 'number', 'data.stale is a number')
+  t.equal(typeof before.data.bytes, 'number', 'data.bytes is a number')
+  t.equal(typeof before.data.oldestAge, 'number', 'data.oldestAge is a number')
+  t.equal(typeof before.data.meanAge, 'number', 'data.meanAge is a number')
+
+  const filename = path.join(os.tmpdir(), 'ssc-diagnostics-descriptors.txt')
+  await fs.writeFile(filename, 'hello descriptors')
+  const handle = await fs.open(filename, 'r')
+  await handle.read(Buffer.alloc(17), 0, 17, 0)
+
+  const { data } = await ipc.send('diagnostics.descriptors')
+  t.equal(data.count, before.data.count + 1, 'open descriptors are counted')
+  t.ok(data.bytes >= before.data.bytes + 17, 'bytes read are counted')
+
+  await handle.close()
+  await fs.unlink(filename)
+
+  const after = await ipc.send('diagnostics.descriptors')
+  t.equal(after.data.count, before.data.count, 'closed descriptors are not counted')
+})
@@ -0,0 +1,29 @@
+import diagnostics from 'socket:diagnostics'
+import ipc from 'socket:ipc'
+import test from 'socket:test'
+
+test('diagnostics - loop - ipc', async (t) => {
+  const { err, data } = await ipc.send('diagnostics.loop')
+  t.ifError(err, 'diagnostics.loop does not fail')
+  t.equal(typeof data.iterations, 'number', 'data.iterations is a number')
+  t.equal(typeof data.utilization, 'number', 'data.utilization is a number')
+  t.ok(data.utilization >= 0 && data.utilization <= 1, 'data.utilization is a ratio')
+  t.equal(typeof data.queued, 'number', 'data.queued is a number')
+  t.equal(typeof data.lag, 'object', 'data.lag is an object')
+  t.equal(typeof data.dispatchLatency, 'object', 'data.dispatchLatency is an object')
+  t.equal(typeof data.mainLoopLag, 'object', 'data.mainLoopLag is an object')
+})
+
+test('diagnostics - loop - channel', async (t) => {
+  const channel = diagnostics.channel('diagnostics.loop')
+  const message = await new Promise((resolve) => {
+    channel.subscribe(function onMessage (message) {
+      channel.unsubscribe(onMessage)
+      resolve(message)
+    })
+  })
+
+  t.equal(typeof message.iterations, 'number', 'message.iterations is a number')
+  t.ok(message.iterations > 0, 'the loop has iterated since sampling started')
+  t.equal(typeof message.lag.mean, 'number', 'message.lag.mean is a number')
+})
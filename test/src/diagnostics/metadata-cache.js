@@ -0,0 +1,28 @@
+import fs from 'socket:fs/promises'
+import ipc from 'socket:ipc'
+import os from 'socket:os'
+import path from 'socket:path'
+import test from 'socket:test'
+
+test('diagnostics - metadataCache - ipc', async (t) => {
+  const { err, data } = await ipc.send('diagnostics.metadataCache')
+  t.ifError(err, 'diagnostics.metadataCache does not fail')
+  t.equal(typeof data.enabled, 'boolean', 'data.enabled is a boolean')
+
+  if (!data.enabled) {
+    return
+  }
+
+  const filename = path.join(os.tmpdir(), 'ssc-diagnostics-metadata-cache.txt')
+  await fs.writeFile(filename, 'hello')
+  await fs.stat(filename)
+  await fs.stat(filename)
+
+  const after = await ipc.send('diagnostics.metadataCache')
+  t.ok(after.data.hits > data.hits, 'repeated stats hit the cache')
+
+  await fs.writeFile(filename, 'hello world')
+  const stats = await fs.stat(filename)
+  t.equal(stats.size, 11, 'writes invalidate cached stats')
+  await fs.unlink(filename)
+})
@@ -0,0 +1,99 @@
+import { test } from 'socket:test'
+import path from 'socket:path'
+import fs from 'socket:fs'
+import os from 'socket:os'
+import process from 'socket:process'
+
+// Measures main thread frame times while the core event loop is busy with
+// file system I/O. Run once with the default configuration and once with
+// `[linux] event_loop_thread = true` to compare both Linux loop modes.
+const DURATION = 2000
+const CONCURRENCY = 32
+// the longest frame allowed under I/O load, a frame over it means the main
+// thread was blocked on the loop
+const MAX_FRAME_TIME = 250
+
+function nextFrame () {
+  return new Promise((resolve) => {
+    if (typeof globalThis.requestAnimationFrame === 'function') {
+      // headless webviews may never paint, so fall back to a timer
+      const timeout = setTimeout(() => resolve(performance.now()), 100)
+      globalThis.requestAnimationFrame((now) => {
+        clearTimeout(timeout)
+        resolve(now)
+      })
+    } else {
+      setTimeout(() => resolve(performance.now()), 16)
+    }
+  })
+}
+
+function percentile (values, p) {
+  const sorted = values.slice().sort((a, b) => a - b)
+  const index = Math.min(sorted.length - 1, Math.floor(sorted.length * p))
+  return sorted[index]
+}
+
+async function measure (duration) {
+  const frames = []
+  const end = performance.now() + duration
+  let last = await nextFrame()
+
+  while (last < end) {
+    const now = await nextFrame()
+    frames.push(now - last)
+    last = now
+  }
+
+  return frames
+}
+
+function summary (frames) {
+  return [
+    `frames=${frames.length}`,
+    `p50=${percentile(frames, 0.5).toFixed(2)}ms`,
+    `p95=${percentile(frames, 0.95).toFixed(2)}ms`,
+    `p99=${percentile(frames, 0.99).toFixed(2)}ms`,
+    `max=${Math.max(...frames).toFixed(2)}ms`
+  ].join(' ')
+}
+
+// FIXME: make this work on iOS
+if (process.platform !== 'ios') {
+  const TMPDIR = `${os.tmpdir()}${path.sep}`
+  const FIXTURES = /android/i.test(os.platform())
+    ? '/data/local/tmp/ssc-socket-test-fixtures/'
+    : `${TMPDIR}ssc-socket-test-fixtures${path.sep}`
+
+  test('fs - frame time under I/O load', async (t) => {
+    const idle = await measure(DURATION / 2)
+    t.comment(`idle: ${summary(idle)}`)
+
+    let running = true
+    let operations = 0
+    const filename = path.join(FIXTURES, 'file.txt')
+    const workers = Array.from({ length: CONCURRENCY }, async () => {
+      while (running) {
+        await fs.promises.stat(filename)
+        await fs.promises.readFile(filename)
+        operations += 2
+      }
+    })
+
+    const loaded = await measure(DURATION)
+    running = false
+    await Promise.all(workers)
+
+    t.comment(`loaded: ${summary(loaded)} ops=${operations}`)
+    t.ok(loaded.length > 0, 'frames were measured under I/O load')
+    t.ok(operations > 0, 'I/O operations completed while measuring')
+    t.ok(
+      percentile(loaded, 0.99) < MAX_FRAME_TIME,
+      `p99 frame time under I/O load is under ${MAX_FRAME_TIME}ms`
+    )
+    t.ok(
+      percentile(loaded, 0.95) <= percentile(idle, 0.95) * 2 + 16,
+      'p95 frame time under I/O load is at most twice the idle p95 plus a frame'
+    )
+  })
+}
@@ -53,18 +53,197 @@ if (process.platform !== 'ios') {
     })
   }
 
+  test('fs.promises.hash', async (t) => {
+    const filename = `${TMPDIR}ssc-socket-test-hash.txt`
+    await fs.writeFile(filename, 'abc')
+
+    const sha256 = await fs.hash(filename)
+    t.equal(sha256.digest, 'ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad', 'sha256 is the default')
+    t.equal(sha256.size, 3, 'the hashed size is returned')
+
+    const sha1 = await fs.hash(filename, { algorithm: 'sha1' })
+    t.equal(sha1.digest, 'a9993e364706816aba3e25717850c26c9cd0d89d', 'sha1 digests')
+
+    const blake3 = await fs.hash(filename, { algorithm: 'blake3' })
+    t.equal(blake3.digest, '6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85', 'blake3 digests')
+
+    const results = await fs.hash([filename, `${filename}.missing`, filename], { algorithm: 'sha1' })
+    t.equal(results.length, 3, 'a result is returned for every path')
+    t.equal(results[0].digest, sha1.digest, 'results are in the order of the paths')
+    t.ok(results[1].err, 'errors are returned for paths that fail')
+    t.equal(results[2].path, filename, 'results have their path')
+
+    try {
+      await fs.hash(filename, { algorithm: 'md5' })
+      t.fail('unknown algorithms are accepted')
+    } catch (err) {
+      t.ok(err, 'unknown algorithms are rejected')
+    }
+
+    await fs.unlink(filename)
+  })
+
   test('fs.promises.open', async (t) => {
     const fd = await fs.open(FIXTURES + 'file.txt', 'r')
     t.ok(fd instanceof FileHandle, 'FileHandle is returned')
     await fd.close()
   })
 
+  test('fs.promises.FileHandle readableWebStream', async (t) => {
+    const filename = `${TMPDIR}ssc-socket-test-readable-web-stream.bin`
+    const data = Buffer.alloc(256 * 1024 + 123)
+    for (let i = 0; i < data.length; ++i) {
+      data[i] = i % 251
+    }
+
+    await fs.writeFile(filename, data)
+
+    const read = async (options) => {
+      const fd = await fs.open(filename, 'r')
+      const chunks = []
+      const reader = fd.readableWebStream(options).getReader()
+
+      while (true) {
+        const { done, value } = await reader.read()
+        if (done) break
+        chunks.push(Buffer.from(value))
+      }
+
+      await fd.close()
+      return Buffer.concat(chunks)
+    }
+
+    const all = await read({ highWaterMark: 16 * 1024, window: 8 })
+    t.ok(Buffer.compare(all, data) === 0, 'chunks are streamed in order')
+
+    const range = await read({ start: 1000, end: 70000 })
+    t.ok(Buffer.compare(range, data.slice(1000, 70000)) === 0, 'start and end select a range')
+
+    const fd = await fs.open(filename, 'r')
+    const reader = fd.readableWebStream({ highWaterMark: 1024 }).getReader()
+    const { value } = await reader.read()
+    await reader.cancel()
+    await fd.close()
+    t.ok(value?.byteLength > 0, 'the stream can be cancelled early')
+
+    await fs.unlink(filename)
+  })
+
   test('fs.promises.opendir', async (t) => {
     const dir = await fs.opendir(FIXTURES + 'directory')
     t.ok(dir instanceof Dir, 'fs.Dir is returned')
     await dir.close()
   })
 
+  test('fs.promises.opendir readPlus', async (t) => {
+    const names = ['0', '1', '2', 'a', 'b', 'c'].map(name => `${name}.txt`)
+
+    for (const encoding of ['json', 'binary']) {
+      const dir = await fs.opendir(FIXTURES + 'directory')
+      const entries = await dir.handle.readPlus({ entries: 64, encoding })
+      await dir.close()
+
+      entries.sort((a, b) => a.name < b.name ? -1 : 1)
+      t.deepEqual(entries.map(entry => entry.name), names, `(${encoding}) entries are returned`)
+      t.ok(entries.every(entry => entry.stats?.isFile()), `(${encoding}) entries have stats`)
+
+      const stats = await fs.stat(FIXTURES + 'directory/a.txt')
+      const entry = entries.find(entry => entry.name === 'a.txt')
+      t.equal(entry.stats.size, stats.size, `(${encoding}) stats match fs.stat`)
+      t.equal(entry.stats.ino, stats.ino, `(${encoding}) inodes match fs.stat`)
+    }
+
+    const dir = await fs.opendir(FIXTURES + 'directory')
+    const dirent = await dir.read({ entries: 1, withStats: true })
+    await dir.close()
+    t.ok(dirent.stats?.isFile(), 'Dir.read() with withStats sets Dirent.stats')
+  })
+
+  test('fs.promises.walk', async (t) => {
+    const collect = async (options) => {
+      const entries = []
+      for await (const entry of fs.walk(FIXTURES, options)) {
+        entries.push(entry)
+      }
+      return entries
+    }
+
+    const names = ['0', '1', '2', 'a', 'b', 'c'].map(name => `directory/${name}.txt`)
+    const all = await collect()
+    t.ok(all.some(entry => entry.name === 'directory' && entry.isDirectory()), 'directories are yielded')
+    t.ok(names.every(name => all.some(entry => entry.name === name && entry.isFile())), 'nested files are yielded')
+
+    const included = await collect({ include: 'directory/*.txt', batchSize: 2 })
+    t.deepEqual(included.map(entry => entry.name).sort(), names, 'include globs filter entries')
+
+    const excluded = await collect({ exclude: ['directory', '*.json'] })
+    t.ok(!excluded.some(entry => entry.name.startsWith('directory') || entry.name.endsWith('.json')), 'exclude globs skip entries and directories')
+
+    const shallow = await collect({ depth: 1 })
+    t.ok(!shallow.some(entry => entry.name.includes('/')), 'depth limits descent')
+
+    const [entry] = await collect({ include: 'file.txt', withStats: true })
+    const stats = await fs.stat(FIXTURES + 'file.txt')
+    t.equal(entry?.stats?.size, stats.size, 'withStats sets Dirent.stats')
+
+    for await (const entry of fs.walk(FIXTURES, { batchSize: 1 })) {
+      t.ok(entry, 'returning early stops the walk')
+      break
+    }
+  })
+
+  test('fs.promises.mkdir, fs.promises.cp, fs.promises.rm', async (t) => {
+    const root = `${TMPDIR}ssc-socket-test-cp-${Date.now()}`
+    await fs.mkdir(`${root}/src/a/b/c`, { recursive: true })
+    await fs.mkdir(`${root}/src/a/b/c`, { recursive: true })
+    t.ok((await fs.stat(`${root}/src/a/b/c`)).isDirectory(), 'mkdir() creates missing parents')
+
+    await fs.writeFile(`${root}/src/a/file.txt`, 'hello')
+    await fs.writeFile(`${root}/src/a/b/c/file.txt`, 'world')
+
+    const progress = []
+    const copied = await fs.cp(`${root}/src`, `${root}/dest`, {
+      recursive: true,
+      onProgress: (event) => progress.push(event)
+    })
+
+    t.equal(copied.entries, 6, 'cp() copies every entry')
+    t.equal(copied.bytes, 10, 'cp() counts copied bytes')
+    t.ok(progress.length > 0, 'cp() reports progress')
+    t.equal(await fs.readFile(`${root}/dest/a/b/c/file.txt`, 'utf8'), 'world', 'cp() copies nested files')
+
+    try {
+      await fs.cp(`${root}/src`, `${root}/dest`)
+      t.fail('cp() copies a directory without recursive')
+    } catch (err) {
+      t.ok(err, 'cp() needs recursive for directories')
+    }
+
+    try {
+      await fs.cp(`${root}/src`, `${root}/src/a/copy`, { recursive: true })
+      t.fail('cp() copies a directory into itself')
+    } catch (err) {
+      t.ok(err, 'cp() refuses to copy a directory into itself')
+    }
+
+    try {
+      await fs.rm(`${root}/dest`)
+      t.fail('rm() removes a directory without recursive')
+    } catch (err) {
+      t.ok(err, 'rm() needs recursive for directories')
+    }
+
+    await fs.rm(`${root}`, { recursive: true })
+    await fs.rm(`${root}`, { recursive: true, force: true })
+
+    try {
+      await fs.access(root)
+      t.fail('rm() removes directories recursively')
+    } catch (err) {
+      t.ok(err, 'rm() removes directories recursively')
+    }
+  })
+
   test('fs.promises.readdir', async (t) => {
     const files = await fs.readdir(FIXTURES + 'directory')
     t.ok(Array.isArray(files), 'array is returned')
@@ -108,5 +287,51 @@ if (process.platform !== 'ios') {
       const contents = await fs.readFile(file)
       t.equal(contents.toString(), data, 'file contents are correct')
     })
+
+    test('fs.promises.writeFile flags', async (t) => {
+      const file = FIXTURES + 'write-file-flags.txt'
+      await fs.writeFile(file, 'a longer line\n')
+      await fs.writeFile(file, 'short\n')
+      t.equal(await fs.readFile(file, 'utf8'), 'short\n', 'writeFile() truncates by default')
+
+      try {
+        await fs.writeFile(file, 'exclusive\n', { flag: 'wx' })
+        t.fail('writeFile() with flag \'wx\' should fail for an existing file')
+      } catch (err) {
+        t.ok(err, 'writeFile() with flag \'wx\' fails for an existing file')
+      }
+
+      await fs.writeFile(file, '')
+      const empty = await fs.readFile(file)
+      t.equal(empty.length, 0, 'an empty write truncates the file')
+    })
+
+    test('fs.promises.appendFile', async (t) => {
+      const file = FIXTURES + 'append-file.txt'
+      await fs.writeFile(file, 'test 123\n')
+      await fs.appendFile(file, 'test 456\n')
+      await fs.writeFile(file, 'test 789\n', { flag: 'a' })
+      const contents = await fs.readFile(file, { encoding: 'utf8' })
+      t.equal(contents, 'test 123\ntest 456\ntest 789\n', 'appended contents are correct')
+    })
+
+    test('fs.promises.FileHandle writev/readv', async (t) => {
+      const file = FIXTURES + 'vectored.txt'
+      const segments = ['test ', Buffer.from('123'), new Uint8Array([10])]
+      const writer = await fs.open(file, 'w')
+      const written = await writer.writev(segments, 0)
+      await writer.close()
+      t.equal(written.bytesWritten, 9, 'writev() writes every segment')
+
+      const reader = await fs.open(file, 'r')
+      const buffers = [Buffer.alloc(5), Buffer.alloc(3), Buffer.alloc(4)]
+      const read = await reader.readv(buffers, 0)
+      await reader.close()
+      t.equal(read.bytesRead, 9, 'readv() reads up to the end of the file')
+      t.equal(buffers[0].toString(), 'test ', 'first segment is filled')
+      t.equal(buffers[1].toString(), '123', 'second segment is filled')
+      t.equal(buffers[2][0], 10, 'last segment is partially filled')
+      t.equal(buffers[2][1], 0, 'bytes past the end of the file are untouched')
+    })
   }
 }
@@ -131,6 +131,35 @@ namespace SSC::Tests {
       t.equals(extensions.get("my-other-extension.source"), "other-extension/", "build.extensions.my-other-extension.source = 'other-extension/'");
     });
 
+    t.test("SSC::Config::query() after mutation", [](auto t) {
+      Config config;
+      config.set("webview.watch", "true");
+      config.set("webview.watch.reload", "false");
+      config.set("window.watch", "false");
+      config.set("build.extensions.a.source", "a/");
+      config.set("build.extensions.b.source", "b/");
+
+      auto watch = config.query("[webview] .watch");
+      t.equals(watch.size(), 1, "[webview] .watch matches one key");
+      t.equals(watch.get("webview.watch"), "true", "webview.watch == true");
+
+      auto sources = config.query("[build.extensions] .source");
+      t.equals(sources.size(), 2, "[build.extensions] .source matches two keys");
+
+      auto enabled = config.query("[.extensions.a] .source = a/");
+      t.equals(enabled.get("build.extensions.a.source"), "a/", "[.extensions.a] .source = a/");
+
+      config.erase("build.extensions.b");
+      t.equals(config.slice("build.extensions").size(), 1, "erased namespace is removed from slice()");
+      t.assert(!config.contains("build.extensions.b"), "does not contain build.extensions.b");
+
+      config.set("build.extensions.c.source", "c/");
+      t.equals(config.slice("build.extensions").get("c.source"), "c/", "new keys are visible to slice()");
+
+      config.clear();
+      t.equals(config.query("[*]").size(), 0, "cleared config has no matches");
+    });
+
     t.test("SSC::Config::children()", [](auto t) {
       const auto config = Config(R"INI(
       [0]
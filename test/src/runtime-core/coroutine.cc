@@ -0,0 +1,140 @@
+#include <fcntl.h>
+#include <stdio.h>
+
+#include "tests.hh"
+
+namespace SSC::Tests {
+  static Async<int> add (int a, int b) {
+    co_return a + b;
+  }
+
+  static Async<int> sum (int count) {
+    int total = 0;
+    for (int i = 0; i < count; ++i) {
+      total += co_await add(i, 1);
+    }
+
+    co_return total;
+  }
+
+  static Async<int> fail () {
+    throw std::runtime_error("failed");
+    co_return 0;
+  }
+
+  static Async<String> readFile (uv_loop_t* loop, String path) {
+    auto fs = UVFS(loop);
+    auto opened = co_await fs.open(path, O_RDONLY, 0);
+
+    if (!opened.ok()) {
+      co_return String("error: ") + uv_strerror((int) opened.result);
+    }
+
+    const auto fd = (uv_file) opened.result;
+    auto stats = co_await fs.fstat(fd);
+    auto bytes = String(stats.stat.st_size, '\0');
+    auto read = co_await fs.read(fd, uv_buf_init(bytes.data(), (unsigned int) bytes.size()), 0);
+    co_await fs.close(fd);
+
+    co_return bytes.substr(0, read.result);
+  }
+
+  void coroutine (Harness& t) {
+    t.test("SSC::Async", [](auto t) {
+      int result = 0;
+      bool threw = false;
+
+      [](int& result) -> Async<> {
+        result = co_await sum(100);
+      }(result).start();
+
+      t.equals((int64_t) result, (int64_t) 5050, "nested co_await returns results synchronously when nothing suspends");
+
+      [](bool& threw) -> Async<> {
+        try {
+          co_await fail();
+        } catch (const std::runtime_error&) {
+          threw = true;
+        }
+      }(threw).start();
+
+      t.assert(threw, "exceptions propagate to the awaiting coroutine");
+
+      const auto before = CoroutineFramePool::stats();
+      for (int i = 0; i < 100; ++i) {
+        add(i, i).start();
+      }
+
+      const auto after = CoroutineFramePool::stats();
+      t.assert(after.reused - before.reused >= 99, "frames are recycled by the pool");
+    });
+
+    t.test("SSC::UVFS", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      const auto filename = String(P_tmpdir) + "/ssc-runtime-core-coroutine.txt";
+      auto file = fopen(filename.c_str(), "w");
+      fputs("hello coroutine", file);
+      fclose(file);
+
+      String contents = "";
+      String missing = "";
+
+      [](uv_loop_t* loop, String filename, String& contents, String& missing) -> Async<> {
+        contents = co_await readFile(loop, filename);
+        missing = co_await readFile(loop, filename + ".missing");
+      }(&loop, filename, contents, missing).start();
+
+      uv_run(&loop, UV_RUN_DEFAULT);
+      uv_loop_close(&loop);
+      remove(filename.c_str());
+
+      t.equals(contents, "hello coroutine", "open, fstat, read and close resume on the loop");
+      t.equals(missing, "error: no such file or directory", "failed requests settle with their status");
+    });
+
+    t.test("SSC::UVFS vectored", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      const auto filename = String(P_tmpdir) + "/ssc-runtime-core-coroutine-vectored.txt";
+      int64_t written = 0;
+      int64_t read = 0;
+      auto head = String(6, '\0');
+      auto tail = String(15, '\0');
+
+      [](uv_loop_t* loop, String filename, int64_t& written, int64_t& read, String& head, String& tail) -> Async<> {
+        auto fs = UVFS(loop);
+        auto opened = co_await fs.open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        const auto fd = (uv_file) opened.result;
+        auto hello = String("hello ");
+        auto vectored = String("vectored");
+
+        auto writes = Vector<uv_buf_t>();
+        writes.push_back(uv_buf_init(hello.data(), 6));
+        writes.push_back(uv_buf_init(vectored.data(), 8));
+
+        auto reads = Vector<uv_buf_t>();
+        reads.push_back(uv_buf_init(head.data(), 6));
+        reads.push_back(uv_buf_init(tail.data(), 15));
+
+        auto write = co_await fs.write(fd, writes, 0);
+        auto result = co_await fs.read(fd, reads, 0);
+
+        co_await fs.close(fd);
+        written = write.result;
+        read = result.result;
+      }(&loop, filename, written, read, head, tail).start();
+
+      uv_run(&loop, UV_RUN_DEFAULT);
+      uv_loop_close(&loop);
+      remove(filename.c_str());
+
+      t.equals(written, (int64_t) 14, "a vectored write writes every buffer");
+      t.equals(read, (int64_t) 14, "a vectored read fills buffers in order");
+      t.equals(head, "hello ", "the first buffer is filled first");
+      t.equals(tail.substr(0, 8), "vectored", "the rest lands in the next buffer");
+    });
+  }
+}
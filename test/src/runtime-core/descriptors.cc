@@ -0,0 +1,106 @@
+#include "tests.hh"
+
+namespace SSC::Tests {
+  struct TestDescriptor : DescriptorTableEntry {
+    uint64_t id = 0;
+    TestDescriptor (uint64_t id) : id(id) {}
+  };
+
+  void descriptors (Harness& t) {
+    t.test("SSC::DescriptorTable", [](auto t) {
+      DescriptorTable<TestDescriptor> table;
+      auto a = new TestDescriptor(0xa11ce);
+      auto b = new TestDescriptor(0xb0b);
+
+      t.equals(table.insert(a->id, a) == nullptr, true, "insert() returns nullptr for a new id");
+      table.insert(b->id, b);
+
+      t.equals(table.size(), (size_t) 2, "size() counts values");
+      t.equals(table.get(a->id) == a, true, "get() finds a value by id");
+      t.equals(table.resolve(b->handle) == b, true, "resolve() finds a value by handle");
+      t.equals(table.get(0xdead) == nullptr, true, "get() returns nullptr for unknown ids");
+
+      const auto handle = a->handle;
+      t.equals(table.remove(a->id) == a, true, "remove() returns the removed value");
+      t.equals(table.has(a->id), false, "removed ids are gone");
+      t.equals(table.resolve(handle) == nullptr, true, "handles of removed values don't resolve");
+
+      auto c = new TestDescriptor(0xc);
+      table.insert(c->id, c);
+      t.equals(c->handle & 0xffffffff, handle & 0xffffffff, "free slots are reused");
+      t.equals(table.resolve(handle) == nullptr, true, "a reused slot has a new generation");
+      t.equals(table.metrics().capacity, (size_t) 2, "reusing slots doesn't grow the table");
+
+      auto replacement = new TestDescriptor(b->id);
+      t.equals(table.insert(b->id, replacement) == b, true, "insert() returns the replaced value");
+      t.equals(table.get(b->id) == replacement, true, "insert() replaces the value of an id");
+
+      size_t visited = 0;
+      table.forEach([&visited](auto, auto) { visited++; });
+      t.equals(visited, (size_t) 2, "forEach() visits every value");
+
+      delete a;
+      delete b;
+      table.forEach([](auto, auto value) { delete value; });
+    });
+
+    t.test("SSC::DescriptorTable stale list", [](auto t) {
+      DescriptorTable<TestDescriptor> table;
+      Vector<TestDescriptor*> values;
+
+      for (uint64_t id = 1; id <= 1024; ++id) {
+        values.push_back(new TestDescriptor(id * 7919));
+        table.insert(values.back()->id, values.back());
+      }
+
+      t.equals(table.takeStale().size(), (size_t) 0, "nothing is collected until values are marked stale");
+
+      for (size_t i = 0; i < values.size(); i += 4) {
+        table.markStale(values[i]);
+      }
+
+      table.markStale(values[0]);
+      t.equals(table.getStaleCount(), (size_t) 256, "values are listed once");
+
+      // removing a listed value unlinks it
+      table.remove(values[4]->id);
+      t.equals(table.getStaleCount(), (size_t) 255, "removed values leave the stale list");
+
+      const auto handles = table.takeStale();
+      auto resolved = true;
+      for (const auto handle : handles) {
+        const auto value = table.resolve(handle);
+        resolved = resolved && value != nullptr && (value->id / 7919 - 1) % 4 == 0;
+      }
+
+      t.equals(handles.size(), (size_t) 255, "takeStale() returns every listed value");
+      t.assert(resolved, "takeStale() returns only listed values");
+      t.equals(table.getStaleCount(), (size_t) 0, "takeStale() empties the list");
+
+      for (auto value : values) {
+        delete value;
+      }
+    });
+
+    t.test("SSC::DescriptorTable metrics", [](auto t) {
+      DescriptorTable<TestDescriptor> table;
+      auto a = TestDescriptor(1);
+      auto b = TestDescriptor(2);
+
+      table.insert(a.id, &a);
+      table.insert(b.id, &b);
+      table.markStale(&b);
+      a.bytes += 100;
+      b.bytes += 28;
+
+      const auto metrics = table.metrics();
+      t.equals(metrics.count, (size_t) 2, "metrics count values");
+      t.equals(metrics.stale, (size_t) 1, "metrics count stale values");
+      t.equals(metrics.bytes, (uint64_t) 128, "metrics sum bytes of open descriptors");
+      t.assert(metrics.oldestAge >= metrics.meanAge, "the oldest is at least the mean age");
+
+      table.remove(a.id);
+      t.equals(table.metrics().bytes, (uint64_t) 28, "removed descriptors are not counted");
+    });
+  }
+}
@@ -0,0 +1,172 @@
+#include "tests.hh"
+
+namespace SSC::Tests {
+#if defined(__linux__) && !defined(__ANDROID__)
+  static int readLimit (const String& path) {
+    auto file = fopen(path.c_str(), "rb");
+    auto limit = 0;
+
+    if (file != nullptr) {
+      fscanf(file, "%d", &limit);
+      fclose(file);
+    }
+
+    return limit;
+  }
+
+  static void writeFile (const String& path, const String& contents) {
+    auto file = fopen(path.c_str(), "wb");
+    fwrite(contents.data(), 1, contents.size(), file);
+    fclose(file);
+  }
+
+  // runs the loop until the watcher has seen pending events and scanned
+  // the directories it found
+  static void drain (uv_loop_t* loop, FileSystemWatcher* watcher) {
+    for (int i = 0; i < 10 || watcher->inotify->pending.size() > 0; ++i) {
+      uv_run(loop, UV_RUN_NOWAIT);
+
+      if (watcher->inotify->pending.size() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      }
+    }
+  }
+#endif
+
+  void fileSystemWatcher (Harness& t) {
+  #if defined(__linux__) && !defined(__ANDROID__)
+    t.test("SSC::FileSystemWatcher recursive inotify watches", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      const auto directory = String(P_tmpdir) + "/ssc-runtime-core-file-system-watcher";
+      const auto queued = readLimit("/proc/sys/fs/inotify/max_queued_events");
+      const auto available = readLimit("/proc/sys/fs/inotify/max_user_watches") - 2048;
+      const auto parents = 50;
+      // 50 thousand directories, unless there are fewer watches to use
+      const auto children = std::min(1000, available / parents - 1);
+      const auto count = parents * (children + 1);
+
+      if (count < 50000) {
+        t.comment("using " + std::to_string(count) + " directories (fs.inotify.max_user_watches)");
+      }
+
+      std::filesystem::remove_all(directory);
+
+      for (int i = 0; i < parents; ++i) {
+        for (int j = 0; j < children; ++j) {
+          std::filesystem::create_directories(directory + "/" + std::to_string(i) + "/" + std::to_string(j));
+        }
+      }
+
+      auto paths = std::set<String>();
+      auto watcher = new FileSystemWatcher(directory);
+      const auto debounce = std::chrono::milliseconds(watcher->options.debounce);
+      watcher->loop = &loop;
+      watcher->start([&paths](auto path, auto, auto) {
+        paths.insert(path);
+      });
+
+      t.assert(watcher->inotify != nullptr, "directories are watched with inotify");
+      t.equals(watcher->inotify->watches.size(), (size_t) 0, "the tree is scanned on the loop, not in start()");
+
+      drain(&loop, watcher);
+      t.equals(watcher->inotify->watches.size(), (size_t) (count + 1), "every directory in the tree is watched");
+      t.equals(watcher->inotify->descriptors.size(), (size_t) (count + 1), "every watch is mapped to its path");
+
+      const auto deep = directory + "/" + std::to_string(parents - 1) + "/" + std::to_string(children - 1) + "/file.txt";
+      writeFile(deep, "hello");
+      drain(&loop, watcher);
+      t.assert(paths.contains(deep), "changes deep in the tree are reported");
+
+      // debounced by path, not by watched directory
+      const auto first = directory + "/0/0/file.txt";
+      const auto second = directory + "/1/0/file.txt";
+      writeFile(first, "hello");
+      writeFile(second, "hello");
+      drain(&loop, watcher);
+      t.assert(paths.contains(first) && paths.contains(second), "changes to other paths are reported within the debounce");
+
+      // the file is written before the new directories are watched
+      const auto created = directory + "/created/a/b";
+      std::filesystem::create_directories(created);
+      writeFile(created + "/file.txt", "hello");
+      drain(&loop, watcher);
+      t.assert(paths.contains(directory + "/created"), "new directories are reported");
+      t.assert(paths.contains(created + "/file.txt"), "entries of new directories are reported");
+      t.assert(watcher->inotify->descriptors.contains(created), "new directories are watched");
+
+      paths.clear();
+      std::this_thread::sleep_for(debounce);
+      writeFile(created + "/file.txt", "hello world");
+      drain(&loop, watcher);
+      t.assert(paths.contains(created + "/file.txt"), "changes in new directories are reported");
+
+      std::filesystem::rename(directory + "/created", directory + "/renamed");
+      drain(&loop, watcher);
+      t.assert(!watcher->inotify->descriptors.contains(created), "directories moved away are not watched at their old path");
+      t.assert(watcher->inotify->descriptors.contains(directory + "/renamed/a/b"), "directories moved in are watched at their new path");
+
+      std::filesystem::remove_all(directory + "/0");
+      std::filesystem::remove_all(directory + "/renamed");
+      drain(&loop, watcher);
+      t.equals(watcher->inotify->watches.size(), (size_t) (count - children), "watches of removed directories are dropped");
+      t.equals(watcher->inotify->descriptors.size(), (size_t) (count - children), "paths of removed directories are dropped");
+
+      // more events than the queue holds, with a directory created in
+      // the middle of them that is only found by the rescan
+      paths.clear();
+      for (int i = 0; i < queued + 1024; ++i) {
+        writeFile(directory + "/1/" + std::to_string(i % children) + "/" + std::to_string(i), "");
+
+        if (i == queued / 2) {
+          std::filesystem::create_directories(directory + "/overflow");
+        }
+      }
+
+      drain(&loop, watcher);
+      t.assert(paths.contains(directory), "an overflow reports the watched directory");
+      t.assert(watcher->inotify->descriptors.contains(directory + "/overflow"), "directories created during an overflow are watched");
+      t.equals(watcher->inotify->watches.size(), (size_t) (count - children + 1), "a rescan keeps one watch for each directory");
+
+      watcher->stop();
+      uv_run(&loop, UV_RUN_DEFAULT);
+      delete watcher;
+
+      uv_loop_close(&loop);
+      std::filesystem::remove_all(directory);
+    });
+
+    t.test("SSC::FileSystemWatcher coalesced reports", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      const auto directory = String(P_tmpdir) + "/ssc-runtime-core-file-system-watcher-coalesce";
+      std::filesystem::remove_all(directory);
+      std::filesystem::create_directories(directory + "/a");
+      std::filesystem::create_directories(directory + "/b");
+
+      auto reports = 0;
+      auto watcher = new FileSystemWatcher(directory);
+      watcher->loop = &loop;
+      watcher->options.coalesce = true;
+      watcher->start([&reports](auto, auto, auto) {
+        reports++;
+      });
+
+      drain(&loop, watcher);
+      writeFile(directory + "/a/file.txt", "hello");
+      writeFile(directory + "/b/file.txt", "hello");
+      drain(&loop, watcher);
+      t.equals(reports, 1, "changes to many paths within the debounce are reported once");
+
+      watcher->stop();
+      uv_run(&loop, UV_RUN_DEFAULT);
+      delete watcher;
+
+      uv_loop_close(&loop);
+      std::filesystem::remove_all(directory);
+    });
+  #endif
+  }
+}
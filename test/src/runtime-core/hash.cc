@@ -0,0 +1,47 @@
+#include "tests.hh"
+
+namespace SSC::Tests {
+  static String hexdigest (Hasher::Algorithm algorithm, const String& input, size_t chunkSize) {
+    auto hasher = Hasher(algorithm);
+
+    for (size_t offset = 0; offset < input.size(); offset += chunkSize) {
+      hasher.update(input.substr(offset, chunkSize));
+    }
+
+    return hasher.hexdigest();
+  }
+
+  void hash (Harness& t) {
+    t.test("SSC::Hasher", [](auto t) {
+      auto algorithm = Hasher::Algorithm::SHA1;
+      const auto million = String(1000000, 'a');
+      auto pattern = String();
+
+      // the input of the BLAKE3 test vectors, a chunk tree 6 chunks wide
+      for (int i = 0; i < 5121; ++i) {
+        pattern += (char) (i % 251);
+      }
+
+      t.assert(Hasher::parse("SHA-256", algorithm) && algorithm == Hasher::Algorithm::SHA256, "parse() accepts 'SHA-256'");
+      t.assert(Hasher::parse("blake3", algorithm) && algorithm == Hasher::Algorithm::BLAKE3, "parse() accepts 'blake3'");
+      t.assert(!Hasher::parse("md5", algorithm), "parse() rejects unknown algorithms");
+
+      t.equals(hexdigest(Hasher::Algorithm::SHA256, "", 1), String("e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"), "SHA-256 of nothing");
+      t.equals(hexdigest(Hasher::Algorithm::SHA256, "abc", 1), String("ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"), "SHA-256 of 'abc'");
+      t.equals(hexdigest(Hasher::Algorithm::SHA1, "", 1), String("da39a3ee5e6b4b0d3255bfef95601890afd80709"), "SHA-1 of nothing");
+      t.equals(hexdigest(Hasher::Algorithm::SHA1, "abc", 1), String("a9993e364706816aba3e25717850c26c9cd0d89d"), "SHA-1 of 'abc'");
+      t.equals(hexdigest(Hasher::Algorithm::BLAKE3, "", 1), String("af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262"), "BLAKE3 of nothing");
+      t.equals(hexdigest(Hasher::Algorithm::BLAKE3, "abc", 1), String("6437b3ac38465133ffb63b75273a8db548c558465d79db03fd359c6cd5bd9d85"), "BLAKE3 of 'abc'");
+
+      for (const auto chunkSize : { (size_t) 1, (size_t) 63, (size_t) 4096, million.size() }) {
+        const auto size = std::to_string(chunkSize);
+        t.equals(hexdigest(Hasher::Algorithm::SHA256, million, chunkSize), String("cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"), "SHA-256 of a million 'a' in updates of " + size);
+        t.equals(hexdigest(Hasher::Algorithm::SHA1, million, chunkSize), String("34aa973cd4c4daa4f61eeb2bdbad27316534016f"), "SHA-1 of a million 'a' in updates of " + size);
+        t.equals(hexdigest(Hasher::Algorithm::BLAKE3, million, chunkSize), String("616f575a1b58d4c9797d4217b9730ae5e6eb319d76edef6549b46f4efe31ff8b"), "BLAKE3 of a million 'a' in updates of " + size);
+      }
+
+      t.equals(hexdigest(Hasher::Algorithm::BLAKE3, pattern, 1000), String("628bd2cb2004694adaab7bbd778a25df25c47b9d4155a55f8fbd79f2fe154cff"), "BLAKE3 of a partial chunk after full ones");
+      t.equals(hexdigest(Hasher::Algorithm::SHA256, pattern, 1000), String("f19db61046ca889db9bd34d779cd362c6a7198cb5a0e3a2882e7bd24a901cc1d"), "SHA-256 of an unaligned size");
+    });
+  }
+}
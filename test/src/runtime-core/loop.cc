@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <chrono>
+
+#include "tests.hh"
+
+namespace SSC::Tests {
+  static Vector<double> measure (Core* core, int samples) {
+    Vector<double> latencies;
+
+    for (int i = 0; i < samples; ++i) {
+      // let the loop go idle before each dispatch
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+      Atomic<bool> done = false;
+      std::chrono::steady_clock::time_point executed;
+      const auto dispatched = std::chrono::steady_clock::now();
+
+      core->dispatchEventLoop([&]() {
+        executed = std::chrono::steady_clock::now();
+        done = true;
+      });
+
+      while (!done) {
+        std::this_thread::yield();
+      }
+
+      const auto elapsed = executed - dispatched;
+      latencies.push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / 1e6
+      );
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+  }
+
+  static String summary (const Vector<double>& latencies) {
+    const auto median = latencies[latencies.size() / 2];
+    const auto max = latencies.back();
+    return "p50=" + std::to_string(median) + "ms max=" + std::to_string(max) + "ms";
+  }
+
+  void loop (Harness& t) {
+    t.test("Core event loop dispatch latency after idle", [](auto t) {
+      static constexpr int SAMPLES = 20;
+
+      // the loop runs with `pollEventLoop()` on every platform, on Linux
+      // instead of from the GTK main loop
+      auto options = Core::Options {};
+      options.eventLoopThread = true;
+
+      // not deleted, on Apple the loop runs in a dispatch queue block that
+      // may outlive `stopEventLoop()`
+      auto core = new Core(options);
+      core->runEventLoop();
+      t.assert(core->isLoopRunning, "runEventLoop() starts the loop");
+
+      const auto latencies = measure(core, SAMPLES);
+      t.comment("blocking uv_run(): " + summary(latencies));
+
+      t.assert(
+        latencies[latencies.size() / 2] < 16.0,
+        "an idle loop services a dispatch without waiting for a poll interval"
+      );
+
+      Atomic<int> calls = 0;
+      for (int i = 0; i < 1000; ++i) {
+        core->dispatchEventLoop([&calls]() { calls++; });
+      }
+
+      const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+      while (calls < 1000 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+
+      t.equals((int64_t) calls, (int64_t) 1000, "a burst of dispatches is drained");
+
+      core->stopEventLoop();
+      t.assert(!core->isLoopRunning, "stopEventLoop() stops the loop");
+    });
+  }
+}
@@ -6,13 +6,25 @@ static bool initialize (sapi_context_t* context, const void *data) {
   return harness.run("runtime-core-tests", [](auto t) {
     t.run(SSC::Tests::codec);
     t.run(SSC::Tests::config);
+    t.run(SSC::Tests::coroutine);
+    t.run(SSC::Tests::descriptors);
     t.run(SSC::Tests::env);
+    t.run(SSC::Tests::fileSystemWatcher);
+    t.run(SSC::Tests::hash);
     t.run(SSC::Tests::ini);
     t.run(SSC::Tests::json);
+    t.run(SSC::Tests::loop);
+    t.run(SSC::Tests::metadataCache);
     t.run(SSC::Tests::platform);
+    t.run(SSC::Tests::pool);
     t.run(SSC::Tests::preload);
+    t.run(SSC::Tests::queue);
+    t.run(SSC::Tests::random);
     t.run(SSC::Tests::string);
+    t.run(SSC::Tests::timers);
+    t.run(SSC::Tests::uring);
     t.run(SSC::Tests::version);
+    t.run(SSC::Tests::workers);
   });
 }
 
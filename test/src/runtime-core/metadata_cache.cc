@@ -0,0 +1,118 @@
+#include "tests.hh"
+
+namespace SSC::Tests {
+  static MetadataCache::Entry statEntry (const String& path) {
+    uv_fs_t req;
+    auto entry = MetadataCache::Entry {};
+    entry.result = uv_fs_stat(nullptr, &req, path.c_str(), nullptr);
+    entry.stat = req.statbuf;
+    uv_fs_req_cleanup(&req);
+    return entry;
+  }
+
+  static void writeFile (const String& path, const String& contents) {
+    auto file = fopen(path.c_str(), "wb");
+    fwrite(contents.data(), 1, contents.size(), file);
+    fclose(file);
+  }
+
+  // runs the loop until the watchers have seen pending events
+  static void drain (uv_loop_t* loop) {
+    for (int i = 0; i < 10; ++i) {
+      uv_run(loop, UV_RUN_NOWAIT);
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+  }
+
+  void metadataCache (Harness& t) {
+    t.test("SSC::MetadataCache", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      const auto directory = String(P_tmpdir) + "/ssc-runtime-core-metadata-cache";
+      const auto filename = directory + "/file.txt";
+      const auto missing = directory + "/missing.txt";
+      std::filesystem::create_directories(directory);
+      writeFile(filename, "hello");
+
+      {
+        MetadataCache cache(&loop, MetadataCache::Options {});
+        auto entry = MetadataCache::Entry {};
+        auto ticket = MetadataCache::UNCACHEABLE;
+
+        t.assert(!cache.get(MetadataCache::Kind::Stat, filename, 0, entry, ticket), "a lookup misses an empty cache");
+        t.assert(ticket != MetadataCache::UNCACHEABLE, "a miss in a watchable directory can be stored");
+        cache.put(MetadataCache::Kind::Stat, filename, 0, statEntry(filename), ticket);
+
+        t.assert(cache.get(MetadataCache::Kind::Stat, filename, 0, entry, ticket), "a stored result is found");
+        t.equals((int64_t) entry.stat.st_size, (int64_t) 5, "the stored stat is returned");
+        t.assert(cache.get(MetadataCache::Kind::Stat, directory + "/./file.txt", 0, entry, ticket), "paths are normalized");
+        t.assert(!cache.get(MetadataCache::Kind::LStat, filename, 0, entry, ticket), "kinds are cached separately");
+
+        cache.get(MetadataCache::Kind::Stat, missing, 0, entry, ticket);
+        cache.put(MetadataCache::Kind::Stat, missing, 0, statEntry(missing), ticket);
+        t.assert(cache.get(MetadataCache::Kind::Stat, missing, 0, entry, ticket), "not found results are cached");
+        t.equals((int64_t) entry.result, (int64_t) UV_ENOENT, "the cached error is returned");
+
+        writeFile(missing, "created");
+        drain(&loop);
+
+        t.assert(!cache.get(MetadataCache::Kind::Stat, missing, 0, entry, ticket), "a change in the directory drops the negative entry");
+        t.assert(!cache.get(MetadataCache::Kind::Stat, filename, 0, entry, ticket), "a change in the directory drops its entries");
+
+        // a result racing a change is not stored
+        cache.get(MetadataCache::Kind::Stat, filename, 0, entry, ticket);
+        const auto stale = statEntry(filename);
+        writeFile(filename, "hello world");
+        drain(&loop);
+        cache.put(MetadataCache::Kind::Stat, filename, 0, stale, ticket);
+        t.assert(!cache.get(MetadataCache::Kind::Stat, filename, 0, entry, ticket), "results of lookups before a change are discarded");
+
+        cache.put(MetadataCache::Kind::Stat, filename, 0, statEntry(filename), ticket);
+        cache.invalidate(filename);
+        t.assert(!cache.get(MetadataCache::Kind::Stat, filename, 0, entry, ticket), "invalidate() drops entries");
+
+        const auto stats = cache.stats();
+        t.equals(stats.hits, (uint64_t) 3, "hits are counted");
+        t.assert(stats.misses >= 6, "misses are counted");
+        t.assert(stats.invalidations > 0, "invalidations are counted");
+        t.equals(stats.watched, (size_t) 1, "the directory is watched again after a change");
+      }
+
+      drain(&loop);
+      uv_loop_close(&loop);
+      std::filesystem::remove_all(directory);
+    });
+
+    t.test("SSC::MetadataCache bounds", [](auto t) {
+      auto options = MetadataCache::Options {};
+      options.capacity = MetadataCache::SHARDS * 4;
+      options.ttl = 20;
+      options.watch = false;
+
+      MetadataCache cache(nullptr, options);
+      auto entry = MetadataCache::Entry {};
+      auto ticket = MetadataCache::UNCACHEABLE;
+
+      for (int i = 0; i < 1024; ++i) {
+        const auto path = "/ssc-metadata-cache/" + std::to_string(i);
+        cache.get(MetadataCache::Kind::Access, path, 0, entry, ticket);
+        cache.put(MetadataCache::Kind::Access, path, 0, MetadataCache::Entry { UV_ENOENT }, ticket);
+      }
+
+      auto stats = cache.stats();
+      t.assert(stats.size <= options.capacity, "entries are bounded by capacity");
+      t.equals(stats.evictions, (uint64_t) (1024 - stats.size), "least recently used entries are evicted");
+
+      cache.get(MetadataCache::Kind::Access, "/ssc-metadata-cache/x", 0, entry, ticket);
+      cache.put(MetadataCache::Kind::Access, "/ssc-metadata-cache/x", 0, MetadataCache::Entry { UV_EACCES }, ticket);
+      t.assert(!cache.get(MetadataCache::Kind::Access, "/ssc-metadata-cache/x", 0, entry, ticket), "transient errors are not cached");
+
+      cache.put(MetadataCache::Kind::Access, "/ssc-metadata-cache/x", 0, MetadataCache::Entry { 0 }, ticket);
+      t.assert(cache.get(MetadataCache::Kind::Access, "/ssc-metadata-cache/x", 0, entry, ticket), "entries are used until they expire");
+      std::this_thread::sleep_for(std::chrono::milliseconds(30));
+      t.assert(!cache.get(MetadataCache::Kind::Access, "/ssc-metadata-cache/x", 0, entry, ticket), "expired entries are dropped");
+      t.equals(cache.stats().expirations, (uint64_t) 1, "expirations are counted");
+    });
+  }
+}
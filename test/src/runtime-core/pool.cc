@@ -0,0 +1,138 @@
+#include <chrono>
+
+#include "tests.hh"
+
+namespace SSC::Tests {
+  struct PooledObject {
+    using Pool = ThreadLocalPool<PooledObject, 4>;
+    char bytes[512];
+
+    static void* operator new (size_t size) {
+      return Pool::allocate(size);
+    }
+
+    static void operator delete (void* pointer, size_t size) {
+      Pool::release(pointer, size);
+    }
+  };
+
+  struct LargerPooledObject : PooledObject {
+    char more[512];
+  };
+
+  void pool (Harness& t) {
+    t.test("SSC::ThreadLocalPool", [](auto t) {
+      const auto before = PooledObject::Pool::stats();
+
+      for (int i = 0; i < 100; ++i) {
+        delete new PooledObject();
+      }
+
+      auto stats = PooledObject::Pool::stats();
+      t.equals((int64_t) (stats.allocated - before.allocated), (int64_t) 1, "freed blocks are reused");
+      t.equals((int64_t) (stats.reused - before.reused), (int64_t) 99, "reuse is counted");
+      t.equals((int64_t) (stats.released - before.released), (int64_t) 100, "releases are counted");
+
+      Vector<PooledObject*> objects;
+      for (int i = 0; i < 8; ++i) {
+        objects.push_back(new PooledObject());
+      }
+
+      for (auto object : objects) {
+        delete object;
+      }
+
+      stats = PooledObject::Pool::stats();
+      t.equals((int64_t) stats.pooled, (int64_t) 4, "a thread keeps at most MAX_FREE_BLOCKS spare blocks");
+
+      const auto released = stats.released;
+      delete new LargerPooledObject();
+      t.equals((int64_t) PooledObject::Pool::stats().released, (int64_t) released, "larger derived types bypass the pool");
+    });
+
+    t.test("SSC::Core::FS::RequestContext pooling", [](auto t) {
+      const auto before = Core::FS::RequestContext::Pool::stats();
+
+      for (int i = 0; i < 1000; ++i) {
+        auto ctx = new Core::FS::RequestContext("", nullptr);
+        // the destructor cleans up `req`, which a real operation initializes
+        memset(&ctx->req, 0, sizeof(ctx->req));
+        delete ctx;
+      }
+
+      const auto after = Core::FS::RequestContext::Pool::stats();
+      t.assert(after.allocated - before.allocated <= 1, "contexts are recycled instead of reallocated");
+      t.assert(sizeof(Core::FS::RequestContext) < 1024, "contexts no longer embed dirent storage");
+    });
+
+    t.test("SSC::BufferPool", [](auto t) {
+      const auto before = BufferPool::stats();
+      auto bytes = BufferPool::allocate(5000);
+
+      t.equals(BufferPool::capacity(bytes), (size_t) 8192, "sizes round up to a class");
+      memset(bytes, 0xff, 5000);
+      BufferPool::release(bytes);
+
+      auto again = BufferPool::allocate(6000);
+      t.assert(again == bytes, "a released buffer is reused by the same class");
+      t.assert((unsigned char) again[0] == 0xff, "reused buffers are not zero filled");
+
+      BufferPool::retain(again);
+      BufferPool::release(again);
+      t.equals(
+        (int64_t) (BufferPool::stats().released - before.released),
+        (int64_t) 1,
+        "a retained buffer is not recycled until its last release"
+      );
+
+      BufferPool::release(again);
+      t.equals(
+        (int64_t) (BufferPool::stats().released - before.released),
+        (int64_t) 2,
+        "the last release recycles the buffer"
+      );
+
+      const auto large = BufferPool::MAX_CLASS_SIZE + 1;
+      auto unpooled = BufferPool::allocate(large);
+      t.equals(BufferPool::capacity(unpooled), (size_t) large, "buffers over MAX_CLASS_SIZE are exact");
+      const auto pooled = BufferPool::stats().pooled;
+      BufferPool::release(unpooled);
+      t.equals((int64_t) BufferPool::stats().pooled, (int64_t) pooled, "buffers over MAX_CLASS_SIZE are not pooled");
+      t.assert(BufferPool::stats().pooled <= BufferPool::MAX_POOLED_BYTES, "pooled bytes are bounded");
+    });
+
+    t.test("SSC::BufferPool read buffer benchmark", [](auto t) {
+      static constexpr size_t SIZE = 1024 * 1024;
+      static constexpr int ITERATIONS = 256;
+
+      auto measure = [](auto allocate, auto release) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < ITERATIONS; ++i) {
+          auto bytes = allocate();
+          // what a short read touches
+          bytes[0] = (char) i;
+          release(bytes);
+        }
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / ITERATIONS;
+      };
+
+      const auto zeroed = measure(
+        []() { return new char[SIZE]{0}; },
+        [](char* bytes) { delete [] bytes; }
+      );
+
+      const auto pooled = measure(
+        []() { return BufferPool::allocate(SIZE); },
+        [](char* bytes) { BufferPool::release(bytes); }
+      );
+
+      t.comment(
+        "1MB read buffer: new char[]{0}=" + std::to_string(zeroed) + "ns" +
+        " BufferPool=" + std::to_string(pooled) + "ns"
+      );
+
+      t.assert(true, "benchmark completed");
+    });
+  }
+}
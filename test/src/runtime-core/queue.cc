@@ -0,0 +1,295 @@
+#include <chrono>
+
+#include "tests.hh"
+
+namespace SSC::Tests {
+  // the previous `Core::dispatchEventLoop()` implementation, kept here as a
+  // baseline for the contention benchmark
+  class LockedDispatchQueue {
+    public:
+      Mutex mutex;
+      Queue<std::function<void()>> queue;
+
+      void push (std::function<void()> callback) {
+        Lock lock(this->mutex);
+        this->queue.push(callback);
+      }
+
+      size_t drain () {
+        size_t count = 0;
+        while (true) {
+          Lock lock(this->mutex);
+          if (this->queue.size() == 0) break;
+          auto callback = this->queue.front();
+          if (callback != nullptr) callback();
+          this->queue.pop();
+          count++;
+        }
+        return count;
+      }
+  };
+
+  template <typename DispatchQueue>
+  static double benchmark (unsigned int producers, size_t iterations) {
+    DispatchQueue queue;
+    Vector<Thread> workers;
+    size_t consumed = 0;
+    uint64_t sum = 0;
+    const auto total = producers * iterations;
+    const auto start = std::chrono::steady_clock::now();
+
+    Thread consumer([&]() {
+      while (consumed < total) {
+        const auto count = queue.drain();
+        if (count == 0) std::this_thread::yield();
+        consumed += count;
+      }
+    });
+
+    for (unsigned int i = 0; i < producers; ++i) {
+      workers.emplace_back([&, i]() {
+        const String label = "producer-" + std::to_string(i);
+        for (size_t j = 0; j < iterations; ++j) {
+          queue.push([&sum, label, j]() {
+            sum += label.size() + j;
+          });
+        }
+      });
+    }
+
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    consumer.join();
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return (double) ns / (double) total;
+  }
+
+  void queue (Harness& t) {
+    t.test("SSC::Task", [](auto t) {
+      int calls = 0;
+      Task empty;
+      Task inlined = [&calls]() { calls++; };
+
+      t.assert(!empty, "default Task is empty");
+      t.assert((bool) inlined, "Task from lambda is not empty");
+
+      inlined();
+      empty();
+      t.equals((int64_t) calls, (int64_t) 1, "Task invokes its callable");
+
+      Array<char, Task::INLINE_SIZE * 2> large = {0};
+      large[0] = 1;
+      Task heap = [&calls, large]() { calls += large[0]; };
+      Task moved = std::move(heap);
+      t.assert(!heap, "moved from Task is empty");
+      moved();
+      t.equals((int64_t) calls, (int64_t) 2, "Task invokes a heap allocated callable");
+
+      std::function<void()> function = nullptr;
+      t.assert(!Task(function), "Task from an empty std::function is empty");
+
+      auto counter = std::make_shared<int>(0);
+      {
+        Task owner = [counter]() {};
+        t.equals((int64_t) counter.use_count(), (int64_t) 2, "Task holds a copy of its captures");
+      }
+      t.equals((int64_t) counter.use_count(), (int64_t) 1, "Task releases its captures");
+    });
+
+    t.test("SSC::MPSCQueue", [](auto t) {
+      MPSCQueue<int, 4> queue;
+      int value = 0;
+
+      t.assert(queue.empty(), "queue is initially empty");
+      t.assert(!queue.pop(value), "pop() fails on an empty queue");
+
+      for (int i = 0; i < 4; ++i) {
+        t.assert(queue.push(std::move(i)), "push() succeeds while not full");
+      }
+
+      int extra = 4;
+      t.assert(!queue.push(std::move(extra)), "push() fails when full");
+
+      bool ordered = true;
+      for (int i = 0; i < 4; ++i) {
+        ordered = queue.pop(value) && value == i && ordered;
+      }
+
+      t.assert(ordered, "pop() is first in, first out");
+      t.assert(queue.empty(), "queue is empty after popping everything");
+    });
+
+    t.test("SSC::DispatchQueue ordering", [](auto t) {
+      static constexpr int PRODUCERS = 4;
+      static constexpr int COUNT = DispatchQueue::CAPACITY * 4;
+      DispatchQueue queue;
+      Vector<Vector<int>> results(PRODUCERS);
+      Vector<Thread> workers;
+      Atomic<int> finished = 0;
+
+      for (int i = 0; i < PRODUCERS; ++i) {
+        workers.emplace_back([i, &queue, &results, &finished]() {
+          for (int j = 0; j < COUNT; ++j) {
+            queue.push([i, j, &results]() {
+              results[i].push_back(j);
+            });
+          }
+          finished++;
+        });
+      }
+
+      while (finished < PRODUCERS || !queue.empty()) {
+        queue.drain();
+      }
+
+      for (auto& worker : workers) {
+        worker.join();
+      }
+
+      queue.drain();
+
+      bool ordered = true;
+      size_t total = 0;
+      for (const auto& result : results) {
+        for (size_t j = 0; j < result.size(); ++j) {
+          if (result[j] != (int) j) ordered = false;
+        }
+        total += result.size();
+      }
+
+      t.equals(total, (size_t) (PRODUCERS * COUNT), "every task ran once");
+      t.assert(ordered, "tasks from one producer run in order, including overflow");
+    });
+
+    t.test("SSC::DispatchQueue reentrancy", [](auto t) {
+      DispatchQueue queue;
+      Vector<int> order;
+
+      queue.push([&]() {
+        order.push_back(1);
+        queue.push([&]() { order.push_back(3); });
+      });
+
+      queue.push([&]() { order.push_back(2); });
+
+      const auto count = queue.drain();
+      t.equals(count, (size_t) 3, "tasks dispatched while draining run in the same drain");
+      t.equals(order.size(), (size_t) 3, "all tasks ran");
+      t.assert(order[0] == 1 && order[1] == 2 && order[2] == 3, "tasks ran in order");
+      t.assert(queue.empty(), "queue is empty after drain()");
+    });
+
+    t.test("SSC::DispatchQueue contention", [](auto t) {
+      static constexpr size_t ITERATIONS = 200000;
+      const auto cores = std::max(2u, std::thread::hardware_concurrency());
+
+      for (unsigned int producers = 1; producers <= cores; producers *= 2) {
+        const auto locked = benchmark<LockedDispatchQueue>(producers, ITERATIONS);
+        const auto lockFree = benchmark<DispatchQueue>(producers, ITERATIONS);
+
+        t.comment(
+          "producers=" + std::to_string(producers) +
+          " locked=" + std::to_string(locked) + "ns/op" +
+          " lock-free=" + std::to_string(lockFree) + "ns/op"
+        );
+      }
+
+      t.assert(true, "benchmark completed");
+    });
+
+    t.test("SSC::DispatchQueue budget", [](auto t) {
+      DispatchQueue queue;
+      int calls = 0;
+
+      for (int i = 0; i < 8; ++i) {
+        queue.push([&calls]() {
+          std::this_thread::sleep_for(std::chrono::milliseconds(2));
+          calls++;
+        });
+      }
+
+      const auto first = queue.drain(std::chrono::milliseconds(3));
+      t.assert(first >= 1 && first < 8, "drain() stops once the budget has elapsed");
+      t.assert(!queue.empty(), "tasks over budget stay queued");
+      t.equals(queue.size(), (size_t) (8 - first), "size() counts tasks over budget");
+
+      const auto zero = queue.drain(std::chrono::milliseconds(0));
+      t.equals(zero, (size_t) 1, "drain() runs at least one task");
+
+      while (!queue.empty()) {
+        queue.drain(std::chrono::milliseconds(3));
+      }
+
+      t.equals((int64_t) calls, (int64_t) 8, "every task ran once");
+      t.equals(queue.size(), (size_t) 0, "size() is 0 after draining");
+    });
+
+    t.test("SSC::DispatchQueue budget with overflow", [](auto t) {
+      static constexpr int COUNT = DispatchQueue::CAPACITY * 3;
+      DispatchQueue queue;
+      Vector<int> order;
+
+      for (int i = 0; i < COUNT; ++i) {
+        queue.push([i, &order]() { order.push_back(i); });
+      }
+
+      // a tiny budget splits the overflow across many drains
+      while (!queue.empty()) {
+        queue.drain(std::chrono::microseconds(1), 16);
+      }
+
+      bool ordered = true;
+      for (size_t i = 0; i < order.size(); ++i) {
+        if (order[i] != (int) i) ordered = false;
+      }
+
+      t.equals(order.size(), (size_t) COUNT, "every overflowed task ran");
+      t.assert(ordered, "overflowed tasks run in order across budgeted drains");
+    });
+
+    t.test("SSC::DispatchQueue budgeted drains from many producers", [](auto t) {
+      static constexpr int COUNT = 20000;
+      const auto producers = (int) std::clamp(std::thread::hardware_concurrency(), 2u, 8u);
+      DispatchQueue queue;
+      Vector<Vector<int>> results(producers);
+      Vector<Thread> workers;
+      Atomic<int> finished = 0;
+
+      for (int i = 0; i < producers; ++i) {
+        workers.emplace_back([i, &queue, &results, &finished]() {
+          for (int j = 0; j < COUNT; ++j) {
+            queue.push([i, j, &results]() {
+              results[i].push_back(j);
+            });
+          }
+          finished++;
+        });
+      }
+
+      // drained with the budget of `App::dispatch()` on Linux
+      while (finished < producers || !queue.empty()) {
+        queue.drain(std::chrono::milliseconds(4));
+      }
+
+      for (auto& worker : workers) {
+        worker.join();
+      }
+
+      bool ordered = true;
+      size_t total = 0;
+      for (const auto& result : results) {
+        for (size_t j = 0; j < result.size(); ++j) {
+          if (result[j] != (int) j) ordered = false;
+        }
+        total += result.size();
+      }
+
+      t.equals(total, (size_t) (producers * COUNT), "every task ran once");
+      t.assert(ordered, "tasks from one producer run in order across budgeted drains");
+    });
+  }
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <chrono>
+
+#include "tests.hh"
+
+namespace SSC::Tests {
+  template <typename Generator>
+  static double benchmark (unsigned int threads, size_t iterations, Generator generate) {
+    Vector<Thread> workers;
+    Atomic<uint64_t> sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0; i < threads; ++i) {
+      workers.emplace_back([&]() {
+        uint64_t value = 0;
+        for (size_t j = 0; j < iterations; ++j) {
+          value ^= generate();
+        }
+        sink ^= value;
+      });
+    }
+
+    for (auto& worker : workers) {
+      worker.join();
+    }
+
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    return (double) ns / (double) (threads * iterations);
+  }
+
+  void random (Harness& t) {
+    t.test("SSC::rand64()", [](auto t) {
+      Vector<uint64_t> values;
+
+      for (int i = 0; i < 4096; ++i) {
+        values.push_back(SSC::rand64());
+      }
+
+      std::sort(values.begin(), values.end());
+      const auto unique = std::unique(values.begin(), values.end());
+
+      t.equals(
+        (size_t) std::distance(values.begin(), unique),
+        values.size(),
+        "rand64() does not repeat values"
+      );
+
+      uint64_t bits = 0;
+      for (const auto value : values) {
+        bits |= value;
+      }
+
+      t.assert((bits >> 32) != 0, "rand64() fills the upper 32 bits");
+    });
+
+    t.test("SSC::rand64() across threads", [](auto t) {
+      static constexpr int THREADS = 8;
+      static constexpr int COUNT = 1024;
+      Vector<uint64_t> values(THREADS * COUNT);
+      Vector<Thread> workers;
+
+      for (int i = 0; i < THREADS; ++i) {
+        workers.emplace_back([i, &values]() {
+          for (int j = 0; j < COUNT; ++j) {
+            values[i * COUNT + j] = SSC::rand64();
+          }
+        });
+      }
+
+      for (auto& worker : workers) {
+        worker.join();
+      }
+
+      std::sort(values.begin(), values.end());
+      const auto unique = std::unique(values.begin(), values.end());
+
+      t.equals(
+        (size_t) std::distance(values.begin(), unique),
+        values.size(),
+        "threads are seeded independently"
+      );
+    });
+
+    t.test("SSC::monotonic64()", [](auto t) {
+      static constexpr int THREADS = 8;
+      static constexpr int COUNT = 4096;
+      Vector<Vector<uint64_t>> results(THREADS);
+      Vector<Thread> workers;
+
+      for (int i = 0; i < THREADS; ++i) {
+        workers.emplace_back([i, &results]() {
+          for (int j = 0; j < COUNT; ++j) {
+            results[i].push_back(SSC::monotonic64());
+          }
+        });
+      }
+
+      for (auto& worker : workers) {
+        worker.join();
+      }
+
+      bool increasing = true;
+      Vector<uint64_t> values;
+
+      for (const auto& result : results) {
+        for (size_t i = 1; i < result.size(); ++i) {
+          if (result[i] <= result[i - 1]) {
+            increasing = false;
+          }
+        }
+
+        values.insert(values.end(), result.begin(), result.end());
+      }
+
+      std::sort(values.begin(), values.end());
+      const auto unique = std::unique(values.begin(), values.end());
+
+      t.assert(increasing, "monotonic64() is increasing per thread");
+      t.assert(values.front() != 0, "monotonic64() never returns 0");
+      t.equals(
+        (size_t) std::distance(values.begin(), unique),
+        values.size(),
+        "monotonic64() is unique across threads"
+      );
+    });
+
+    t.test("SSC::rand64() and SSC::monotonic64() contention", [](auto t) {
+      static constexpr size_t ITERATIONS = 1000000;
+      const auto cores = std::max(2u, std::thread::hardware_concurrency());
+
+      for (unsigned int threads = 1; threads <= cores; threads *= 2) {
+        const auto random = benchmark(threads, ITERATIONS, SSC::rand64);
+        const auto monotonic = benchmark(threads, ITERATIONS, SSC::monotonic64);
+
+        t.comment(
+          "threads=" + std::to_string(threads) +
+          " rand64=" + std::to_string(random) + "ns/op" +
+          " monotonic64=" + std::to_string(monotonic) + "ns/op"
+        );
+      }
+
+      t.assert(true, "benchmark completed");
+    });
+  }
+}
@@ -50,5 +50,22 @@ namespace SSC::Tests {
     t.test("SSC::parseStringList()", [](auto t) {
       t.comment("TODO");
     });
+
+    t.test("SSC::matchGlob()", [](auto t) {
+      t.assert(matchGlob("*.js", "index.js"), "* matches within a segment");
+      t.assert(!matchGlob("*.js", "src/index.js"), "* does not match across segments");
+      t.assert(matchGlob("**/*.js", "src/fs/index.js"), "** matches across segments");
+      t.assert(matchGlob("**/*.js", "index.js"), "**/ matches no segments");
+      t.assert(matchGlob("src/**/test", "src/test"), "/**/ matches no segments");
+      t.assert(matchGlob("src/**", "src/a/b/c"), "trailing ** matches everything below");
+      t.assert(matchGlob("file?.txt", "file1.txt"), "? matches one character");
+      t.assert(!matchGlob("a?b", "a/b"), "? does not match a separator");
+      t.assert(matchGlob("[a-c]x", "bx"), "[a-c] matches a range");
+      t.assert(!matchGlob("[!a-c]x", "bx"), "[!a-c] negates a range");
+      t.assert(matchGlob("*.{js,ts}", "index.ts"), "{js,ts} matches an alternative");
+      t.assert(!matchGlob("*.{js,ts}", "index.md"), "{js,ts} matches only its alternatives");
+      t.assert(matchGlob("\\*.js", "*.js"), "\\ escapes the next character");
+      t.assert(!matchGlob("node_modules", "node_modules/a"), "patterns match whole paths");
+    });
   }
 }
@@ -71,13 +71,25 @@ namespace SSC::Tests {
   // tests
   void codec (Harness&);
   void config (Harness&);
+  void coroutine (Harness&);
+  void descriptors (Harness&);
   void env (Harness&);
+  void fileSystemWatcher (Harness&);
+  void hash (Harness&);
   void ini (Harness&);
   void json (Harness&);
+  void loop (Harness&);
+  void metadataCache (Harness&);
   void platform (Harness&);
+  void pool (Harness&);
   void preload (Harness&);
+  void queue (Harness&);
+  void random (Harness&);
   void string (Harness&);
+  void timers (Harness&);
+  void uring (Harness&);
   void version (Harness&);
+  void workers (Harness&);
 }
 
 #endif
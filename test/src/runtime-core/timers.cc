@@ -0,0 +1,122 @@
+#include <chrono>
+
+#include "tests.hh"
+
+namespace SSC::Tests {
+  static Vector<TimingWheel::ID> fire (TimingWheel& wheel, uint64_t target) {
+    Vector<TimingWheel::Expired> expired;
+    Vector<TimingWheel::ID> ids;
+
+    wheel.advance(target, expired);
+
+    for (const auto& timer : expired) {
+      auto callback = wheel.take(timer.id);
+      if (callback != nullptr) {
+        callback();
+        ids.push_back(timer.id);
+      }
+    }
+
+    return ids;
+  }
+
+  void timers (Harness& t) {
+    t.test("SSC::TimingWheel", [](auto t) {
+      TimingWheel wheel;
+      int calls = 0;
+
+      wheel.schedule(1, 10, 0, [&calls]() { calls++; });
+      wheel.schedule(2, 10, 0, [&calls]() { calls++; });
+      wheel.schedule(3, 20, 0, [&calls]() { calls++; });
+
+      t.equals(wheel.size(), (size_t) 3, "schedule() adds timers");
+      t.equals((int64_t) wheel.next(), (int64_t) 10, "next() is the earliest deadline");
+
+      t.equals(fire(wheel, 9).size(), (size_t) 0, "nothing expires before its deadline");
+      t.equals(fire(wheel, 10).size(), (size_t) 2, "timers due in the same tick fire together");
+      t.equals((int64_t) calls, (int64_t) 2, "callbacks are returned by take()");
+
+      t.assert(wheel.cancel(3), "cancel() removes a pending timer");
+      t.assert(!wheel.cancel(3), "cancel() is false for unknown timers");
+      t.equals(fire(wheel, 64).size(), (size_t) 0, "cancelled timers do not fire");
+      t.assert(wheel.empty(), "wheel is empty once everything fired");
+      t.equals((int64_t) wheel.next(), (int64_t) 0, "next() is 0 when empty");
+    });
+
+    t.test("SSC::TimingWheel cascades far deadlines", [](auto t) {
+      TimingWheel wheel(100);
+      Vector<uint64_t> deadlines = { 101, 163, 164, 5000, 300000, 20000000 };
+      bool ok = true;
+
+      for (const auto deadline : deadlines) {
+        wheel.schedule(deadline, deadline, 0, nullptr);
+      }
+
+      for (const auto deadline : deadlines) {
+        Vector<TimingWheel::Expired> expired;
+        wheel.advance(deadline - 1, expired);
+        ok = ok && expired.size() == 0;
+        wheel.advance(deadline, expired);
+        ok = ok && expired.size() == 1 && expired[0].id == deadline;
+        wheel.take(deadline);
+      }
+
+      t.assert(ok, "every level cascades timers to fire on their exact tick");
+      t.assert(wheel.empty(), "every timer fired");
+    });
+
+    t.test("SSC::TimingWheel intervals", [](auto t) {
+      TimingWheel wheel;
+      int calls = 0;
+
+      wheel.schedule(1, 5, 5, [&calls]() { calls++; });
+      fire(wheel, 100);
+
+      t.equals((int64_t) calls, (int64_t) 20, "intervals repeat until cancelled");
+      t.assert(wheel.has(1), "intervals stay scheduled after firing");
+
+      wheel.cancel(1);
+      fire(wheel, 200);
+      t.equals((int64_t) calls, (int64_t) 20, "cancelled intervals stop");
+    });
+
+    t.test("SSC::TimingWheel cancel during expiry", [](auto t) {
+      TimingWheel wheel;
+      int calls = 0;
+
+      wheel.schedule(1, 10, 0, [&]() { wheel.cancel(2); });
+      wheel.schedule(2, 10, 0, [&calls]() { calls++; });
+
+      Vector<TimingWheel::Expired> expired;
+      wheel.advance(10, expired);
+
+      // fire in a deterministic order regardless of slot order
+      wheel.take(1)();
+      auto callback = wheel.take(2);
+
+      t.assert(callback == nullptr, "a timer cancelled by an earlier callback is not returned");
+      t.equals((int64_t) calls, (int64_t) 0, "the cancelled callback never runs");
+    });
+
+    t.test("SSC::TimingWheel schedule and cancel cost", [](auto t) {
+      static constexpr int COUNT = 1000000;
+      TimingWheel wheel;
+
+      const auto start = std::chrono::steady_clock::now();
+
+      for (int i = 1; i <= COUNT; ++i) {
+        wheel.schedule(i, (uint64_t) i * 7919 % 1000000, 0, nullptr);
+      }
+
+      for (int i = 1; i <= COUNT; ++i) {
+        wheel.cancel(i);
+      }
+
+      const auto elapsed = std::chrono::steady_clock::now() - start;
+      const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+
+      t.comment("1M schedule + cancel: " + std::to_string(ms) + "ms");
+      t.assert(wheel.empty(), "every timer was cancelled");
+    });
+  }
+}
@@ -0,0 +1,231 @@
+#include "tests.hh"
+
+namespace SSC::Tests {
+#if SSC_IO_URING
+  struct UringFixture {
+    String filename;
+    int64_t written = 0;
+    int64_t read = 0;
+    int64_t size = 0;
+    int64_t synced = -1;
+    int64_t closed = -1;
+    bool isFile = false;
+    bool isMissing = false;
+    String contents = String(11, '\0');
+  };
+
+  static Async<> roundTrip (UVFS fs, UringFixture* fixture) {
+    auto opened = co_await fs.open(fixture->filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    const auto fd = (uv_file) opened.result;
+    auto hello = String("hello uring");
+
+    auto write = co_await fs.write(fd, uv_buf_init(hello.data(), 11), 0);
+    auto synced = co_await fs.fsync(fd);
+    auto stats = co_await fs.fstat(fd);
+    auto read = co_await fs.read(fd, uv_buf_init(fixture->contents.data(), 11), 0);
+    auto closed = co_await fs.close(fd);
+    auto stat = co_await fs.stat(fixture->filename);
+    auto missing = co_await fs.lstat(fixture->filename + ".missing");
+
+    fixture->written = write.result;
+    fixture->synced = synced.result;
+    fixture->size = stats.ok() ? (int64_t) stats.stat.st_size : -1;
+    fixture->read = read.result;
+    fixture->closed = closed.result;
+    fixture->isFile = stat.ok() && S_ISREG(stat.stat.st_mode);
+    fixture->isMissing = missing.result == UV_ENOENT;
+  }
+
+  struct UringBenchmark {
+    size_t remaining = 0;
+    Vector<uint64_t> latencies;
+  };
+
+  // one of `concurrency` workers issuing 4KB reads until `remaining` runs out
+  static Async<> readWorker (UVFS fs, uv_file fd, UringBenchmark* benchmark) {
+    static constexpr size_t BLOCK_SIZE = 4096;
+    auto bytes = BufferPool::allocate(BLOCK_SIZE);
+
+    while (benchmark->remaining > 0) {
+      const auto block = --benchmark->remaining % 256;
+      const auto start = uv_hrtime();
+      auto result = co_await fs.read(fd, uv_buf_init(bytes, BLOCK_SIZE), block * BLOCK_SIZE);
+
+      if (result.ok()) {
+        benchmark->latencies.push_back(uv_hrtime() - start);
+      }
+    }
+
+    BufferPool::release(bytes);
+  }
+
+  static String runBenchmark (const String& label, bool useIOUring, const String& filename) {
+    static constexpr size_t OPERATIONS = 16384;
+    static constexpr size_t CONCURRENCY = 64;
+
+    uv_loop_t loop;
+    uv_loop_init(&loop);
+
+    IOUring uring(&loop);
+    auto fs = UVFS(&loop);
+
+    if (useIOUring && uring.init()) {
+      fs = UVFS(&loop, &uring);
+    }
+
+    auto fd = ::open(filename.c_str(), O_RDONLY);
+    auto benchmark = UringBenchmark { OPERATIONS };
+    benchmark.latencies.reserve(OPERATIONS);
+
+    const auto start = uv_hrtime();
+    for (size_t i = 0; i < CONCURRENCY; ++i) {
+      readWorker(fs, fd, &benchmark).start();
+    }
+
+    uv_run(&loop, UV_RUN_DEFAULT);
+    const auto elapsed = uv_hrtime() - start;
+    const auto enters = uring.stats().enters;
+
+    ::close(fd);
+    uring.stop();
+    uv_run(&loop, UV_RUN_DEFAULT);
+    uv_loop_close(&loop);
+
+    auto& latencies = benchmark.latencies;
+    std::sort(latencies.begin(), latencies.end());
+
+    uint64_t total = 0;
+    for (const auto latency : latencies) {
+      total += latency;
+    }
+
+    const auto count = std::max(latencies.size(), (size_t) 1);
+    const auto p99 = latencies.empty() ? 0 : latencies[count * 99 / 100];
+
+    return label + ": " +
+      std::to_string((uint64_t) (latencies.size() * 1e9 / std::max(elapsed, (uint64_t) 1))) + " reads/s, " +
+      "mean " + std::to_string(total / count / 1000) + "us, " +
+      "p99 " + std::to_string(p99 / 1000) + "us" +
+      (useIOUring ? ", " + std::to_string(enters) + " submissions" : "");
+  }
+#endif
+
+  void uring (Harness& t) {
+  #if SSC_IO_URING
+    t.test("SSC::IOUring", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      IOUring uring(&loop);
+
+      if (!uring.init()) {
+        t.comment("io_uring is not available, skipping");
+        uv_loop_close(&loop);
+        return;
+      }
+
+      auto fixture = UringFixture { String(P_tmpdir) + "/ssc-runtime-core-uring.txt" };
+      roundTrip(UVFS(&loop, &uring), &fixture).start();
+      uv_run(&loop, UV_RUN_DEFAULT);
+
+      const auto stats = uring.stats();
+      uring.stop();
+      uv_run(&loop, UV_RUN_DEFAULT);
+      uv_loop_close(&loop);
+      remove(fixture.filename.c_str());
+
+      t.equals(fixture.written, (int64_t) 11, "write() writes through the ring");
+      t.equals(fixture.synced, (int64_t) 0, "fsync() succeeds");
+      t.equals(fixture.size, (int64_t) 11, "fstat() fills the stat buffer");
+      t.equals(fixture.read, (int64_t) 11, "read() reads through the ring");
+      t.equals(fixture.contents, "hello uring", "read() fills the buffer");
+      t.equals(fixture.closed, (int64_t) 0, "close() succeeds");
+      t.assert(fixture.isFile, "stat() reports a regular file");
+      t.assert(fixture.isMissing, "errors are reported as libuv errors");
+      t.equals((size_t) stats.completed, (size_t) 8, "every operation completes on the ring");
+      t.equals((size_t) stats.refused, (size_t) 0, "no operation falls back to libuv");
+    });
+
+    t.test("SSC::IOUring batching", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      IOUring uring(&loop);
+
+      if (!uring.init()) {
+        t.comment("io_uring is not available, skipping");
+        uv_loop_close(&loop);
+        return;
+      }
+
+      auto fixtures = Vector<UringFixture>(32);
+      for (size_t i = 0; i < fixtures.size(); ++i) {
+        fixtures[i].filename = String(P_tmpdir) + "/ssc-runtime-core-uring-" + std::to_string(i) + ".txt";
+        roundTrip(UVFS(&loop, &uring), &fixtures[i]).start();
+      }
+
+      t.equals(uring.getPendingCount(), fixtures.size(), "operations are queued until the loop runs");
+      uv_run(&loop, UV_RUN_DEFAULT);
+
+      const auto stats = uring.stats();
+      uring.stop();
+      uv_run(&loop, UV_RUN_DEFAULT);
+      uv_loop_close(&loop);
+
+      auto succeeded = true;
+      for (const auto& fixture : fixtures) {
+        succeeded = succeeded && fixture.read == 11 && fixture.contents == "hello uring";
+        remove(fixture.filename.c_str());
+      }
+
+      t.assert(succeeded, "concurrent operations complete");
+      t.equals((size_t) stats.submitted, fixtures.size() * 8, "every operation is submitted");
+      t.assert(stats.enters * 4 <= stats.submitted, "operations queued in one iteration share a submission");
+    });
+
+    t.test("SSC::IOUring fallback", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      // a ring that was never set up refuses everything
+      IOUring uring(&loop);
+      auto fixture = UringFixture { String(P_tmpdir) + "/ssc-runtime-core-uring-fallback.txt" };
+      roundTrip(UVFS(&loop, &uring), &fixture).start();
+      uv_run(&loop, UV_RUN_DEFAULT);
+      uv_loop_close(&loop);
+      remove(fixture.filename.c_str());
+
+      t.equals(fixture.read, (int64_t) 11, "operations fall back to libuv");
+      t.equals(fixture.contents, "hello uring", "libuv reads the file");
+      t.equals((size_t) uring.stats().refused, (size_t) 8, "the ring refused every operation");
+    });
+
+    t.test("SSC::IOUring::release", [](auto t) {
+      uv_loop_t loop;
+      uv_loop_init(&loop);
+
+      if (IOUring::get(&loop) == nullptr) {
+        t.comment("io_uring is not available, skipping");
+        IOUring::release(&loop);
+        uv_loop_close(&loop);
+        return;
+      }
+
+      IOUring::release(&loop);
+      t.equals(uv_loop_close(&loop), 0, "the ring's handles are closed with it");
+    });
+
+    t.test("SSC::IOUring benchmark", [](auto t) {
+      const auto filename = String(P_tmpdir) + "/ssc-runtime-core-uring-benchmark.bin";
+      const auto block = String(4096 * 256, 'x');
+      auto file = fopen(filename.c_str(), "wb");
+      fwrite(block.data(), 1, block.size(), file);
+      fclose(file);
+
+      t.comment(runBenchmark("libuv thread pool", false, filename));
+      t.comment(runBenchmark("io_uring", true, filename));
+      remove(filename.c_str());
+    });
+  #endif
+  }
+}
@@ -0,0 +1,114 @@
+#include <chrono>
+
+#include "tests.hh"
+
+namespace SSC::Tests {
+  static bool waitFor (std::function<bool()> predicate) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (!predicate()) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+  }
+
+  void workers (Harness& t) {
+    t.test("SSC::Core::Workers", [](auto t) {
+      static constexpr int COUNT = 10000;
+      Core::Workers workers(nullptr);
+      Atomic<int> calls = 0;
+
+      workers.start(4);
+      t.equals(workers.size(), (size_t) 4, "start() creates the requested threads");
+      t.assert(workers.isRunning(), "pool is running after start()");
+
+      for (int i = 0; i < COUNT; ++i) {
+        workers.dispatch([&calls]() { calls++; });
+      }
+
+      t.assert(waitFor([&]() { return calls == COUNT; }), "every task ran");
+
+      auto stats = workers.stats();
+      t.equals((int64_t) stats.submitted, (int64_t) COUNT, "stats.submitted counts dispatched tasks");
+      t.assert(waitFor([&]() { return workers.stats().completed == COUNT; }), "stats.completed counts finished tasks");
+
+      workers.stop();
+      t.assert(!workers.isRunning(), "pool is stopped after stop()");
+      t.equals(workers.size(), (size_t) 0, "stop() joins every thread");
+    });
+
+    t.test("SSC::Core::Workers work stealing", [](auto t) {
+      static constexpr int COUNT = 256;
+      Core::Workers workers(nullptr);
+      Atomic<int> calls = 0;
+
+      workers.start(4);
+
+      // fan out from a single worker so the other threads must steal
+      workers.dispatch([&]() {
+        for (int i = 0; i < COUNT; ++i) {
+          workers.dispatch([&calls]() {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            calls++;
+          });
+        }
+      });
+
+      t.assert(waitFor([&]() { return calls == COUNT; }), "every nested task ran");
+      t.assert(workers.stats().stolen > 0, "idle threads steal queued work");
+
+      workers.stop();
+    });
+
+    t.test("SSC::Core::Workers drains on stop()", [](auto t) {
+      Core::Workers workers(nullptr);
+      Atomic<int> calls = 0;
+
+      workers.start(1);
+
+      for (int i = 0; i < 100; ++i) {
+        workers.dispatch([&calls]() { calls++; });
+      }
+
+      workers.stop();
+      t.equals((int64_t) calls, (int64_t) 100, "pending tasks run before stop() returns");
+    });
+
+    t.test("SSC::Core::Workers restarts while dispatching", [](auto t) {
+      static constexpr int THREADS = 4;
+      static constexpr int COUNT = 2000;
+      Core::Workers workers(nullptr);
+      Atomic<int> calls = 0;
+      Vector<Thread> threads;
+
+      workers.start(2);
+
+      // dispatches racing stop() and start() are run by the next pool
+      for (int i = 0; i < THREADS; ++i) {
+        threads.emplace_back([&]() {
+          for (int j = 0; j < COUNT; ++j) {
+            workers.dispatch([&calls]() { calls++; });
+          }
+        });
+      }
+
+      for (int i = 0; i < 20; ++i) {
+        workers.stop();
+        workers.start(2);
+      }
+
+      for (auto& thread : threads) {
+        thread.join();
+      }
+
+      t.assert(waitFor([&]() { return calls == THREADS * COUNT; }), "no task is lost across restarts");
+      t.equals(workers.stats().queued, (size_t) 0, "stats.queued is empty once drained");
+
+      workers.stop();
+    });
+  }
+}